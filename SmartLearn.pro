@@ -1,4 +1,4 @@
-QT       += core gui network
+QT       += core gui network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -9,20 +9,80 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    adaptivequiz.cpp \
+    alsmodel.cpp \
+    answercache.cpp \
+    capture.cpp \
+    cfrecommender.cpp \
+    chathistory.cpp \
+    chathistorymodel.cpp \
+    chatpage.cpp \
+    completiontrie.cpp \
     connectmanager.cpp \
+    datafiles.cpp \
+    embeddingindex.cpp \
+    goalmatcher.cpp \
+    itembank.cpp \
+    jsonframereader.cpp \
+    knowledgecanon.cpp \
     knowledgedialog.cpp \
+    knowledgetaxonomy.cpp \
+    logger.cpp \
     logindialog.cpp \
     main.cpp \
     mainwindow.cpp \
-    registerdialog.cpp
+    messages.cpp \
+    metrics.cpp \
+    minhash.cpp \
+    pathgraphview.cpp \
+    pathlayout.cpp \
+    quizdialog.cpp \
+    registerdialog.cpp \
+    resourceindex.cpp \
+    reviewscheduler.cpp \
+    simdkernels.cpp \
+    spellindex.cpp \
+    stallwatchdog.cpp \
+    tracer.cpp
 
 HEADERS += \
+    adaptivequiz.h \
+    alsmodel.h \
+    answercache.h \
+    capture.h \
+    cfrecommender.h \
+    chathistory.h \
+    chathistorymodel.h \
+    chatpage.h \
+    completiontrie.h \
     config.h \
     connectmanager.h \
+    datafiles.h \
+    embeddingindex.h \
+    goalmatcher.h \
+    itembank.h \
+    jsonframereader.h \
+    knowledgecanon.h \
     knowledgedialog.h \
+    knowledgetaxonomy.h \
+    logger.h \
     logindialog.h \
     mainwindow.h \
-    registerdialog.h
+    messages.h \
+    metrics.h \
+    minhash.h \
+    parallelfor.h \
+    pathgraphview.h \
+    pathlayout.h \
+    quizdialog.h \
+    registerdialog.h \
+    resourceindex.h \
+    reviewscheduler.h \
+    simdkernels.h \
+    spellindex.h \
+    stallwatchdog.h \
+    synonymtable.h \
+    tracer.h
 
 FORMS += \
     knowledgedialog.ui \
@@ -37,3 +97,8 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 RESOURCES += \
     res.qrc
+
+# 运行时数据文件（资源目录等）复制到构建目录
+datafiles.files = $$files(data/*)
+datafiles.path = $$OUT_PWD/data
+COPIES += datafiles
@@ -0,0 +1,153 @@
+#include "adaptivequiz.h"
+#include "simdkernels.h"
+
+#include <QtMath>
+
+#include <climits>
+
+namespace {
+
+const int GridSize = 81;
+const double GridMin = -4.0;
+const double GridStep = 0.1;
+const double TargetStandardError = 0.3;   // 每个知识点都考过且标准误低于此值时提前结束
+
+inline double gridTheta(int i)
+{
+    return GridMin + GridStep * i;
+}
+
+}
+
+AdaptiveQuiz::AdaptiveQuiz(const ItemBank &bank, const QStringList &knowledgePoints, int maxQuestions)
+    : _bank(&bank)
+    , _weight(size_t(bank.itemCount()), 0.0f)
+    , _posterior(GridSize)
+    , _maxQuestions(maxQuestions)
+    , _asked(0)
+    , _theta(0.0)
+    , _standardError(1.0)
+{
+    for (const QString &name : knowledgePoints) {
+        const int point = bank.findPoint(name);
+        if (point < 0) {
+            _untestable.append(name);
+            continue;
+        }
+        if (_points.contains(point)) continue;
+        _points.append(point);
+        _pointAsked.append(0);
+        _pointCorrect.append(0);
+        _pointRemaining.append(bank.pointEnd(point) - bank.pointBegin(point));
+        std::fill(_weight.begin() + bank.pointBegin(point), _weight.begin() + bank.pointEnd(point), 1.0f);
+    }
+
+    for (int i = 0; i < GridSize; ++i) {
+        const double t = gridTheta(i);
+        _posterior[size_t(i)] = qExp(-0.5 * t * t);
+    }
+    updateEstimate();
+}
+
+bool AdaptiveQuiz::finished() const
+{
+    if (_asked >= _maxQuestions) return true;
+
+    bool anyRemaining = false;
+    bool allTested = true;
+    for (int k = 0; k < _points.size(); ++k) {
+        if (_pointRemaining[k] > 0) anyRemaining = true;
+        if (_pointAsked[k] == 0 && _pointRemaining[k] > 0) allTested = false;
+    }
+    return !anyRemaining || (allTested && _standardError < TargetStandardError);
+}
+
+int AdaptiveQuiz::nextItem()
+{
+    if (finished()) {
+        return -1;
+    }
+
+    // 内容均衡：只在考查次数最少（且还有题）的知识点中选题
+    int fewest = INT_MAX;
+    for (int k = 0; k < _points.size(); ++k) {
+        if (_pointRemaining[k] > 0) fewest = qMin(fewest, _pointAsked[k]);
+    }
+
+    const float theta = float(_theta);
+    int bestItem = -1;
+    float bestInfo = -1.0f;
+    for (int k = 0; k < _points.size(); ++k) {
+        if (_pointRemaining[k] == 0 || _pointAsked[k] != fewest) continue;
+        const int begin = _bank->pointBegin(_points[k]);
+        float info = 0.0f;
+        const int item = SimdKernels::argmaxInformation3pl(_bank->discrimination() + begin, _bank->difficulty() + begin,
+                                                           _bank->guessing() + begin, _weight.data() + begin, theta,
+                                                           _bank->pointEnd(_points[k]) - begin, &info);
+        if (item >= 0 && info > bestInfo) {
+            bestInfo = info;
+            bestItem = begin + item;
+        }
+    }
+    return bestItem;
+}
+
+void AdaptiveQuiz::answer(int item, bool correct)
+{
+    if (item < 0 || item >= int(_weight.size()) || _weight[size_t(item)] == 0.0f) {
+        return;
+    }
+    _weight[size_t(item)] = 0.0f;
+    _asked++;
+
+    for (int k = 0; k < _points.size(); ++k) {
+        const int point = _points[k];
+        if (item >= _bank->pointBegin(point) && item < _bank->pointEnd(point)) {
+            _pointAsked[k]++;
+            _pointRemaining[k]--;
+            if (correct) _pointCorrect[k]++;
+            break;
+        }
+    }
+
+    const double a = _bank->discrimination()[item];
+    const double b = _bank->difficulty()[item];
+    const double c = _bank->guessing()[item];
+    for (int i = 0; i < GridSize; ++i) {
+        const double p = c + (1.0 - c) / (1.0 + qExp(-a * (gridTheta(i) - b)));
+        _posterior[size_t(i)] *= correct ? p : 1.0 - p;
+    }
+    updateEstimate();
+}
+
+void AdaptiveQuiz::updateEstimate()
+{
+    double sum = 0.0;
+    double mean = 0.0;
+    for (int i = 0; i < GridSize; ++i) {
+        sum += _posterior[size_t(i)];
+        mean += _posterior[size_t(i)] * gridTheta(i);
+    }
+    if (sum <= 0.0) {
+        return;
+    }
+    mean /= sum;
+
+    double variance = 0.0;
+    for (int i = 0; i < GridSize; ++i) {
+        const double d = gridTheta(i) - mean;
+        variance += _posterior[size_t(i)] * d * d;
+        _posterior[size_t(i)] /= sum;    // 归一化，避免连乘下溢
+    }
+    _theta = mean;
+    _standardError = qSqrt(variance / sum);
+}
+
+QVector<AdaptiveQuiz::PointResult> AdaptiveQuiz::results() const
+{
+    QVector<PointResult> result;
+    for (int k = 0; k < _points.size(); ++k) {
+        result.append({_bank->pointName(_points[k]), _pointAsked[k], _pointCorrect[k]});
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef ADAPTIVEQUIZ_H
+#define ADAPTIVEQUIZ_H
+
+#include "itembank.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+// 自适应测验（计算机化自适应测试）
+// 能力 theta 的后验分布放在 [-4, 4] 的等距网格上，先验为标准正态，每答一题乘以该题的作答概率，
+// theta 取后验均值（EAP），标准误取后验标准差。
+// 出题时在被考查次数最少的知识点中，选当前 theta 下信息量最大、尚未出过的题。
+class AdaptiveQuiz
+{
+public:
+    struct PointResult {
+        QString name;
+        int asked;
+        int correct;
+    };
+
+    AdaptiveQuiz(const ItemBank &bank, const QStringList &knowledgePoints, int maxQuestions);
+
+    QStringList untestable() const { return _untestable; }  // 题库中没有题目的知识点
+
+    int nextItem();                     // 已经结束时返回 -1
+    void answer(int item, bool correct);
+
+    bool finished() const;
+    int asked() const { return _asked; }
+    int maxQuestions() const { return _maxQuestions; }
+    double theta() const { return _theta; }
+    double standardError() const { return _standardError; }
+    QVector<PointResult> results() const;
+
+private:
+    const ItemBank *_bank;
+    QVector<int> _points;               // 要考查的知识点（题库下标）
+    QVector<int> _pointAsked;
+    QVector<int> _pointCorrect;
+    QVector<int> _pointRemaining;       // 各知识点尚未出过的题数
+    QStringList _untestable;
+    std::vector<float> _weight;         // 题目是否可选（1 / 0），与题库等长
+    std::vector<double> _posterior;     // theta 网格上的后验
+    int _maxQuestions;
+    int _asked;
+    double _theta;
+    double _standardError;
+
+    void updateEstimate();
+};
+
+#endif // ADAPTIVEQUIZ_H
@@ -0,0 +1,230 @@
+#include "alsmodel.h"
+#include "simdkernels.h"
+#include "parallelfor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// 计算 F^T F（k x k），F 为 rows x k
+std::vector<double> computeGram(const std::vector<float> &factors, int rows, int k)
+{
+    std::vector<double> gram(size_t(k) * k, 0.0);
+    for (int r = 0; r < rows; ++r) {
+        const float *f = factors.data() + size_t(r) * k;
+        for (int a = 0; a < k; ++a) {
+            const double fa = f[a];
+            double *row = gram.data() + size_t(a) * k;
+            for (int c = 0; c <= a; ++c) {
+                row[c] += fa * f[c];
+            }
+        }
+    }
+    for (int a = 0; a < k; ++a) {
+        for (int c = a + 1; c < k; ++c) {
+            gram[size_t(a) * k + c] = gram[size_t(c) * k + a];
+        }
+    }
+    return gram;
+}
+
+// 就地 Cholesky 分解后解 A x = b（只使用 A 的下三角），结果写回 b
+bool choleskySolve(double *A, double *b, int k)
+{
+    for (int j = 0; j < k; ++j) {
+        double sum = A[j * k + j];
+        for (int p = 0; p < j; ++p) {
+            sum -= A[j * k + p] * A[j * k + p];
+        }
+        if (sum <= 0.0) return false;
+        const double diag = std::sqrt(sum);
+        A[j * k + j] = diag;
+        for (int i = j + 1; i < k; ++i) {
+            double s = A[i * k + j];
+            for (int p = 0; p < j; ++p) {
+                s -= A[i * k + p] * A[j * k + p];
+            }
+            A[i * k + j] = s / diag;
+        }
+    }
+    // L y = b
+    for (int i = 0; i < k; ++i) {
+        double s = b[i];
+        for (int p = 0; p < i; ++p) s -= A[i * k + p] * b[p];
+        b[i] = s / A[i * k + i];
+    }
+    // L^T x = y
+    for (int i = k - 1; i >= 0; --i) {
+        double s = b[i];
+        for (int p = i + 1; p < k; ++p) s -= A[p * k + i] * b[p];
+        b[i] = s / A[i * k + i];
+    }
+    return true;
+}
+
+// 求一行因子：(G + alpha * sum(y y^T) + lambda I) x = (1 + alpha) * sum(y)
+void solveRow(const std::vector<double> &gram, const float *other, const int *neighbours, int count,
+              int k, float regularization, float alpha, double *A, double *b, float *out)
+{
+    std::copy(gram.begin(), gram.end(), A);
+    std::fill(b, b + k, 0.0);
+    for (int a = 0; a < k; ++a) {
+        A[a * k + a] += regularization;
+    }
+
+    for (int n = 0; n < count; ++n) {
+        const float *y = other + size_t(neighbours[n]) * k;
+        for (int a = 0; a < k; ++a) {
+            const double ya = y[a];
+            b[a] += (1.0 + alpha) * ya;
+            double *row = A + a * k;
+            const double w = alpha * ya;
+            for (int c = 0; c <= a; ++c) {
+                row[c] += w * y[c];
+            }
+        }
+    }
+
+    if (!choleskySolve(A, b, k)) {
+        std::fill(out, out + k, 0.0f);
+        return;
+    }
+    for (int a = 0; a < k; ++a) {
+        out[a] = float(b[a]);
+    }
+}
+
+// 对一侧所有行求解
+void solveSide(int rows, const std::vector<int> &offsets, const std::vector<int> &indices,
+               const std::vector<float> &other, int otherRows, int k,
+               float regularization, float alpha, int threads, std::vector<float> &out)
+{
+    const std::vector<double> gram = computeGram(other, otherRows, k);
+    parallelFor(rows, threads, [&](int begin, int end) {
+        std::vector<double> A(size_t(k) * k);
+        std::vector<double> b(k);
+        for (int r = begin; r < end; ++r) {
+            solveRow(gram, other.data(), indices.data() + offsets[r], offsets[r + 1] - offsets[r],
+                     k, regularization, alpha, A.data(), b.data(), out.data() + size_t(r) * k);
+        }
+    });
+}
+
+}
+
+AlsModel::AlsModel()
+    : _factors(0)
+    , _itemCount(0)
+    , _regularization(0.05f)
+    , _alpha(20.0f)
+{
+}
+
+void AlsModel::train(int userCount, int itemCount,
+                     const std::vector<int> &userOffsets, const std::vector<int> &userItems,
+                     const Options &options)
+{
+    const int k = options.factors;
+    const int threads = resolveThreads(options.threads);
+    _factors = k;
+    _itemCount = itemCount;
+    _regularization = options.regularization;
+    _alpha = options.alpha;
+
+    // 转置得到 知识点 -> 学生 的 CSR
+    std::vector<int> itemOffsets(size_t(itemCount) + 1, 0);
+    for (int item : userItems) {
+        itemOffsets[size_t(item) + 1]++;
+    }
+    for (int i = 0; i < itemCount; ++i) {
+        itemOffsets[size_t(i) + 1] += itemOffsets[i];
+    }
+    std::vector<int> itemUsers(userItems.size());
+    std::vector<int> cursor(itemOffsets.begin(), itemOffsets.end() - 1);
+    for (int u = 0; u < userCount; ++u) {
+        for (int p = userOffsets[u]; p < userOffsets[u + 1]; ++p) {
+            itemUsers[size_t(cursor[userItems[p]]++)] = u;
+        }
+    }
+
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    _itemFactors.assign(size_t(itemCount) * k, 0.0f);
+    for (float &x : _itemFactors) {
+        x = noise(rng);
+    }
+    std::vector<float> userFactors(size_t(userCount) * k, 0.0f);
+
+    for (int iter = 0; iter < options.iterations; ++iter) {
+        solveSide(userCount, userOffsets, userItems, _itemFactors, itemCount, k,
+                  _regularization, _alpha, threads, userFactors);
+        solveSide(itemCount, itemOffsets, itemUsers, userFactors, userCount, k,
+                  _regularization, _alpha, threads, _itemFactors);
+    }
+
+    updateGram();
+}
+
+void AlsModel::setModel(int factors, int itemCount, float regularization, float alpha,
+                        std::vector<float> itemFactors)
+{
+    _factors = factors;
+    _itemCount = itemCount;
+    _regularization = regularization;
+    _alpha = alpha;
+    _itemFactors = std::move(itemFactors);
+    updateGram();
+}
+
+void AlsModel::updateGram()
+{
+    _itemGram = computeGram(_itemFactors, _itemCount, _factors);
+}
+
+std::vector<float> AlsModel::foldIn(const int *items, int count) const
+{
+    const int k = _factors;
+    std::vector<float> result(k, 0.0f);
+    if (k == 0) return result;
+
+    std::vector<double> A(size_t(k) * k);
+    std::vector<double> b(k);
+    solveRow(_itemGram, _itemFactors.data(), items, count, k, _regularization, _alpha,
+             A.data(), b.data(), result.data());
+    return result;
+}
+
+std::vector<std::pair<int, float>> AlsModel::recommend(const std::vector<float> &userFactors,
+                                                       const int *known, int knownCount, int k) const
+{
+    std::vector<std::pair<int, float>> heap;
+    if (k <= 0 || int(userFactors.size()) != _factors) return heap;
+
+    std::vector<int> sortedKnown(known, known + knownCount);
+    std::sort(sortedKnown.begin(), sortedKnown.end());
+
+    auto minFirst = [](const std::pair<int, float> &a, const std::pair<int, float> &b) {
+        return a.second > b.second;
+    };
+    heap.reserve(k);
+    const float *user = userFactors.data();
+    for (int item = 0; item < _itemCount; ++item) {
+        const float score = SimdKernels::dotF32(user, _itemFactors.data() + size_t(item) * _factors, _factors);
+        if (int(heap.size()) == k && score <= heap.front().second) continue;
+        if (std::binary_search(sortedKnown.begin(), sortedKnown.end(), item)) continue;
+
+        if (int(heap.size()) < k) {
+            heap.emplace_back(item, score);
+            std::push_heap(heap.begin(), heap.end(), minFirst);
+        } else {
+            std::pop_heap(heap.begin(), heap.end(), minFirst);
+            heap.back() = std::make_pair(item, score);
+            std::push_heap(heap.begin(), heap.end(), minFirst);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), minFirst);   // 得分降序
+    return heap;
+}
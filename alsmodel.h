@@ -0,0 +1,57 @@
+#ifndef ALSMODEL_H
+#define ALSMODEL_H
+
+#include <utility>
+#include <vector>
+
+// 隐式反馈矩阵分解（Hu, Koren, Volinsky 的加权 ALS）
+// 行为“学生”，列为“知识点”，学生掌握某知识点即为一次观测（置信度 1 + alpha）
+// 训练时交替固定一侧因子、并行地对另一侧每一行解 k x k 线性方程组
+class AlsModel
+{
+public:
+    struct Options {
+        int factors = 32;               // 隐因子维度 k
+        int iterations = 10;            // 交替迭代轮数
+        float regularization = 0.05f;   // L2 正则 lambda
+        float alpha = 20.0f;            // 观测置信度系数
+        int threads = 0;                // 0 表示使用全部硬件线程
+        unsigned seed = 42;
+    };
+
+    AlsModel();
+
+    // 交互矩阵以 CSR 给出：userOffsets 长度 userCount + 1，userItems 为各学生掌握的知识点下标
+    void train(int userCount, int itemCount,
+               const std::vector<int> &userOffsets, const std::vector<int> &userItems,
+               const Options &options);
+
+    // 从已保存的参数恢复（itemFactors 长度为 itemCount * factors）
+    void setModel(int factors, int itemCount, float regularization, float alpha,
+                  std::vector<float> itemFactors);
+
+    // 根据学生已掌握的知识点即时求出其因子向量（不需要重新训练）
+    std::vector<float> foldIn(const int *items, int count) const;
+
+    // 对全部知识点打分，返回得分最高且未掌握的 k 个 (下标, 得分)
+    std::vector<std::pair<int, float>> recommend(const std::vector<float> &userFactors,
+                                                 const int *known, int knownCount, int k) const;
+
+    int factors() const { return _factors; }
+    int itemCount() const { return _itemCount; }
+    float regularization() const { return _regularization; }
+    float alpha() const { return _alpha; }
+    const std::vector<float> &itemFactors() const { return _itemFactors; }
+
+private:
+    int _factors;
+    int _itemCount;
+    float _regularization;
+    float _alpha;
+    std::vector<float> _itemFactors;    // itemCount x factors，行优先
+    std::vector<double> _itemGram;      // Y^T Y，foldIn 时复用
+
+    void updateGram();
+};
+
+#endif // ALSMODEL_H
@@ -0,0 +1,122 @@
+#include "answercache.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// 每个条目除回答文本外的固定开销（键、链表节点、时间戳等）的估计值
+const int EntryOverhead = 64;
+
+quint64 fnv1a(const QByteArray &data, quint64 hash = 1469598103934665603ULL)
+{
+    for (char ch : data) {
+        hash ^= quint8(ch);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+int entryCost(const QString &answer)
+{
+    return EntryOverhead + answer.size() * int(sizeof(QChar));
+}
+
+}
+
+AnswerCache::AnswerCache(qint64 maxBytes, int ttlSeconds)
+    : _cache(int(qMin<qint64>(maxBytes, INT_MAX)))
+    , _ttlMs(qint64(ttlSeconds) * 1000)
+{
+    _clock.start();
+}
+
+QString AnswerCache::normalizeQuestion(const QString &question)
+{
+    // NFKC 把全角字母、全角标点等兼容字符统一成标准形式
+    const QString folded = question.normalized(QString::NormalizationForm_KC).toCaseFolded();
+
+    QString result;
+    result.reserve(folded.size());
+    bool pendingSpace = false;
+    for (const QChar ch : folded) {
+        // 保留 # 和 +，避免 "C#"、"C++" 与 "C" 混为同一个问题
+        const bool separator = ch.isSpace() || (ch.isPunct() && ch != QLatin1Char('#'));
+        if (separator) {
+            pendingSpace = !result.isEmpty();
+            continue;
+        }
+        if (pendingSpace) {
+            result += QLatin1Char(' ');
+            pendingSpace = false;
+        }
+        result += ch;
+    }
+    return result;
+}
+
+AnswerCache::Key AnswerCache::makeKey(const QString &question, const QStringList &knowledgePoints)
+{
+    // 知识库与顺序无关：归一化后排序去重再哈希，条目之间用 0x1f 分隔
+    QStringList points;
+    points.reserve(knowledgePoints.size());
+    for (const QString &point : knowledgePoints) {
+        QString normalized = normalizeQuestion(point);
+        if (!normalized.isEmpty()) {
+            points.append(normalized);
+        }
+    }
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+
+    quint64 context = fnv1a(QByteArray());
+    for (const QString &point : points) {
+        context = fnv1a(point.toUtf8() + '\x1f', context);
+    }
+    return Key(fnv1a(normalizeQuestion(question).toUtf8()), context);
+}
+
+bool AnswerCache::lookup(const Key &key, QString *answer)
+{
+    Entry *entry = _cache.object(key);         // 命中时同时更新最近使用顺序
+    if (entry && _ttlMs > 0 && _clock.elapsed() - entry->storedMs > _ttlMs) {
+        _cache.remove(key);
+        _stats.expired++;
+        entry = nullptr;
+    }
+
+    if (!entry) {
+        _stats.misses++;
+        return false;
+    }
+
+    _stats.hits++;
+    *answer = entry->answer;
+    return true;
+}
+
+void AnswerCache::insert(const Key &key, const QString &answer)
+{
+    const int before = _cache.count();
+    const bool replacing = _cache.contains(key);
+
+    Entry *entry = new Entry{answer, _clock.elapsed()};
+    const bool inserted = _cache.insert(key, entry, entryCost(answer));    // QCache 接管 entry
+
+    // QCache 不报告淘汰，用插入前后的条目数推算
+    const int expected = before - (replacing ? 1 : 0) + (inserted ? 1 : 0);
+    _stats.evictions += qMax(0, expected - _cache.count());
+}
+
+void AnswerCache::clear()
+{
+    _cache.clear();
+}
+
+AnswerCache::Stats AnswerCache::stats() const
+{
+    Stats stats = _stats;
+    stats.entries = _cache.count();
+    stats.bytes = _cache.totalCost();
+    return stats;
+}
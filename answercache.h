@@ -0,0 +1,56 @@
+#ifndef ANSWERCACHE_H
+#define ANSWERCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QCache>
+#include <QPair>
+#include <QElapsedTimer>
+
+// AI 回答的本地缓存
+// 键由两个 64 位哈希组成：归一化后的问题（NFKC、大小写折叠、去掉标点、合并空白）
+// 和排序去重后的知识库。内存按回答字节数计费，超出上限时淘汰最久未使用的条目，
+// 超过有效期的条目在查询时丢弃。
+class AnswerCache
+{
+public:
+    typedef QPair<quint64, quint64> Key;
+
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 expired = 0;             // 因过期而未命中的次数
+        qint64 evictions = 0;           // 因容量不足而淘汰的条目数
+        int entries = 0;
+        qint64 bytes = 0;
+
+        double hitRate() const { return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    AnswerCache(qint64 maxBytes, int ttlSeconds);
+
+    static QString normalizeQuestion(const QString &question);
+    static Key makeKey(const QString &question, const QStringList &knowledgePoints);
+
+    // 命中时写入 answer 并返回 true
+    bool lookup(const Key &key, QString *answer);
+    void insert(const Key &key, const QString &answer);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    Q_DISABLE_COPY(AnswerCache)
+
+    struct Entry {
+        QString answer;
+        qint64 storedMs;
+    };
+
+    QCache<Key, Entry> _cache;          // 按字节计费的 LRU
+    qint64 _ttlMs;
+    QElapsedTimer _clock;
+    Stats _stats;
+};
+
+#endif // ANSWERCACHE_H
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""对比两次微基准结果（QtTest 的 -o 文件,xml 输出），列出变慢的用例。
+
+用法：python3 bench/compare.py [--threshold 0.10] 基线.xml 当前.xml
+  --threshold  相对变慢超过该比例即视为回归（默认 10%）
+
+有回归时退出码为 1，可直接用在 CI 中。
+"""
+
+import argparse
+import sys
+import xml.etree.ElementTree as ET
+
+
+def read_results(path):
+    results = {}        # (函数, 数据行, 指标) -> 每次迭代的值
+    root = ET.parse(path).getroot()
+    for function in root.iter("TestFunction"):
+        name = function.get("name")
+        for result in function.iter("BenchmarkResult"):
+            # XML 输出中的 value 已是每次迭代的平均值
+            key = (name, result.get("tag") or "", result.get("metric"))
+            results[key] = float(result.get("value"))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--threshold", type=float, default=0.10)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    args = parser.parse_args()
+
+    baseline = read_results(args.baseline)
+    current = read_results(args.current)
+
+    regressions = 0
+    for key in sorted(current):
+        if key not in baseline or baseline[key] <= 0:
+            continue
+        ratio = current[key] / baseline[key] - 1.0
+        mark = ""
+        if ratio > args.threshold:
+            mark = "  <-- 回归"
+            regressions += 1
+        function, tag, metric = key
+        print(f"{function}({tag}) [{metric}]: {baseline[key]:.4g} -> {current[key]:.4g} ({ratio:+.1%}){mark}")
+
+    for key in sorted(set(baseline) - set(current)):
+        print(f"{key[0]}({key[1]}): 当前结果中缺失")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
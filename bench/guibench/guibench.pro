@@ -0,0 +1,108 @@
+# 界面响应基准：在进程内启动替身服务器，驱动主窗口切换页面、打开关闭对话框、调整窗口大小，
+# 统计每种操作的处理耗时与到下一帧绘制完成的耗时（p50/p95/p99）
+# 无显示器的机器上运行：
+#   ./smartlearn-guibench -platform offscreen --iterations 200 --json guibench.json --budget menu.knowledge=16
+# 模拟拥塞的无线网络（经 tools/netproxy 的损伤代理连接）：
+#   ./smartlearn-guibench -platform offscreen --network congested-wifi
+QT       += core gui network concurrent widgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = smartlearn-guibench
+
+INCLUDEPATH += ../.. ../../tools/standin ../../tools/netproxy
+
+SOURCES += \
+    ../../adaptivequiz.cpp \
+    ../../alsmodel.cpp \
+    ../../answercache.cpp \
+    ../../capture.cpp \
+    ../../cfrecommender.cpp \
+    ../../chathistory.cpp \
+    ../../chathistorymodel.cpp \
+    ../../chatpage.cpp \
+    ../../completiontrie.cpp \
+    ../../connectmanager.cpp \
+    ../../datafiles.cpp \
+    ../../embeddingindex.cpp \
+    ../../goalmatcher.cpp \
+    ../../itembank.cpp \
+    ../../jsonframereader.cpp \
+    ../../knowledgecanon.cpp \
+    ../../knowledgedialog.cpp \
+    ../../knowledgetaxonomy.cpp \
+    ../../logger.cpp \
+    ../../logindialog.cpp \
+    ../../mainwindow.cpp \
+    ../../messages.cpp \
+    ../../metrics.cpp \
+    ../../minhash.cpp \
+    ../../pathgraphview.cpp \
+    ../../pathlayout.cpp \
+    ../../quizdialog.cpp \
+    ../../registerdialog.cpp \
+    ../../resourceindex.cpp \
+    ../../reviewscheduler.cpp \
+    ../../simdkernels.cpp \
+    ../../spellindex.cpp \
+    ../../stallwatchdog.cpp \
+    ../../tools/netproxy/impairmentproxy.cpp \
+    ../../tools/standin/standinserver.cpp \
+    ../../tracer.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../adaptivequiz.h \
+    ../../alsmodel.h \
+    ../../answercache.h \
+    ../../capture.h \
+    ../../cfrecommender.h \
+    ../../chathistory.h \
+    ../../chathistorymodel.h \
+    ../../chatpage.h \
+    ../../completiontrie.h \
+    ../../config.h \
+    ../../connectmanager.h \
+    ../../datafiles.h \
+    ../../embeddingindex.h \
+    ../../goalmatcher.h \
+    ../../itembank.h \
+    ../../jsonframereader.h \
+    ../../knowledgecanon.h \
+    ../../knowledgedialog.h \
+    ../../knowledgetaxonomy.h \
+    ../../logger.h \
+    ../../logindialog.h \
+    ../../mainwindow.h \
+    ../../messages.h \
+    ../../metrics.h \
+    ../../minhash.h \
+    ../../parallelfor.h \
+    ../../pathgraphview.h \
+    ../../pathlayout.h \
+    ../../quizdialog.h \
+    ../../registerdialog.h \
+    ../../resourceindex.h \
+    ../../reviewscheduler.h \
+    ../../simdkernels.h \
+    ../../spellindex.h \
+    ../../stallwatchdog.h \
+    ../../synonymtable.h \
+    ../../tools/netproxy/impairmentproxy.h \
+    ../../tools/standin/standinserver.h \
+    ../../tracer.h
+
+FORMS += \
+    ../../knowledgedialog.ui \
+    ../../logindialog.ui \
+    ../../mainwindow.ui \
+    ../../registerdialog.ui
+
+RESOURCES += \
+    ../../res.qrc
+
+# 运行时数据文件复制到构建目录
+datafiles.files = $$files(../../data/*)
+datafiles.path = $$OUT_PWD/data
+COPIES += datafiles
@@ -0,0 +1,387 @@
+#include "mainwindow.h"
+#include "knowledgedialog.h"
+#include "registerdialog.h"
+#include "knowledgecanon.h"
+#include "standinserver.h"
+#include "impairmentproxy.h"
+#include "logger.h"
+#include "tracer.h"
+#include "config.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QMap>
+#include <QSemaphore>
+#include <QStackedWidget>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QtMath>
+#include <QDebug>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+const char *const PageNames[] = {"home", "knowledge", "chat", "path", "resource", "settings"};
+
+// 替身服务器运行在独立线程：客户端用 waitForReadyRead 同步等待响应，不能和界面共用一个事件循环
+// 指定网络环境时替身服务器改用 PORT + 1，由同一线程里的损伤代理在 PORT 上转发
+class ServerThread : public QThread
+{
+public:
+    ServerThread(const StandinServer::Options &options, const ImpairmentProxy::Options *network)
+        : _options(options)
+        , _impaired(network != nullptr)
+        , _ok(false)
+    {
+        if (network) _network = *network;
+    }
+
+    // 启动线程并等待开始监听
+    bool startAndWait(QString *error)
+    {
+        start();
+        _ready.acquire();
+        if (!_ok && error) *error = _error;
+        return _ok;
+    }
+
+protected:
+    void run() override
+    {
+        StandinServer server(_options);
+        ImpairmentProxy proxy(_network, "127.0.0.1", PORT + 1);
+        if (_impaired) {
+            _ok = server.listen(QHostAddress::LocalHost, PORT + 1);
+            _error = server.errorString();
+            if (_ok) {
+                _ok = proxy.listen(QHostAddress::LocalHost, PORT);
+                _error = proxy.errorString();
+            }
+        } else {
+            _ok = server.listen(QHostAddress::LocalHost, PORT);
+            _error = server.errorString();
+        }
+        _ready.release();
+        if (_ok) {
+            exec();
+        }
+    }
+
+private:
+    StandinServer::Options _options;
+    ImpairmentProxy::Options _network;
+    bool _impaired;
+    QSemaphore _ready;
+    bool _ok;
+    QString _error;
+};
+
+// 一种操作的样本（毫秒）
+// handler：操作本身占用事件循环的时间；frame：从操作开始到重绘完成、事件循环重新空闲的时间
+struct Series {
+    QVector<double> handler;
+    QVector<double> frame;
+};
+
+double elapsedMs(const QElapsedTimer &timer)
+{
+    return double(timer.nsecsElapsed()) / 1e6;
+}
+
+// 处理已投递的事件（包括重绘请求），直到事件循环空闲
+void waitForIdle()
+{
+    QCoreApplication::sendPostedEvents();
+    QEventLoop loop;
+    QTimer::singleShot(0, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const int rank = qBound(1, int(qCeil(p / 100.0 * values.size())), values.size());
+    return values[rank - 1];
+}
+
+QJsonObject summarize(const QVector<double> &values)
+{
+    QJsonObject json;
+    json["count"] = values.size();
+    json["p50"] = percentile(values, 50);
+    json["p95"] = percentile(values, 95);
+    json["p99"] = percentile(values, 99);
+    json["max"] = percentile(values, 100);
+    return json;
+}
+
+// 以 exec() 打开的知识库对话框：显示后记录耗时并立即关闭
+class DialogCloser : public QObject
+{
+public:
+    QElapsedTimer clock;
+    double shownMs = 0.0;               // 构造并加载完成、对话框开始显示
+    double paintedMs = 0.0;             // 对话框首帧绘制完成
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Show) {
+            if (KnowledgeDialog *dialog = qobject_cast<KnowledgeDialog *>(watched)) {
+                shownMs = elapsedMs(clock);
+                QTimer::singleShot(0, dialog, [this, dialog]() {
+                    paintedMs = elapsedMs(clock);
+                    clock.restart();
+                    dialog->reject();
+                });
+            }
+        }
+        return false;
+    }
+};
+
+// 用单独的连接写入测试用户的知识库，主窗口刷新时会取回这些数据
+bool seedKnowledge(const QString &username, int count)
+{
+    const QStringList baseNames = {
+        "C语言", "数据结构", "算法", "操作系统", "计算机网络", "数据库", "设计模式",
+        "二叉树", "动态规划", "TCP", "Python", "线性代数", "高等数学", "Git", "Linux"
+    };
+    QStringList points;
+    for (int i = 0; i < count; ++i) {
+        points.append(i < baseNames.size() ? baseNames[i] : QString("知识点 %1").arg(i));
+    }
+
+    QJsonObject json;
+    json["type"] = SaveKnowledgeType;
+    json["username"] = username;
+    json["learning_goal"] = "考研";
+    json["knowledge_points"] = QJsonArray::fromStringList(points);
+    json["knowledge_ids"] = QJsonArray::fromStringList(KnowledgeCanon::canonicalIds(points));
+
+    QTcpSocket socket;
+    socket.connectToHost("127.0.0.1", PORT);
+    if (!socket.waitForConnected(3000)) {
+        return false;
+    }
+    socket.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    return socket.waitForBytesWritten(3000) && socket.waitForReadyRead(3000);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    app.setApplicationName("smartlearn-guibench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SmartLearn 界面响应基准（无显示器时加 -platform offscreen）");
+    parser.addHelpOption();
+
+    QCommandLineOption iterationsOption("iterations", "每种操作的测量次数", "count", "100");
+    QCommandLineOption warmupOption("warmup", "预热次数（不计入结果）", "count", "5");
+    QCommandLineOption settleOption("settle-ms", "开始测量前等待后台加载的时间（毫秒）", "ms", "3000");
+    QCommandLineOption knowledgeOption("knowledge-points", "测试用户的知识点数", "count", "200");
+    QCommandLineOption pathNodesOption("path-nodes", "替身服务器返回的学习路径规模，0 表示默认路线", "count", "0");
+    QCommandLineOption jsonOption("json", "把结果写入 JSON 文件", "file");
+    QCommandLineOption budgetOption("budget", "frame p99 上限，如 menu.knowledge=16，可重复", "name=ms");
+    QCommandLineOption traceOption("trace", "记录测量期间的追踪并写入 Chrome trace 文件", "file");
+    QCommandLineOption verboseOption("verbose", "保留客户端的调试输出");
+    QCommandLineOption networkOption("network", "经损伤代理连接替身服务器：" + ImpairmentProxy::profileNames().join("/"), "profile");
+    parser.addOption(iterationsOption);
+    parser.addOption(warmupOption);
+    parser.addOption(settleOption);
+    parser.addOption(knowledgeOption);
+    parser.addOption(pathNodesOption);
+    parser.addOption(jsonOption);
+    parser.addOption(budgetOption);
+    parser.addOption(traceOption);
+    parser.addOption(verboseOption);
+    parser.addOption(networkOption);
+    parser.process(app);
+
+    // 调试输出会干扰计时，默认只保留警告
+    if (parser.isSet(verboseOption)) {
+        Logger::setLevel(Logger::Debug);
+    } else {
+        Logger::setLevel(Logger::Warning);
+        QLoggingCategory::setFilterRules("default.debug=false");
+    }
+
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+    const int warmup = qMax(0, parser.value(warmupOption).toInt());
+
+    StandinServer::Options options;
+    options.firstTokenDelayMs = 0;
+    options.tokenDelayMs = 0;
+    options.pathNodes = qMax(0, parser.value(pathNodesOption).toInt());
+    ImpairmentProxy::Options network;
+    if (parser.isSet(networkOption) && !ImpairmentProxy::profile(parser.value(networkOption), &network)) {
+        qCritical() << "未知的网络环境:" << parser.value(networkOption);
+        return 2;
+    }
+    ServerThread server(options, parser.isSet(networkOption) ? &network : nullptr);
+    QString error;
+    if (!server.startAndWait(&error)) {
+        qCritical() << "替身服务器监听端口" << PORT << "失败:" << error;
+        return 2;
+    }
+
+    const QString username = "guibench";
+    if (!seedKnowledge(username, qMax(0, parser.value(knowledgeOption).toInt()))) {
+        qCritical() << "写入测试知识库失败";
+        server.quit();
+        server.wait();
+        return 2;
+    }
+
+    MainWindow window(username);
+    window.show();
+    waitForIdle();
+
+    // 等待资源索引、推荐模型等后台任务完成，避免它们的回调混入测量
+    {
+        QEventLoop loop;
+        QTimer::singleShot(qMax(0, parser.value(settleOption).toInt()), &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    QStackedWidget *stack = window.findChild<QStackedWidget *>();
+    const int pageCount = stack ? stack->count() : 0;
+
+    QMap<QString, Series> results;
+    auto measure = [&results](bool record, const QString &name, const std::function<void()> &action) {
+        QElapsedTimer timer;
+        timer.start();
+        action();
+        const double handler = elapsedMs(timer);
+        waitForIdle();
+        if (record) {
+            results[name].handler.append(handler);
+            results[name].frame.append(elapsedMs(timer));
+        }
+    };
+
+    DialogCloser closer;
+    app.installEventFilter(&closer);
+    Tracer::setEnabled(parser.isSet(traceOption));
+
+    const QSize sizes[] = {QSize(1400, 850), QSize(1024, 640)};   // 常见显示器与机房旧显示器
+
+    for (int i = 0; i < warmup + iterations; ++i) {
+        const bool record = i >= warmup;
+
+        for (int page = 0; page < pageCount; ++page) {
+            const QString name = page < int(sizeof(PageNames) / sizeof(PageNames[0]))
+                    ? QString("menu.%1").arg(PageNames[page]) : QString("menu.%1").arg(page);
+            measure(record, name, [&window, page]() {
+                QMetaObject::invokeMethod(&window, "onMenuClicked", Qt::DirectConnection, Q_ARG(int, page));
+            });
+        }
+
+        // 知识库对话框走真实路径：MainWindow::onKnowledgeClicked 中 exec()，关闭后刷新知识库页面
+        closer.clock.start();
+        QMetaObject::invokeMethod(&window, "onKnowledgeClicked", Qt::DirectConnection);
+        const double closeMs = elapsedMs(closer.clock);
+        waitForIdle();
+        if (record) {
+            results["dialog.knowledge.open"].handler.append(closer.shownMs);
+            results["dialog.knowledge.open"].frame.append(closer.paintedMs);
+            results["dialog.knowledge.close"].handler.append(closeMs);
+            results["dialog.knowledge.close"].frame.append(elapsedMs(closer.clock));
+        }
+
+        RegisterDialog *registerDialog = nullptr;
+        measure(record, "dialog.register.open", [&window, &registerDialog]() {
+            registerDialog = new RegisterDialog(&window);
+            registerDialog->show();
+        });
+        measure(record, "dialog.register.close", [&registerDialog]() {
+            registerDialog->close();
+            delete registerDialog;
+        });
+
+        measure(record, "window.resize", [&window, &sizes, i]() {
+            window.resize(sizes[(i + 1) % 2]);
+        });
+    }
+
+    app.removeEventFilter(&closer);
+    Tracer::setEnabled(false);
+    window.close();
+    server.quit();
+    server.wait();
+
+    // 输出：终端表格 + 可选 JSON
+    QJsonObject scenarios;
+    std::printf("%-26s %-8s %6s %9s %9s %9s %9s\n", "scenario", "metric", "count", "p50(ms)", "p95(ms)", "p99(ms)", "max(ms)");
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        const QJsonObject handler = summarize(it->handler);
+        const QJsonObject frame = summarize(it->frame);
+        for (const auto &metric : {qMakePair(QString("handler"), handler), qMakePair(QString("frame"), frame)}) {
+            std::printf("%-26s %-8s %6d %9.3f %9.3f %9.3f %9.3f\n", qPrintable(it.key()), qPrintable(metric.first),
+                        metric.second["count"].toInt(), metric.second["p50"].toDouble(), metric.second["p95"].toDouble(),
+                        metric.second["p99"].toDouble(), metric.second["max"].toDouble());
+        }
+        QJsonObject scenario;
+        scenario["handler"] = handler;
+        scenario["frame"] = frame;
+        scenarios[it.key()] = scenario;
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject report;
+        report["platform"] = QGuiApplication::platformName();
+        report["iterations"] = iterations;
+        report["knowledge_points"] = parser.value(knowledgeOption).toInt();
+        report["path_nodes"] = options.pathNodes;
+        report["network"] = parser.isSet(networkOption) ? parser.value(networkOption) : QString("direct");
+        report["scenarios"] = scenarios;
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "无法写入" << file.fileName() << file.errorString();
+            return 2;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    if (parser.isSet(traceOption) && !Tracer::writeChromeTrace(parser.value(traceOption), &error)) {
+        qCritical() << error;
+        return 2;
+    }
+
+    // 预算检查：任一场景的 frame p99 超出上限时返回 1，便于在 CI 中使用
+    int exceeded = 0;
+    for (const QString &budget : parser.values(budgetOption)) {
+        const int eq = budget.indexOf('=');
+        const QString name = budget.left(eq);
+        const double limit = budget.mid(eq + 1).toDouble();
+        if (eq <= 0 || !results.contains(name)) {
+            qWarning() << "无效的预算:" << budget;
+            exceeded++;
+            continue;
+        }
+        const double p99 = percentile(results[name].frame, 99);
+        if (p99 > limit) {
+            std::printf("超出预算: %s frame p99 %.3f ms > %.3f ms\n", qPrintable(name), p99, limit);
+            exceeded++;
+        }
+    }
+
+    return exceeded ? 1 : 0;
+}
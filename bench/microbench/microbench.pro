@@ -0,0 +1,38 @@
+# 微基准：协议消息的构造与解析、注册输入校验、知识点去重与加载
+# 运行并输出机器可读结果（QtTest 自带格式）：
+#   ./smartlearn-microbench -o microbench.xml,xml -o -,txt
+# 用 bench/compare.py 对比两次结果，找出变慢的用例
+QT       = core network widgets testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = smartlearn-microbench
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../capture.cpp \
+    ../../connectmanager.cpp \
+    ../../jsonframereader.cpp \
+    ../../knowledgecanon.cpp \
+    ../../logger.cpp \
+    ../../messages.cpp \
+    ../../metrics.cpp \
+    ../../registerdialog.cpp \
+    tst_microbench.cpp
+
+HEADERS += \
+    ../../capture.h \
+    ../../config.h \
+    ../../connectmanager.h \
+    ../../jsonframereader.h \
+    ../../knowledgecanon.h \
+    ../../logger.h \
+    ../../messages.h \
+    ../../metrics.h \
+    ../../registerdialog.h \
+    ../../synonymtable.h
+
+FORMS += \
+    ../../registerdialog.ui
@@ -0,0 +1,673 @@
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "config.h"
+#include "jsonframereader.h"
+#include "knowledgecanon.h"
+#include "messages.h"
+#include "registerdialog.h"
+
+// 消息的字段与各窗口中构造、解析的方式保持一致，规模覆盖到 10 万个知识点
+namespace {
+
+const QStringList BaseNames = {
+    "C++", "cpp", "数据结构", "二叉树", "链表", "动态规划", "操作系统", "计算机网络", "TCP", "HTTP",
+    "Python", "机器学习", "深度学习", "线性代数", "高等数学", "SQL", "MySQL", "Git", "Linux", "设计模式"
+};
+
+// 前 20 个是真实知识点（含同义写法），之后加编号；约 5% 与前面重复，模拟旧数据中的重复写法
+QStringList makeKnowledgePoints(int count)
+{
+    QStringList points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (i < BaseNames.size()) {
+            points.append(BaseNames[i]);
+        } else if (i % 20 == 0) {
+            points.append(points[i / 2]);
+        } else {
+            points.append(QString("%1 %2").arg(BaseNames[i % BaseNames.size()]).arg(i));
+        }
+    }
+    return points;
+}
+
+QByteArray knowledgeResponse(int count)
+{
+    const QStringList points = makeKnowledgePoints(count);
+    QJsonObject reply;
+    reply["type"] = "KnowledgeResponse";
+    reply["status"] = "success";
+    reply["learning_goal"] = "考研";
+    reply["knowledge_points"] = QJsonArray::fromStringList(points);
+    reply["knowledge_ids"] = QJsonArray::fromStringList(KnowledgeCanon::canonicalIds(points));
+    return QJsonDocument(reply).toJson(QJsonDocument::Compact);
+}
+
+QByteArray pathResponse(int count)
+{
+    QJsonArray nodes;
+    QJsonArray edges;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject node;
+        node["id"] = QString("k%1").arg(i);
+        node["name"] = QString("知识点 %1").arg(i);
+        node["mastered"] = i % 3 == 0;
+        nodes.append(node);
+        if (i > 0) edges.append(QJsonArray{(i - 1) / 2, i});
+        if (i > 2) edges.append(QJsonArray{i - 3, i});
+    }
+    QJsonObject reply;
+    reply["type"] = "PathResponse";
+    reply["status"] = "success";
+    reply["nodes"] = nodes;
+    reply["edges"] = edges;
+    return QJsonDocument(reply).toJson(QJsonDocument::Compact);
+}
+
+QJsonArray reviewRows(int count)
+{
+    QJsonArray rows;
+    for (int i = 0; i < count; ++i) {
+        rows.append(QJsonArray{QString("k%1").arg(i), 1700000000.0 + i * 60, 1699900000.0 + i * 60, 6, 250, 2, 0});
+    }
+    return rows;
+}
+
+void addSizeRows(const QList<int> &sizes)
+{
+    QTest::addColumn<int>("count");
+    for (int size : sizes) {
+        QTest::newRow(qPrintable(QString::number(size))) << size;
+    }
+}
+
+}
+
+class MicroBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 请求构造
+    void encodeLogin();
+    void encodeRegister();
+    void encodeSaveKnowledge_data();
+    void encodeSaveKnowledge();
+    void encodeGetKnowledge();
+    void encodeLoginTyped();
+    void encodeRegisterTyped();
+    void encodeSaveKnowledgeTyped_data();
+    void encodeSaveKnowledgeTyped();
+    void encodeGetKnowledgeTyped();
+    void encodeLoginBatch();
+    void encodeGetPath_data();
+    void encodeGetPath();
+    void encodeChat_data();
+    void encodeChat();
+    void encodeSaveReviews_data();
+    void encodeSaveReviews();
+    void encodeGetReviews();
+
+    // 响应解析
+    void decodeKnowledgeResponse_data();
+    void decodeKnowledgeResponse();
+    void decodeKnowledgeResponseTyped_data();
+    void decodeKnowledgeResponseTyped();
+    void decodeLoginBatchResponse_data();
+    void decodeLoginBatchResponse();
+    void decodePathResponse_data();
+    void decodePathResponse();
+    void decodeChatStream_data();
+    void decodeChatStream();
+    void decodeReviewResponse_data();
+    void decodeReviewResponse();
+
+    // 注册输入校验
+    void validateUsername_data();
+    void validateUsername();
+    void validatePassword_data();
+    void validatePassword();
+    void validateEmail_data();
+    void validateEmail();
+    void validatePhone_data();
+    void validatePhone();
+
+    // 知识库对话框的添加、去重与加载
+    void canonicalId_data();
+    void canonicalId();
+    void dedupeKnowledge_data();
+    void dedupeKnowledge();
+    void loadKnowledge_data();
+    void loadKnowledge();
+};
+
+void MicroBench::encodeLogin()
+{
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json.insert("type", LoginType);
+        json.insert("user", "student01");
+        json.insert("password", "passw0rd123");
+        data = QJsonDocument(json).toJson();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeRegister()
+{
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = RegisterType;
+        json["username"] = "student01";
+        json["password"] = "passw0rd123";
+        json["email"] = "student01@example.com";
+        json["phone"] = "13800138000";
+        json["grade"] = "2022";
+        json["major"] = "计算机科学与技术";
+        json["role"] = "student";
+        data = QJsonDocument(json).toJson();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeSaveKnowledge_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::encodeSaveKnowledge()
+{
+    QFETCH(int, count);
+    const QStringList points = makeKnowledgePoints(count);
+    const QStringList ids = KnowledgeCanon::canonicalIds(points);
+
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = SaveKnowledgeType;
+        json["username"] = "student01";
+        json["learning_goal"] = "考研";
+        json["knowledge_points"] = QJsonArray::fromStringList(points);
+        json["knowledge_ids"] = QJsonArray::fromStringList(ids);
+        data = QJsonDocument(json).toJson();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeGetKnowledge()
+{
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = GetKnowledgeType;
+        json["username"] = "student01";
+        data = QJsonDocument(json).toJson();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+// 以下四项与上面对应的 QJsonObject 构造方式对比，消息内容相同
+void MicroBench::encodeLoginTyped()
+{
+    QByteArray data;
+    QBENCHMARK {
+        Messages::LoginRequest request;
+        request.user = "student01";
+        request.password = "passw0rd123";
+        data = Messages::encode(request);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeRegisterTyped()
+{
+    QByteArray data;
+    QBENCHMARK {
+        Messages::RegisterRequest request;
+        request.username = "student01";
+        request.password = "passw0rd123";
+        request.email = "student01@example.com";
+        request.phone = "13800138000";
+        request.grade = "2022";
+        request.major = "计算机科学与技术";
+        request.role = "student";
+        data = Messages::encode(request);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeSaveKnowledgeTyped_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::encodeSaveKnowledgeTyped()
+{
+    QFETCH(int, count);
+    Messages::SaveKnowledgeRequest request;
+    request.username = "student01";
+    request.learningGoal = "考研";
+    request.knowledgePoints = makeKnowledgePoints(count);
+    request.knowledgeIds = KnowledgeCanon::canonicalIds(request.knowledgePoints);
+
+    QByteArray data;
+    QBENCHMARK {
+        data = Messages::encode(request);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeGetKnowledgeTyped()
+{
+    QByteArray data;
+    QBENCHMARK {
+        Messages::GetKnowledgeRequest request;
+        request.username = "student01";
+        data = Messages::encode(request);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+// 登录和查询知识库合成的批量请求
+void MicroBench::encodeLoginBatch()
+{
+    QByteArray data;
+    QBENCHMARK {
+        Messages::LoginRequest login;
+        login.user = "student01";
+        login.password = "passw0rd123";
+        Messages::GetKnowledgeRequest knowledge;
+        knowledge.username = "student01";
+        Messages::Batch batch;
+        batch.add(login);
+        batch.add(knowledge);
+        data = batch.encode();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeGetPath_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::encodeGetPath()
+{
+    QFETCH(int, count);
+    const QStringList ids = KnowledgeCanon::canonicalIds(makeKnowledgePoints(count));
+
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = GetPathType;
+        json["username"] = "student01";
+        json["knowledge_ids"] = QJsonArray::fromStringList(ids);
+        data = QJsonDocument(json).toJson();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeChat_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::encodeChat()
+{
+    QFETCH(int, count);
+    const QStringList points = makeKnowledgePoints(count);
+
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = ChatType;
+        json["id"] = 42;
+        json["username"] = "student01";
+        json["question"] = "如何准备考研数据结构？";
+        json["knowledge_points"] = QJsonArray::fromStringList(points);
+        data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeSaveReviews_data()
+{
+    addSizeRows({1, REVIEW_SYNC_BATCH});
+}
+
+void MicroBench::encodeSaveReviews()
+{
+    QFETCH(int, count);
+    const QJsonArray rows = reviewRows(count);
+
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = SaveReviewsType;
+        json["username"] = "student01";
+        json["cards"] = rows;
+        data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::encodeGetReviews()
+{
+    QByteArray data;
+    QBENCHMARK {
+        QJsonObject json;
+        json["type"] = GetReviewsType;
+        json["username"] = "student01";
+        json["offset"] = 0;
+        json["limit"] = REVIEW_SYNC_BATCH;
+        data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void MicroBench::decodeKnowledgeResponse_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::decodeKnowledgeResponse()
+{
+    QFETCH(int, count);
+    const QByteArray data = knowledgeResponse(count);
+
+    int parsed = 0;
+    QBENCHMARK {
+        const QJsonObject json = QJsonDocument::fromJson(data).object();
+        const QJsonArray points = json["knowledge_points"].toArray();
+        QStringList names;
+        names.reserve(points.size());
+        for (const QJsonValue &value : points) {
+            names.append(value.toString());
+        }
+        parsed = names.size();
+    }
+    QCOMPARE(parsed, count);
+}
+
+void MicroBench::decodeKnowledgeResponseTyped_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::decodeKnowledgeResponseTyped()
+{
+    QFETCH(int, count);
+    const QByteArray data = knowledgeResponse(count);
+
+    int parsed = 0;
+    QBENCHMARK {
+        Messages::KnowledgeResponse reply;
+        QVERIFY(Messages::decode(data, &reply));
+        parsed = reply.knowledgePoints.size();
+    }
+    QCOMPARE(parsed, count);
+}
+
+void MicroBench::decodeLoginBatchResponse_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+// 登录批量请求的回复：登录结果 + 知识库
+void MicroBench::decodeLoginBatchResponse()
+{
+    QFETCH(int, count);
+    const QByteArray data = "{\"type\":\"BatchResponse\",\"results\":[\"yes\"," + knowledgeResponse(count) + "]}";
+
+    int parsed = 0;
+    QBENCHMARK {
+        QList<QByteArray> results;
+        QVERIFY(Messages::decodeBatch(data, &results));
+        Messages::KnowledgeResponse reply;
+        QVERIFY(Messages::decode(results[1], &reply));
+        parsed = reply.knowledgePoints.size();
+    }
+    QCOMPARE(parsed, count);
+}
+
+void MicroBench::decodePathResponse_data()
+{
+    addSizeRows({100, 10000});
+}
+
+void MicroBench::decodePathResponse()
+{
+    QFETCH(int, count);
+    const QByteArray data = pathResponse(count);
+
+    int parsed = 0;
+    QBENCHMARK {
+        const QJsonObject json = QJsonDocument::fromJson(data).object();
+        const QJsonArray nodes = json["nodes"].toArray();
+        QStringList names;
+        QVector<bool> mastered;
+        for (const QJsonValue &value : nodes) {
+            const QJsonObject node = value.toObject();
+            names.append(node["name"].toString());
+            mastered.append(node["mastered"].toBool());
+        }
+        QVector<QPair<int, int>> edges;
+        for (const QJsonValue &value : json["edges"].toArray()) {
+            const QJsonArray edge = value.toArray();
+            edges.append(qMakePair(edge.at(0).toInt(), edge.at(1).toInt()));
+        }
+        parsed = names.size();
+    }
+    QCOMPARE(parsed, count);
+}
+
+void MicroBench::decodeChatStream_data()
+{
+    addSizeRows({300, 10000});
+}
+
+void MicroBench::decodeChatStream()
+{
+    // 回答片段连续到达，按 TCP 分段大小喂给 JsonFrameReader
+    QFETCH(int, count);
+    QByteArray stream;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject chunk;
+        chunk["type"] = "ChatChunk";
+        chunk["id"] = 42;
+        chunk["delta"] = QString("第%1段").arg(i);
+        chunk["done"] = i == count - 1;
+        stream += QJsonDocument(chunk).toJson(QJsonDocument::Compact);
+    }
+
+    int frames = 0;
+    QBENCHMARK {
+        JsonFrameReader reader;
+        QString answer;
+        frames = 0;
+        for (int offset = 0; offset < stream.size(); offset += 1400) {
+            reader.append(stream.mid(offset, 1400));
+            QByteArray frame;
+            while (reader.next(&frame)) {
+                const QJsonObject json = QJsonDocument::fromJson(frame).object();
+                answer += json["delta"].toString();
+                frames++;
+            }
+        }
+    }
+    QCOMPARE(frames, count);
+}
+
+void MicroBench::decodeReviewResponse_data()
+{
+    addSizeRows({REVIEW_SYNC_BATCH});
+}
+
+void MicroBench::decodeReviewResponse()
+{
+    QFETCH(int, count);
+    QJsonObject reply;
+    reply["type"] = "ReviewResponse";
+    reply["status"] = "success";
+    reply["cards"] = reviewRows(count);
+    reply["total"] = count;
+    const QByteArray data = QJsonDocument(reply).toJson(QJsonDocument::Compact);
+
+    int parsed = 0;
+    QBENCHMARK {
+        const QJsonArray cards = QJsonDocument::fromJson(data).object()["cards"].toArray();
+        parsed = 0;
+        for (const QJsonValue &value : cards) {
+            const QJsonArray row = value.toArray();
+            parsed += row.at(0).toString().isEmpty() ? 0 : 1;
+        }
+    }
+    QCOMPARE(parsed, count);
+}
+
+void MicroBench::validateUsername_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::newRow("valid") << "student_2024" << true;
+    QTest::newRow("short") << "ab" << false;
+    QTest::newRow("bad-char") << "学生2024" << false;
+}
+
+void MicroBench::validateUsername()
+{
+    QFETCH(QString, input);
+    QFETCH(bool, valid);
+    bool result = false;
+    QBENCHMARK {
+        result = RegisterDialog::checkUsername(input);
+    }
+    QCOMPARE(result, valid);
+}
+
+void MicroBench::validatePassword_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::newRow("valid") << "passw0rd123" << true;
+    QTest::newRow("letters-only") << "password" << false;
+}
+
+void MicroBench::validatePassword()
+{
+    QFETCH(QString, input);
+    QFETCH(bool, valid);
+    bool result = false;
+    QBENCHMARK {
+        result = RegisterDialog::validatePassword(input);
+    }
+    QCOMPARE(result, valid);
+}
+
+void MicroBench::validateEmail_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::newRow("valid") << "student01@example.com" << true;
+    QTest::newRow("invalid") << "student01@example" << false;
+}
+
+void MicroBench::validateEmail()
+{
+    QFETCH(QString, input);
+    QFETCH(bool, valid);
+    bool result = false;
+    QBENCHMARK {
+        result = RegisterDialog::validateEmail(input);
+    }
+    QCOMPARE(result, valid);
+}
+
+void MicroBench::validatePhone_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<bool>("valid");
+    QTest::newRow("valid") << "13800138000" << true;
+    QTest::newRow("invalid") << "12800138000" << false;
+}
+
+void MicroBench::validatePhone()
+{
+    QFETCH(QString, input);
+    QFETCH(bool, valid);
+    bool result = false;
+    QBENCHMARK {
+        result = RegisterDialog::validatePhone(input);
+    }
+    QCOMPARE(result, valid);
+}
+
+void MicroBench::canonicalId_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::newRow("ascii") << "C++";
+    QTest::newRow("synonym") << "C加加";
+    QTest::newRow("fullwidth") << "ＰＹＴＨＯＮ";
+    QTest::newRow("unknown") << "量子计算导论";
+}
+
+void MicroBench::canonicalId()
+{
+    QFETCH(QString, input);
+    QString id;
+    QBENCHMARK {
+        id = KnowledgeCanon::canonicalId(input);
+    }
+    QVERIFY(!id.isEmpty());
+}
+
+void MicroBench::dedupeKnowledge_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::dedupeKnowledge()
+{
+    QFETCH(int, count);
+    const QStringList points = makeKnowledgePoints(count);
+
+    QStringList names;
+    QBENCHMARK {
+        QStringList ids;
+        names = KnowledgeCanon::uniquePoints(points, &ids);
+    }
+    QVERIFY(names.size() <= count);
+}
+
+void MicroBench::loadKnowledge_data()
+{
+    addSizeRows({10, 1000, 100000});
+}
+
+void MicroBench::loadKnowledge()
+{
+    // KnowledgeDialog::loadKnowledge 中除填充列表控件以外的部分：解析响应并按规范 id 合并
+    QFETCH(int, count);
+    const QByteArray data = knowledgeResponse(count);
+
+    QStringList names;
+    QBENCHMARK {
+        const QJsonObject json = QJsonDocument::fromJson(data).object();
+        QStringList points;
+        for (const QJsonValue &value : json["knowledge_points"].toArray()) {
+            points.append(value.toString());
+        }
+        QStringList ids;
+        names = KnowledgeCanon::uniquePoints(points, &ids);
+    }
+    QVERIFY(!names.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(MicroBench)
+
+#include "tst_microbench.moc"
@@ -0,0 +1,301 @@
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "config.h"
+#include "capture.h"
+#include "jsonframereader.h"
+#include "knowledgecanon.h"
+#include "messages.h"
+
+namespace {
+
+QByteArray knowledgeResponse()
+{
+    const QStringList points = {"C++", "cpp", "数据结构", "二叉树", "动态规划", "计算机网络", "TCP"};
+    QJsonObject reply;
+    reply["type"] = "KnowledgeResponse";
+    reply["status"] = "success";
+    reply["learning_goal"] = "考研";
+    reply["knowledge_points"] = QJsonArray::fromStringList(points);
+    reply["knowledge_ids"] = QJsonArray::fromStringList(KnowledgeCanon::canonicalIds(points));
+    return QJsonDocument(reply).toJson(QJsonDocument::Compact);
+}
+
+// 与旧代码逐个 value.toString() 的结果一致
+QStringList toStringList(const QJsonValue &value)
+{
+    QStringList list;
+    const QJsonArray array = value.toArray();
+    for (const QJsonValue &item : array) {
+        list.append(item.toString());
+    }
+    return list;
+}
+
+}
+
+class UnitTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // 录制文件中不能出现密码
+    void captureRedactsPassword();
+
+    // 被拆开的裸文本回复等后续字节到达后才成帧
+    void frameReaderSplitBareText();
+
+    // 类型化消息与 QJsonDocument 的结果一致
+    void typedEncodeMatchesQJson_data();
+    void typedEncodeMatchesQJson();
+    void typedDecodeMatchesQJson_data();
+    void typedDecodeMatchesQJson();
+    void typedDecodeNumbers_data();
+    void typedDecodeNumbers();
+    void typedLoneSurrogates();
+    void typedFieldBits();
+};
+
+QTEST_GUILESS_MAIN(UnitTests)
+
+void UnitTests::captureRedactsPassword()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("login.slcap");
+
+    Messages::LoginRequest login;
+    login.user = "student01";
+    login.password = "pa\\ss\"w0rd";
+    Messages::GetKnowledgeRequest knowledge;
+    knowledge.username = "student01";
+    Messages::Batch batch;
+    batch.add(login);
+    batch.add(knowledge);
+
+    QVERIFY(Capture::start(path));
+    Capture::sent(Messages::encode(login));
+    Capture::sent(batch.encode());
+    Capture::sent("{\"type\": \"RegisterType\", \"username\": \"student01\", \"password\" : \"secret\"}");
+    Capture::stop();
+
+    QVector<Capture::Frame> frames;
+    QVERIFY(Capture::load(path, &frames));
+    QCOMPARE(frames.size(), 3);
+    for (const Capture::Frame &frame : frames) {
+        QVERIFY2(!frame.data.contains("w0rd") && !frame.data.contains("secret"), frame.data.constData());
+        QVERIFY(frame.data.contains("\"***\""));
+        QVERIFY(frame.data.contains("student01"));
+        // 替换后仍是合法的 JSON，回放时可以原样发送
+        QVERIFY(QJsonDocument::fromJson(frame.data).isObject());
+    }
+}
+
+void UnitTests::frameReaderSplitBareText()
+{
+    JsonFrameReader reader;
+    QByteArray frame;
+    reader.append("ye");
+    QVERIFY(!reader.next(&frame));
+    reader.append("s");
+    QVERIFY(reader.next(&frame));
+    QCOMPARE(frame, QByteArray("yes"));
+    QVERIFY(!reader.next(&frame));
+
+    // 后面紧跟 JSON 时裸文本到 '{' 为止
+    reader.append("n");
+    QVERIFY(!reader.next(&frame));
+    reader.append("o{\"status\": \"success\"}");
+    QVERIFY(reader.next(&frame));
+    QCOMPARE(frame, QByteArray("no"));
+    QVERIFY(reader.next(&frame));
+    QCOMPARE(frame, QByteArray("{\"status\": \"success\"}"));
+    QVERIFY(!reader.next(&frame));
+
+    // 不是 yes/no 的裸文本立即成帧，不能吞掉下一条回复
+    reader.append("error");
+    QVERIFY(reader.next(&frame));
+    QCOMPARE(frame, QByteArray("error"));
+    reader.append("yes");
+    QVERIFY(reader.next(&frame));
+    QCOMPARE(frame, QByteArray("yes"));
+    QVERIFY(!reader.next(&frame));
+}
+
+void UnitTests::typedEncodeMatchesQJson_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("plain") << "student01" << "student01";
+    QTest::newRow("empty") << QString() << QString();
+    QTest::newRow("quotes and backslashes") << "say \"hi\" C:\\dir\\ a/b" << "say \"hi\" C:\\dir\\ a/b";
+    const QString control = QString("a\nb\tc\rd\be\ff") + QChar(0x01) + QChar(0x1F) + QChar(0x7F);
+    QTest::newRow("control characters") << control << control;
+    QTest::newRow("cjk") << "计算机科学与技术（考研）" << "计算机科学与技术（考研）";
+    const QString emoji = QString::fromUtf8("\xF0\x9F\x98\x80 学习 \xF0\x9D\x84\x9E");
+    QTest::newRow("surrogate pairs") << emoji << emoji;
+    // 不成对的代理项无法编码为 UTF-8，写成 U+FFFD
+    QTest::newRow("lone high surrogate") << QString(QChar(0xD83D)) + "x"
+                                         << QString(QChar(QChar::ReplacementCharacter)) + "x";
+    QTest::newRow("lone low surrogate") << "x" + QString(QChar(0xDE00))
+                                        << "x" + QString(QChar(QChar::ReplacementCharacter));
+}
+
+void UnitTests::typedEncodeMatchesQJson()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, expected);
+
+    Messages::RegisterRequest request;
+    request.username = text;
+    request.password = text;
+    request.major = text;
+    request.role = "student";
+    const QByteArray data = Messages::encode(request);
+    QVERIFY(data.startsWith("{\"type\":\"" RegisterType "\""));
+
+    QJsonParseError error;
+    const QJsonObject json = QJsonDocument::fromJson(data, &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(json["type"].toString(), QString(RegisterType));
+    QCOMPARE(json["username"].toString(), expected);
+    QCOMPARE(json["password"].toString(), expected);
+    QCOMPARE(json["major"].toString(), expected);
+    QCOMPARE(json["email"].toString(), QString());
+    QCOMPARE(json["role"].toString(), QString("student"));
+
+    Messages::RegisterRequest decoded;
+    QVERIFY(Messages::decode(data, &decoded));
+    QCOMPARE(decoded.username, expected);
+
+    Messages::SaveKnowledgeRequest save;
+    save.username = "student01";
+    save.learningGoal = text;
+    save.knowledgePoints = QStringList{text, "C++", QString()};
+    save.knowledgeIds = KnowledgeCanon::canonicalIds(save.knowledgePoints);
+    const QJsonObject saveJson = QJsonDocument::fromJson(Messages::encode(save), &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(saveJson["learning_goal"].toString(), expected);
+    QCOMPARE(toStringList(saveJson["knowledge_points"]), (QStringList{expected, "C++", QString()}));
+    QCOMPARE(toStringList(saveJson["knowledge_ids"]), save.knowledgeIds);
+}
+
+void UnitTests::typedDecodeMatchesQJson_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("qt compact") << knowledgeResponse();
+    QJsonObject tricky;
+    tricky["type"] = "KnowledgeResponse";
+    tricky["status"] = "success";
+    tricky["message"] = QString("\"引号\" \\ / \n\t") + QChar(0x02);
+    tricky["learning_goal"] = QString::fromUtf8("考研 \xF0\x9F\x98\x80");
+    tricky["knowledge_points"] = QJsonArray{"C++", "数据结构", "a\"]}b"};
+    tricky["knowledge_ids"] = QJsonArray{"cpp"};
+    QTest::newRow("qt indented") << QJsonDocument(tricky).toJson(QJsonDocument::Indented);
+    QTest::newRow("unicode escapes")
+        << QByteArray(R"({"type":"KnowledgeResponse","status":"success","message":"\u8003\u7814 \"q\" \\ \/ \n\t\u0001",)"
+                      R"("learning_goal":"\ud83d\ude00\u00e9","knowledge_points":["\u6570\u636e","a"],"knowledge_ids":[]})");
+    QTest::newRow("unknown nested fields")
+        << QByteArray(R"({"extra":{"a":[1,{"b":"]}\""}],"c":null},"type":"KnowledgeResponse","n":-1.5e3,)"
+                      R"("status":"success","list":[[],[{}]],"knowledge_points":["x"],"flag":false})");
+    QTest::newRow("null fields")
+        << QByteArray(R"({"type":"KnowledgeResponse","status":"success","learning_goal":null,)"
+                      R"("knowledge_points":null,"knowledge_ids":null,"message":null})");
+    QTest::newRow("mistyped fields")
+        << QByteArray(R"({"type":"KnowledgeResponse","status":1,"message":{"a":"b"},"learning_goal":[1],)"
+                      R"("knowledge_points":["a",1,null,true,{"x":"y"},"b"],"knowledge_ids":"cpp"})");
+    QTest::newRow("missing goal") << QByteArray(R"({"status":"error","message":"无数据","type":"KnowledgeResponse"})");
+    QTest::newRow("empty") << QByteArray(R"( { "type" : "KnowledgeResponse" } )");
+}
+
+void UnitTests::typedDecodeMatchesQJson()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError error;
+    const QJsonObject expected = QJsonDocument::fromJson(json, &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    Messages::KnowledgeResponse reply;
+    quint32 present = 0;
+    QVERIFY(Messages::decode(json, &reply, &present));
+    QCOMPARE(reply.status, expected["status"].toString());
+    QCOMPARE(reply.message, expected["message"].toString());
+    QCOMPARE(reply.learningGoal, expected["learning_goal"].toString());
+    QCOMPARE(reply.knowledgePoints, toStringList(expected["knowledge_points"]));
+    QCOMPARE(reply.knowledgeIds, toStringList(expected["knowledge_ids"]));
+
+    using Messages::fieldBit;
+    using Messages::KnowledgeResponse;
+    QCOMPARE(bool(present & fieldBit<KnowledgeResponse>("status")), expected.contains("status"));
+    QCOMPARE(bool(present & fieldBit<KnowledgeResponse>("learning_goal")), expected.contains("learning_goal"));
+    QCOMPARE(bool(present & fieldBit<KnowledgeResponse>("knowledge_points")), expected.contains("knowledge_points"));
+}
+
+void UnitTests::typedDecodeNumbers_data()
+{
+    QTest::addColumn<QByteArray>("code");
+
+    QTest::newRow("integer") << QByteArray("1001");
+    QTest::newRow("negative") << QByteArray("-7");
+    QTest::newRow("exponent") << QByteArray("1.001e3");
+    QTest::newRow("upper exponent") << QByteArray("1001E0");
+    QTest::newRow("negative exponent") << QByteArray("25e-1");
+    QTest::newRow("fraction") << QByteArray("2.0");
+    QTest::newRow("string") << QByteArray("\"1001\"");
+    QTest::newRow("null") << QByteArray("null");
+    QTest::newRow("bool") << QByteArray("true");
+}
+
+void UnitTests::typedDecodeNumbers()
+{
+    QFETCH(QByteArray, code);
+    const QByteArray json = R"({"type":"RegisterResponse","status":"error","code":)" + code + R"(,"message":"m"})";
+
+    const QJsonObject expected = QJsonDocument::fromJson(json).object();
+    QVERIFY(!expected.isEmpty());
+    Messages::RegisterResponse reply;
+    QVERIFY(Messages::decode(json, &reply));
+    QCOMPARE(reply.code, expected["code"].toInt());
+    QCOMPARE(reply.message, QString("m"));
+}
+
+void UnitTests::typedLoneSurrogates()
+{
+    // QJsonDocument 对不成对的 \uD800 的处理随 Qt 版本不同，这里只要求解码成功并替换为 U+FFFD
+    const QByteArray json = R"({"type":"KnowledgeResponse","learning_goal":"\ud800x","message":"y\udc00","status":"\ud83d"})";
+    Messages::KnowledgeResponse reply;
+    QVERIFY(Messages::decode(json, &reply));
+    const QChar replacement(QChar::ReplacementCharacter);
+    QCOMPARE(reply.learningGoal, QString(replacement) + "x");
+    QCOMPARE(reply.message, "y" + QString(replacement));
+    QCOMPARE(reply.status, QString(replacement));
+
+    // 不合法的 JSON 仍然失败
+    QVERIFY(!Messages::decode(QByteArray(R"({"type":"KnowledgeResponse","status":"\x"})"), &reply));
+    QVERIFY(!Messages::decode(QByteArray(R"({"type":"KnowledgeResponse","status":"ok")"), &reply));
+    QVERIFY(!Messages::decode(QByteArray(R"({"type":"KnowledgeResponse"} trailing)"), &reply));
+    QVERIFY(!Messages::decode(QByteArray(R"({"type":"RegisterResponse"})"), &reply));
+    QCOMPARE(Messages::typeOf(R"({"status":"ok","type":"KnowledgeResponse","message":)"), QString("KnowledgeResponse"));
+}
+
+void UnitTests::typedFieldBits()
+{
+    using Messages::fieldBit;
+    using Messages::KnowledgeResponse;
+    static_assert(fieldBit<KnowledgeResponse>("status") == 1u << 0, "字段表顺序");
+    static_assert(fieldBit<KnowledgeResponse>("learning_goal") == 1u << 2, "字段表顺序");
+    static_assert(fieldBit<KnowledgeResponse>("unknown") == 0, "不在字段表中");
+
+    Messages::KnowledgeResponse reply;
+    quint32 present = 0;
+    QVERIFY(Messages::decode(QByteArray(R"({"type":"KnowledgeResponse","learning_goal":"","knowledge_ids":[]})"),
+                             &reply, &present));
+    QCOMPARE(present, fieldBit<KnowledgeResponse>("learning_goal") | fieldBit<KnowledgeResponse>("knowledge_ids"));
+}
+
+#include "tst_unittests.moc"
@@ -0,0 +1,29 @@
+# 正确性测试：录制文件脱敏、JSON 分帧、类型化消息与 QJsonDocument 的一致性
+# 运行：
+#   ./smartlearn-unittests
+# 性能用例在 bench/microbench 中，这里只放断言结果的用例
+QT       = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = smartlearn-unittests
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../capture.cpp \
+    ../../jsonframereader.cpp \
+    ../../knowledgecanon.cpp \
+    ../../logger.cpp \
+    ../../messages.cpp \
+    tst_unittests.cpp
+
+HEADERS += \
+    ../../capture.h \
+    ../../config.h \
+    ../../jsonframereader.h \
+    ../../knowledgecanon.h \
+    ../../logger.h \
+    ../../messages.h \
+    ../../synonymtable.h
@@ -0,0 +1,162 @@
+#include "capture.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+const char Magic[] = "SLCAP001";
+const int MagicSize = 8;
+const int HeaderSize = MagicSize + 8;
+const int FrameHeaderSize = 1 + 4 + 4;
+const char PasswordKey[] = "\"password\"";
+const char Redacted[] = "***";
+
+bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+struct Recorder {
+    QFile file;
+    QElapsedTimer clock;
+    qint64 lastMicros = 0;
+};
+
+Recorder &recorder()
+{
+    static Recorder instance;
+    return instance;
+}
+
+}
+
+std::atomic<bool> Capture::detail::recording{false};
+
+bool Capture::start(const QString &path, QString *error)
+{
+    stop();
+
+    Recorder &r = recorder();
+    r.file.setFileName(path);
+    if (!r.file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("无法写入录制文件 %1: %2").arg(path, r.file.errorString());
+        return false;
+    }
+
+    uchar header[HeaderSize];
+    memcpy(header, Magic, MagicSize);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + MagicSize);
+    r.file.write(reinterpret_cast<const char *>(header), HeaderSize);
+
+    r.clock.start();
+    r.lastMicros = 0;
+    detail::recording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void Capture::stop()
+{
+    if (!isRecording()) {
+        return;
+    }
+    detail::recording.store(false, std::memory_order_relaxed);
+    recorder().file.close();
+}
+
+void Capture::detail::append(Direction direction, const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+
+    const QByteArray frame = direction == Sent ? redact(data) : data;
+
+    // 间隔超过 4 字节能表示的范围（约 71 分钟）时截断，回放时相当于跳过空闲
+    Recorder &r = recorder();
+    const qint64 micros = r.clock.nsecsElapsed() / 1000;
+    const quint32 delta = quint32(qMin<qint64>(micros - r.lastMicros, 0xFFFFFFFF));
+    r.lastMicros = micros;
+
+    uchar header[FrameHeaderSize];
+    header[0] = direction;
+    qToLittleEndian<quint32>(delta, header + 1);
+    qToLittleEndian<quint32>(quint32(frame.size()), header + 5);
+    r.file.write(reinterpret_cast<const char *>(header), FrameHeaderSize);
+    r.file.write(frame);
+}
+
+QByteArray Capture::redact(const QByteArray &data)
+{
+    int from = data.indexOf(PasswordKey);
+    if (from < 0) {
+        return data;
+    }
+
+    QByteArray out;
+    out.reserve(data.size());
+    int copied = 0;
+    const int size = data.size();
+    while (from >= 0) {
+        // 跳过键后的空白和冒号，只处理字符串值
+        int p = from + int(sizeof(PasswordKey)) - 1;
+        while (p < size && isSpace(data[p])) ++p;
+        if (p < size && data[p] == ':') {
+            ++p;
+            while (p < size && isSpace(data[p])) ++p;
+            if (p < size && data[p] == '"') {
+                int end = p + 1;
+                while (end < size && data[end] != '"') {
+                    end += data[end] == '\\' ? 2 : 1;
+                }
+                // 帧在字符串中间截断时一直替换到末尾
+                out.append(data.constData() + copied, p + 1 - copied);
+                out.append(Redacted);
+                copied = qMin(end, size);
+                p = copied;
+            }
+        }
+        from = data.indexOf(PasswordKey, p);
+    }
+    out.append(data.constData() + copied, size - copied);
+    return out;
+}
+
+bool Capture::load(const QString &path, QVector<Frame> *frames, qint64 *startMsecs, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开录制文件 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    const QByteArray content = file.readAll();
+    if (content.size() < HeaderSize || !content.startsWith(QByteArray(Magic, MagicSize))) {
+        if (error) *error = QString("%1 不是录制文件").arg(path);
+        return false;
+    }
+
+    const uchar *p = reinterpret_cast<const uchar *>(content.constData());
+    if (startMsecs) {
+        *startMsecs = qFromLittleEndian<qint64>(p + MagicSize);
+    }
+
+    frames->clear();
+    qint64 micros = 0;
+    qint64 offset = HeaderSize;
+    while (content.size() - offset >= FrameHeaderSize) {
+        const uchar *frame = p + offset;
+        const quint32 size = qFromLittleEndian<quint32>(frame + 5);
+        if (frame[0] > Received || content.size() - offset - FrameHeaderSize < qint64(size)) {
+            break;
+        }
+        micros += qFromLittleEndian<quint32>(frame + 1);
+        frames->append({Direction(frame[0]), micros,
+                        QByteArray(content.constData() + offset + FrameHeaderSize, int(size))});
+        offset += FrameHeaderSize + size;
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <atomic>
+
+// 与服务器之间收发数据的录制，供 tools/replay 回放
+// 文件格式（小端）：
+//   文件头  8 字节魔数 "SLCAP001"，8 字节开始录制时的 Unix 毫秒时间
+//   每帧    1 字节方向（0 客户端发出，1 客户端收到），4 字节距上一帧的微秒数，4 字节长度，数据
+// "帧" 是一次 write 或 readAll 的内容，与消息边界无关。
+// 发出的帧里 "password" 字段的值替换为 "***" 后才写入，录制文件可以随问题报告一起提交。
+// 未录制时每个调用点只多一次原子读。sent/received 只在界面线程调用（所有的收发都在界面线程）。
+namespace Capture {
+
+enum Direction : quint8 {
+    Sent = 0,
+    Received = 1
+};
+
+struct Frame {
+    Direction direction;
+    qint64 micros;                      // 距开始录制的微秒数
+    QByteArray data;
+};
+
+namespace detail {
+extern std::atomic<bool> recording;
+void append(Direction direction, const QByteArray &data);
+}
+
+inline bool isRecording()
+{
+    return detail::recording.load(std::memory_order_relaxed);
+}
+
+bool start(const QString &path, QString *error = nullptr);
+void stop();
+
+inline void sent(const QByteArray &data)
+{
+    if (isRecording()) detail::append(Sent, data);
+}
+
+inline void received(const QByteArray &data)
+{
+    if (isRecording()) detail::append(Received, data);
+}
+
+// 把 JSON 文本中所有 "password" 字段的字符串值替换为 "***"（包括批量请求里的）
+QByteArray redact(const QByteArray &data);
+
+// 读取整个录制文件；文件末尾不完整的帧（录制中途退出）被忽略
+bool load(const QString &path, QVector<Frame> *frames, qint64 *startMsecs = nullptr, QString *error = nullptr);
+
+}
+
+#endif // CAPTURE_H
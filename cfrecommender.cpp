@@ -0,0 +1,172 @@
+#include "cfrecommender.h"
+#include "knowledgecanon.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <algorithm>
+
+namespace {
+
+const quint32 ModelMagic = 0x534C4346;  // "SLCF"
+const quint32 ModelVersion = 1;
+
+}
+
+CfRecommender::CfRecommender()
+{
+}
+
+QString CfRecommender::key(const QString &name)
+{
+    return KnowledgeCanon::canonicalId(name);
+}
+
+bool CfRecommender::trainFromExport(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开学习记录 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    // 构建 学生 x 知识点 的 CSR 矩阵
+    std::vector<int> userOffsets(1, 0);
+    std::vector<int> userItems;
+    _names.clear();
+    _itemIds.clear();
+
+    std::vector<int> row;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        const QJsonArray points = QJsonDocument::fromJson(line).object()["knowledge_points"].toArray();
+        row.clear();
+        for (const QJsonValue &value : points) {
+            QString name = value.toString().trimmed();
+            QString k = key(name);
+            if (k.isEmpty()) continue;
+            auto it = _itemIds.constFind(k);
+            int item;
+            if (it == _itemIds.constEnd()) {
+                item = _names.size();
+                _itemIds.insert(k, item);
+                _names.append(KnowledgeCanon::displayName(name));
+            } else {
+                item = it.value();
+            }
+            row.push_back(item);
+        }
+        if (row.empty()) continue;
+
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        userItems.insert(userItems.end(), row.begin(), row.end());
+        userOffsets.push_back(int(userItems.size()));
+    }
+
+    if (_names.isEmpty()) {
+        if (error) *error = QString("学习记录 %1 为空").arg(path);
+        return false;
+    }
+
+    AlsModel::Options options;
+    _model.train(int(userOffsets.size()) - 1, _names.size(), userOffsets, userItems, options);
+    return true;
+}
+
+bool CfRecommender::save(const QString &path, QString *error) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = QString("无法保存推荐模型 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << ModelMagic << ModelVersion
+        << qint32(_model.factors()) << qint32(_model.itemCount())
+        << _model.regularization() << _model.alpha()
+        << _names;
+
+    const std::vector<float> &factors = _model.itemFactors();
+    for (float x : factors) {
+        out << x;
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+bool CfRecommender::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开推荐模型 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic = 0, version = 0;
+    qint32 factors = 0, itemCount = 0;
+    float regularization = 0, alpha = 0;
+    QStringList names;
+    in >> magic >> version >> factors >> itemCount >> regularization >> alpha >> names;
+    // 因子矩阵不能超过文件剩余的长度，损坏的文件不能让这里分配任意大的内存
+    const qint64 maxFloats = (file.size() - file.pos()) / qint64(sizeof(float));
+    if (magic != ModelMagic || version != ModelVersion || factors <= 0 || factors > maxFloats
+        || itemCount != names.size() || qint64(itemCount) * factors > maxFloats
+        || in.status() != QDataStream::Ok) {
+        if (error) *error = QString("推荐模型 %1 格式错误").arg(path);
+        return false;
+    }
+
+    std::vector<float> itemFactors(size_t(itemCount) * factors);
+    for (float &x : itemFactors) {
+        in >> x;
+    }
+    if (in.status() != QDataStream::Ok) {
+        if (error) *error = QString("推荐模型 %1 数据不完整").arg(path);
+        return false;
+    }
+
+    _names = names;
+    _itemIds.clear();
+    for (int i = 0; i < _names.size(); ++i) {
+        _itemIds.insert(key(_names[i]), i);
+    }
+    _model.setModel(factors, itemCount, regularization, alpha, std::move(itemFactors));
+    return true;
+}
+
+QStringList CfRecommender::suggest(const QStringList &knownPoints, int count) const
+{
+    QStringList result;
+    if (!isReady()) {
+        return result;
+    }
+
+    std::vector<int> known;
+    known.reserve(knownPoints.size());
+    for (const QString &point : knownPoints) {
+        auto it = _itemIds.constFind(key(point));
+        if (it != _itemIds.constEnd()) {
+            known.push_back(it.value());
+        }
+    }
+    // 新同学没有任何可识别的知识点时，因子向量为零，推荐没有意义
+    if (known.empty()) {
+        return result;
+    }
+
+    const std::vector<float> user = _model.foldIn(known.data(), int(known.size()));
+    const auto ranked = _model.recommend(user, known.data(), int(known.size()), count);
+    for (const auto &entry : ranked) {
+        result.append(_names[entry.first]);
+    }
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef CFRECOMMENDER_H
+#define CFRECOMMENDER_H
+
+#include "alsmodel.h"
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+// “学了这些的同学接下来学了什么”
+// 从匿名导出的学生知识库（每行 {"knowledge_points": [...]}）训练 ALS 模型，
+// 服务时根据当前学生已掌握的知识点即时求解其因子向量并给出推荐
+class CfRecommender
+{
+public:
+    CfRecommender();
+
+    bool trainFromExport(const QString &path, QString *error = nullptr);
+    bool save(const QString &path, QString *error = nullptr) const;
+    bool load(const QString &path, QString *error = nullptr);
+
+    bool isReady() const { return _model.itemCount() > 0; }
+    int itemCount() const { return _model.itemCount(); }
+
+    // 推荐 count 个尚未掌握的知识点
+    QStringList suggest(const QStringList &knownPoints, int count) const;
+
+private:
+    AlsModel _model;
+    QStringList _names;                 // 知识点显示名称
+    QHash<QString, int> _itemIds;       // 规范 id -> 下标
+
+    static QString key(const QString &name);
+};
+
+#endif // CFRECOMMENDER_H
@@ -0,0 +1,278 @@
+#include "chathistory.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace {
+
+const int HeaderSize = 16;
+const int MaxSegmentMessages = 16384;
+const qint64 MaxSegmentBytes = 32 * 1024 * 1024;
+
+}
+
+ChatHistory::ChatHistory()
+    : _count(0)
+{
+}
+
+ChatHistory::~ChatHistory()
+{
+    close();
+}
+
+void ChatHistory::close()
+{
+    qDeleteAll(_segments);          // QFile 析构时自动解除映射
+    _segments.clear();
+    _count = 0;
+}
+
+bool ChatHistory::open(const QString &dir, QString *error)
+{
+    close();
+    _dir = dir;
+    if (!QDir().mkpath(dir)) {
+        if (error) *error = QString("无法创建目录 %1").arg(dir);
+        return false;
+    }
+
+    // 文件名是零填充的序号，按名字排序即按消息顺序
+    const QStringList logs = QDir(dir).entryList(QStringList() << "*.log", QDir::Files, QDir::Name);
+    for (int i = 0; i < logs.size(); ++i) {
+        const QString baseName = logs[i].chopped(4);
+        bool ok = false;
+        int first = baseName.toInt(&ok);
+        if (!ok || first != _count) {
+            if (error) *error = QString("对话记录分段 %1 不连续").arg(logs[i]);
+            close();
+            return false;
+        }
+        if (!openSegment(baseName, first, i == logs.size() - 1, error)) {
+            close();
+            return false;
+        }
+    }
+
+    return _segments.isEmpty() ? startSegment(error) : true;
+}
+
+bool ChatHistory::openSegment(const QString &baseName, int first, bool active, QString *error)
+{
+    Segment *segment = new Segment;
+    segment->first = first;
+    segment->log.setFileName(QDir(_dir).filePath(baseName + ".log"));
+    segment->idx.setFileName(QDir(_dir).filePath(baseName + ".idx"));
+
+    const QIODevice::OpenMode mode = active ? QIODevice::ReadWrite : QIODevice::ReadOnly;
+    if (!segment->log.open(mode) || !segment->idx.open(mode)) {
+        if (error) *error = QString("打开对话记录 %1 失败: %2").arg(baseName, segment->log.errorString());
+        delete segment;
+        return false;
+    }
+
+    int count = int(segment->idx.size() / 4);
+    if (active) {
+        // 正在写入的分段：偏移表读入内存，并丢弃上次异常退出时写了一半的记录
+        const QByteArray idxData = segment->idx.read(qint64(count) * 4);
+        segment->offsets.resize(count);
+        for (int i = 0; i < count; ++i) {
+            segment->offsets[i] = qFromLittleEndian<quint32>(idxData.constData() + i * 4);
+        }
+
+        const qint64 logSize = segment->log.size();
+        qint64 validEnd = 0;
+        while (count > 0) {
+            const quint32 offset = segment->offsets[count - 1];
+            uchar header[4];
+            if (qint64(offset) + HeaderSize <= logSize && segment->log.seek(offset)
+                && segment->log.read(reinterpret_cast<char *>(header), 4) == 4) {
+                const qint64 end = qint64(offset) + HeaderSize + qFromLittleEndian<quint32>(header);
+                if (end <= logSize) {
+                    validEnd = end;
+                    break;
+                }
+            }
+            --count;
+        }
+        segment->offsets.resize(count);
+        segment->log.resize(validEnd);
+        segment->idx.resize(qint64(count) * 4);
+        segment->log.seek(validEnd);
+        segment->idx.seek(qint64(count) * 4);
+    } else if (count > 0) {
+        segment->idxMap = segment->idx.map(0, qint64(count) * 4);
+        segment->logMapSize = segment->log.size();
+        segment->logMap = segment->log.map(0, segment->logMapSize);
+        if (!segment->idxMap || !segment->logMap) {
+            if (error) *error = QString("映射对话记录 %1 失败").arg(baseName);
+            delete segment;
+            return false;
+        }
+    }
+
+    segment->count = count;
+    _segments.append(segment);
+    _count += count;
+    return true;
+}
+
+bool ChatHistory::startSegment(QString *error)
+{
+    return openSegment(QString("%1").arg(_count, 8, 10, QChar('0')), _count, true, error);
+}
+
+// 写满的分段重新以只读映射打开；失败时恢复为正在写入的分段，已有的记录仍可读取
+bool ChatHistory::sealActive(QString *error)
+{
+    Segment *active = _segments.takeLast();
+    const QString baseName = QFileInfo(active->log.fileName()).completeBaseName();
+    const int first = active->first;
+    _count -= active->count;
+    delete active;
+    if (openSegment(baseName, first, false, error)) {
+        return true;
+    }
+    openSegment(baseName, first, true, nullptr);
+    return false;
+}
+
+bool ChatHistory::append(Role role, const QString &text, qint64 timestamp, QString *error)
+{
+    if (_segments.isEmpty()) {
+        if (error) *error = "对话记录未打开";
+        return false;
+    }
+
+    Segment *active = _segments.last();
+    if (active->count >= MaxSegmentMessages || active->log.size() >= MaxSegmentBytes) {
+        if (!sealActive(error) || !startSegment(error)) {
+            return false;
+        }
+        active = _segments.last();
+    }
+
+    const QByteArray utf8 = text.toUtf8();
+    uchar header[HeaderSize] = {};
+    qToLittleEndian<quint32>(quint32(utf8.size()), header);
+    header[4] = role;
+    qToLittleEndian<qint64>(timestamp, header + 8);
+
+    const qint64 offset = active->log.size();
+    uchar entry[4];
+    qToLittleEndian<quint32>(quint32(offset), entry);
+
+    // 先写记录再写偏移，任何一步失败都回退到写入前的状态
+    bool ok = active->log.write(reinterpret_cast<const char *>(header), HeaderSize) == HeaderSize
+              && active->log.write(utf8) == utf8.size()
+              && active->log.flush()
+              && active->idx.write(reinterpret_cast<const char *>(entry), 4) == 4
+              && active->idx.flush();
+    if (!ok) {
+        if (error) *error = QString("写入对话记录失败: %1").arg(active->log.errorString());
+        active->log.resize(offset);
+        active->idx.resize(qint64(active->count) * 4);
+        active->log.seek(offset);
+        active->idx.seek(qint64(active->count) * 4);
+        return false;
+    }
+
+    active->offsets.append(quint32(offset));
+    active->count++;
+    _count++;
+    return true;
+}
+
+int ChatHistory::findSegment(int index) const
+{
+    auto it = std::upper_bound(_segments.constBegin(), _segments.constEnd(), index,
+                               [](int value, const Segment *segment) { return value < segment->first; });
+    return int(it - _segments.constBegin()) - 1;
+}
+
+const uchar *ChatHistory::record(int index, quint32 *length) const
+{
+    if (index < 0 || index >= _count) {
+        return nullptr;
+    }
+
+    Segment *segment = _segments[findSegment(index)];
+    const int local = index - segment->first;
+    const quint32 offset = segment->idxMap
+                               ? qFromLittleEndian<quint32>(segment->idxMap + qint64(local) * 4)
+                               : segment->offsets[local];
+
+    // 正在写入的分段在追加后变长，记录超出当前映射范围时重新映射
+    if (!segment->idxMap) {
+        const qint64 end = local + 1 < segment->count ? qint64(segment->offsets[local + 1])
+                                                      : segment->log.size();
+        if (end > segment->logMapSize) {
+            if (segment->logMap) {
+                segment->log.unmap(segment->logMap);
+            }
+            segment->logMapSize = segment->log.size();
+            segment->logMap = segment->log.map(0, segment->logMapSize);
+            if (!segment->logMap) {
+                segment->logMapSize = 0;
+                return nullptr;
+            }
+        }
+    }
+    if (quint64(offset) + HeaderSize > quint64(segment->logMapSize)) {
+        return nullptr;
+    }
+
+    const uchar *p = segment->logMap + offset;
+    *length = qFromLittleEndian<quint32>(p);
+    if (quint64(offset) + HeaderSize + *length > quint64(segment->logMapSize)) {
+        return nullptr;
+    }
+    return p;
+}
+
+ChatHistory::Message ChatHistory::message(int index) const
+{
+    Message message = { User, 0, QString() };
+    quint32 length = 0;
+    const uchar *p = record(index, &length);
+    if (p) {
+        message.role = Role(p[4]);
+        message.timestamp = qFromLittleEndian<qint64>(p + 8);
+        message.text = QString::fromUtf8(reinterpret_cast<const char *>(p + HeaderSize), int(length));
+    }
+    return message;
+}
+
+QString ChatHistory::preview(int index, int maxChars) const
+{
+    quint32 length = 0;
+    const uchar *p = record(index, &length);
+    if (!p) {
+        return QString();
+    }
+
+    // 每个字符最多 4 字节，解码 4 * maxChars 字节足够得到 maxChars 个完整字符
+    const int bytes = int(qMin<quint32>(length, quint32(maxChars) * 4));
+    QString text = QString::fromUtf8(reinterpret_cast<const char *>(p + HeaderSize), bytes);
+    bool truncated = bytes < int(length) || text.size() > maxChars;
+    text.truncate(maxChars);
+    text.replace(QLatin1Char('\n'), QLatin1Char(' '));
+    return truncated ? text + QStringLiteral("…") : text;
+}
+
+ChatHistory::Role ChatHistory::role(int index) const
+{
+    quint32 length = 0;
+    const uchar *p = record(index, &length);
+    return p ? Role(p[4]) : User;
+}
+
+qint64 ChatHistory::timestamp(int index) const
+{
+    quint32 length = 0;
+    const uchar *p = record(index, &length);
+    return p ? qFromLittleEndian<qint64>(p + 8) : 0;
+}
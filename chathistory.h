@@ -0,0 +1,71 @@
+#ifndef CHATHISTORY_H
+#define CHATHISTORY_H
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+
+// AI 对话记录的只追加存储
+// 记录按条数切分为多个分段，文件名是该分段第一条消息的序号：
+//   00000000.log  消息记录，每条为 { uint32 len; uint8 role; uint8 reserved[3]; int64 time_ms; char text[len] (UTF-8) }
+//   00000000.idx  每条消息在 .log 中的偏移（uint32 小端）
+// 已写满的分段只读内存映射，打开历史时只读取文件大小，耗时和内存与消息总数无关；
+// 正在写入的分段在内存中保留偏移表（最多 MaxSegmentMessages 项）。
+// 写入顺序为先 .log 后 .idx，打开时丢弃最后一个分段中不完整的记录。
+class ChatHistory
+{
+public:
+    enum Role : quint8 {
+        User = 0,
+        Assistant = 1
+    };
+
+    struct Message {
+        Role role;
+        qint64 timestamp;               // 毫秒时间戳
+        QString text;
+    };
+
+    ChatHistory();
+    ~ChatHistory();
+
+    bool open(const QString &dir, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return !_segments.isEmpty(); }
+
+    int count() const { return _count; }
+    bool append(Role role, const QString &text, qint64 timestamp, QString *error = nullptr);
+
+    Message message(int index) const;
+    // 只解码开头的 maxChars 个字符，换行替换为空格，用于列表显示
+    QString preview(int index, int maxChars) const;
+    Role role(int index) const;
+    qint64 timestamp(int index) const;
+
+private:
+    Q_DISABLE_COPY(ChatHistory)
+
+    struct Segment {
+        int first;                      // 第一条消息的序号
+        int count;
+        QFile log;
+        QFile idx;
+        uchar *logMap;
+        qint64 logMapSize;
+        const uchar *idxMap;            // 已写满的分段
+        QVector<quint32> offsets;       // 正在写入的分段
+        Segment() : first(0), count(0), logMap(nullptr), logMapSize(0), idxMap(nullptr) {}
+    };
+
+    QString _dir;
+    QVector<Segment *> _segments;
+    int _count;
+
+    bool openSegment(const QString &baseName, int first, bool active, QString *error);
+    bool startSegment(QString *error);
+    bool sealActive(QString *error);
+    int findSegment(int index) const;
+    const uchar *record(int index, quint32 *length) const;
+};
+
+#endif // CHATHISTORY_H
@@ -0,0 +1,64 @@
+#include "chathistorymodel.h"
+
+#include <QDateTime>
+#include <QColor>
+
+namespace {
+
+const int PreviewChars = 120;           // 列表中每条消息显示的字符数
+const int ToolTipChars = 1000;
+
+}
+
+ChatHistoryModel::ChatHistoryModel(ChatHistory *history, QObject *parent)
+    : QAbstractListModel(parent)
+    , _history(history)
+    , _rows(history->count())
+{
+}
+
+int ChatHistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _rows;
+}
+
+QVariant ChatHistoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _rows) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole: {
+        const bool fromUser = _history->role(row) == ChatHistory::User;
+        const QString time = QDateTime::fromMSecsSinceEpoch(_history->timestamp(row)).toString("MM-dd hh:mm");
+        return QString("%1  %2：%3").arg(time, fromUser ? "我" : "AI", _history->preview(row, PreviewChars));
+    }
+    case Qt::ToolTipRole:
+        return _history->preview(row, ToolTipChars);
+    case Qt::ForegroundRole:
+        return _history->role(row) == ChatHistory::User ? QColor("#2c3e50") : QColor("#2980b9");
+    case FullTextRole:
+        return _history->message(row).text;
+    case SenderRole:
+        return int(_history->role(row));
+    case TimestampRole:
+        return _history->timestamp(row);
+    default:
+        return QVariant();
+    }
+}
+
+bool ChatHistoryModel::appendMessage(ChatHistory::Role sender, const QString &text, QString *error)
+{
+    if (!_history->append(sender, text, QDateTime::currentMSecsSinceEpoch(), error)) {
+        return false;
+    }
+
+    // 行数单独记录，保证 beginInsertRows 之前视图看到的仍是旧行数
+    beginInsertRows(QModelIndex(), _rows, _rows);
+    _rows++;
+    endInsertRows();
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef CHATHISTORYMODEL_H
+#define CHATHISTORYMODEL_H
+
+#include "chathistory.h"
+
+#include <QAbstractListModel>
+
+// 对话记录的列表模型
+// 数据直接从 ChatHistory 的内存映射中读取，不缓存消息；配合 setUniformItemSizes 的 QListView，
+// 视图只为可见行调用 data()，十万条记录也能立即打开
+class ChatHistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        FullTextRole = Qt::UserRole + 1,    // 完整消息文本
+        SenderRole,                         // ChatHistory::Role
+        TimestampRole                       // 毫秒时间戳
+    };
+
+    explicit ChatHistoryModel(ChatHistory *history, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    bool appendMessage(ChatHistory::Role sender, const QString &text, QString *error = nullptr);
+
+private:
+    ChatHistory *_history;
+    int _rows;
+};
+
+#endif // CHATHISTORYMODEL_H
@@ -0,0 +1,390 @@
+#include "chatpage.h"
+#include "connectmanager.h"
+#include "config.h"
+#include "tracer.h"
+#include "logger.h"
+#include "metrics.h"
+#include "capture.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QScrollBar>
+#include <QSplitter>
+#include <QStandardPaths>
+#include <QUrl>
+#include <QTextCursor>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+namespace {
+
+const int FlushIntervalMs = 16;         // 约 60 fps
+const int StreamTimeoutMs = 30000;      // 30 秒没有新片段视为超时
+
+}
+
+ChatPage::ChatPage(const QString &username, QWidget *parent)
+    : QWidget(parent)
+    , _username(username)
+    , _streaming(false)
+    , _requestId(0)
+    , _chunkCount(0)
+    , _firstChunkMs(-1)
+    , _historyModel(nullptr)
+    , _answerCache(ANSWER_CACHE_BYTES, ANSWER_CACHE_TTL_SEC)
+{
+    openHistory();
+    setupUI();
+
+    ConnectManager &manager = ConnectManager::getInstance();
+    _client = manager.getSocket();
+
+    _flushTimer.setInterval(FlushIntervalMs);
+    connect(&_flushTimer, &QTimer::timeout, this, &ChatPage::flushPending);
+
+    _timeoutTimer.setSingleShot(true);
+    _timeoutTimer.setInterval(StreamTimeoutMs);
+    connect(&_timeoutTimer, &QTimer::timeout, this, &ChatPage::onStreamTimeout);
+}
+
+ChatPage::~ChatPage()
+{
+    if (_client) {
+        disconnect(_client, &QTcpSocket::readyRead, this, &ChatPage::SlotReadFromServer);
+    }
+}
+
+void ChatPage::setupUI()
+{
+    setStyleSheet("background-color: white; border-radius: 10px;");
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(30, 30, 30, 30);
+    layout->setSpacing(15);
+
+    QLabel *title = new QLabel("AI 学习助手", this);
+    title->setStyleSheet("font-size: 24px; font-weight: bold; color: #2c3e50;");
+    layout->addWidget(title);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->setChildrenCollapsible(false);
+
+    // 所有行高度相同，视图不必逐行测量，只为可见行取数据
+    _history_list = new QListView(splitter);
+    _history_list->setModel(_historyModel);
+    _history_list->setUniformItemSizes(true);
+    _history_list->setWordWrap(false);
+    _history_list->setTextElideMode(Qt::ElideRight);
+    _history_list->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    _history_list->setStyleSheet(
+        "QListView {"
+        "   border: 1px solid #ddd;"
+        "   border-radius: 8px;"
+        "   padding: 5px;"
+        "   font-size: 13px;"
+        "}"
+        "QListView::item { padding: 4px; }"
+        "QListView::item:selected { background-color: #e3f2fd; }"
+    );
+    _history_list->scrollToBottom();
+    connect(_history_list, &QListView::activated, this, &ChatPage::onHistoryActivated);
+
+    _transcript = new QPlainTextEdit(splitter);
+    _transcript->setReadOnly(true);
+    _transcript->setUndoRedoEnabled(false);    // 追加大量文本时不保留撤销记录
+    _transcript->setPlaceholderText("向 AI 提问，例如：我学完了 C++ 基础，接下来该学什么？");
+    _transcript->setStyleSheet(
+        "QPlainTextEdit {"
+        "   border: 1px solid #ddd;"
+        "   border-radius: 8px;"
+        "   background-color: #f8f9fa;"
+        "   padding: 10px;"
+        "   color: #2c3e50;"
+        "   font-size: 14px;"
+        "}"
+    );
+    splitter->addWidget(_history_list);
+    splitter->addWidget(_transcript);
+    splitter->setStretchFactor(0, 1);
+    splitter->setStretchFactor(1, 2);
+    layout->addWidget(splitter, 1);
+
+    _stats_label = new QLabel("", this);
+    _stats_label->setStyleSheet("color: #95a5a6; font-size: 12px;");
+    layout->addWidget(_stats_label);
+
+    QHBoxLayout *inputLayout = new QHBoxLayout();
+    _input_edit = new QLineEdit(this);
+    _input_edit->setPlaceholderText("输入你的问题，按回车发送");
+    _input_edit->setStyleSheet(
+        "padding: 10px; border: 2px solid #ddd; border-radius: 6px; font-size: 14px;"
+    );
+
+    _send_btn = new QPushButton("发送", this);
+    _send_btn->setMinimumWidth(90);
+    _send_btn->setStyleSheet(R"(
+        QPushButton {
+            background-color: #3498db;
+            color: white;
+            border: none;
+            padding: 10px 20px;
+            border-radius: 6px;
+            font-size: 14px;
+            font-weight: bold;
+        }
+        QPushButton:hover {
+            background-color: #2980b9;
+        }
+        QPushButton:disabled {
+            background-color: #cccccc;
+            color: #666666;
+        }
+    )");
+
+    inputLayout->addWidget(_input_edit);
+    inputLayout->addWidget(_send_btn);
+    layout->addLayout(inputLayout);
+
+    connect(_send_btn, &QPushButton::clicked, this, &ChatPage::onSend);
+    connect(_input_edit, &QLineEdit::returnPressed, this, &ChatPage::onSend);
+}
+
+void ChatPage::openHistory()
+{
+    // 每个用户一个目录，用户名编码后作为目录名
+    QString user = _username.isEmpty() ? QString("anonymous") : _username;
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                  + "/" + CHAT_HISTORY_DIR + "/" + QString::fromLatin1(QUrl::toPercentEncoding(user));
+
+    QString error;
+    if (!_history.open(dir, &error)) {
+        LOG_WARNING() << "ChatPage: 打开对话记录失败:" << error;
+    } else {
+        LOG_DEBUG() << "ChatPage: 已打开对话记录，共" << _history.count() << "条消息";
+    }
+    _historyModel = new ChatHistoryModel(&_history, this);
+}
+
+void ChatPage::appendToHistory(ChatHistory::Role sender, const QString &text)
+{
+    QScrollBar *bar = _history_list->verticalScrollBar();
+    bool atBottom = bar->value() >= bar->maximum() - 4;
+
+    QString error;
+    if (!_historyModel->appendMessage(sender, text, &error)) {
+        LOG_WARNING() << "ChatPage:" << error;
+        return;
+    }
+    if (atBottom) {
+        _history_list->scrollToBottom();
+    }
+}
+
+void ChatPage::onHistoryActivated(const QModelIndex &index)
+{
+    if (_streaming || !index.isValid()) {
+        return;
+    }
+    _transcript->setPlainText(index.data(ChatHistoryModel::FullTextRole).toString());
+}
+
+void ChatPage::setKnowledgeContext(const QStringList &knowledgePoints)
+{
+    _knowledgePoints = knowledgePoints;
+}
+
+void ChatPage::onSend()
+{
+    QString question = _input_edit->text().trimmed();
+    if (question.isEmpty() || _streaming) {
+        return;
+    }
+
+    // 相同问题 + 相同知识库直接使用缓存的回答，不占用网络
+    _requestKey = AnswerCache::makeKey(question, _knowledgePoints);
+    QString cached;
+    static Metrics::Counter &cacheHits = Metrics::counter("cache.answer.hits");
+    static Metrics::Counter &cacheMisses = Metrics::counter("cache.answer.misses");
+    if (_answerCache.lookup(_requestKey, &cached)) {
+        cacheHits.add();
+        _input_edit->clear();
+        appendToTranscript(QString("%1我：%2\n\nAI：%3")
+                               .arg(_transcript->document()->isEmpty() ? "" : "\n\n", question, cached));
+        appendToHistory(ChatHistory::User, question);
+        appendToHistory(ChatHistory::Assistant, cached);
+        _stats_label->setText(QString("来自缓存，%1").arg(cacheSummary()));
+        return;
+    }
+    cacheMisses.add();
+
+    if (_client->state() != QAbstractSocket::ConnectedState) {
+        LOG_DEBUG() << "ChatPage: Socket未连接，尝试重新连接";
+        _client->abort();
+        _client->connectToHost(HOSTNAME, PORT);
+        if (!_client->waitForConnected(3000)) {
+            _stats_label->setText("无法连接到服务器");
+            return;
+        }
+    }
+
+    // 回答期间由本页面独占 readyRead
+    disconnect(_client, &QTcpSocket::readyRead, nullptr, nullptr);
+    connect(_client, &QTcpSocket::readyRead, this, &ChatPage::SlotReadFromServer);
+    _reader.clear();
+
+    _input_edit->clear();
+    _send_btn->setEnabled(false);
+    appendToTranscript(QString("%1我：%2\n\nAI：")
+                           .arg(_transcript->document()->isEmpty() ? "" : "\n\n", question));
+
+    _streaming = true;
+    _requestId++;
+    _chunkCount = 0;
+    _firstChunkMs = -1;
+    _pending.clear();
+    _answer.clear();
+    appendToHistory(ChatHistory::User, question);
+
+    QJsonObject json;
+    json["type"] = ChatType;
+    json["id"] = _requestId;
+    json["username"] = _username;
+    json["question"] = question;
+    json["knowledge_points"] = QJsonArray::fromStringList(_knowledgePoints);
+
+    _requestTimer.start();
+    _roundTrip.reset(new Metrics::RoundTrip(ChatType));    // 往返时间即首字延迟
+    {
+        TRACE_SCOPE("json.encode");
+        const QByteArray request = QJsonDocument(json).toJson(QJsonDocument::Compact);
+        Capture::sent(request);
+        _roundTrip->sent(_client->write(request));
+    }
+    _client->flush();
+
+    _stats_label->setText("等待回答...");
+    _flushTimer.start();
+    _timeoutTimer.start();
+}
+
+void ChatPage::SlotReadFromServer()
+{
+    TRACE_SCOPE("ChatPage::SlotReadFromServer");
+    const QByteArray data = _client->readAll();
+    Capture::received(data);
+    if (_roundTrip) {
+        _roundTrip->received(data.size());
+    }
+    _reader.append(data);
+
+    QByteArray frame;
+    while (_reader.next(&frame)) {
+        QJsonDocument doc;
+        {
+            TRACE_SCOPE("json.parse");
+            doc = QJsonDocument::fromJson(frame);
+        }
+        if (!doc.isObject()) continue;
+
+        QJsonObject json = doc.object();
+        if (json["type"].toString() != "ChatChunk" || json["id"].toInt() != _requestId) {
+            continue;   // 其他页面的响应或上一轮的残留片段
+        }
+
+        if (_firstChunkMs < 0) {
+            _firstChunkMs = _requestTimer.elapsed();
+            _stats_label->setText(QString("首字延迟 %1 ms").arg(_firstChunkMs));
+        }
+
+        if (json["status"].toString() == "error") {
+            finishStream(json["message"].toString());
+            return;
+        }
+
+        const QString delta = json["delta"].toString();
+        _pending += delta;
+        _answer += delta;
+        _chunkCount++;
+        _timeoutTimer.start();
+
+        if (json["done"].toBool()) {
+            finishStream();
+            return;
+        }
+    }
+}
+
+void ChatPage::flushPending()
+{
+    if (_pending.isEmpty()) {
+        return;
+    }
+    appendToTranscript(_pending);
+    _pending.clear();
+}
+
+void ChatPage::appendToTranscript(const QString &text)
+{
+    // 只有用户停留在底部时才自动滚动
+    QScrollBar *bar = _transcript->verticalScrollBar();
+    bool atBottom = bar->value() >= bar->maximum() - 4;
+
+    QTextCursor cursor(_transcript->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text);
+
+    if (atBottom) {
+        bar->setValue(bar->maximum());
+    }
+}
+
+void ChatPage::onStreamTimeout()
+{
+    finishStream("服务器长时间无响应");
+}
+
+void ChatPage::finishStream(const QString &error)
+{
+    flushPending();
+    _flushTimer.stop();
+    _timeoutTimer.stop();
+    _streaming = false;
+    _roundTrip.reset();                 // 没有收到任何片段的计为超时
+    _send_btn->setEnabled(true);
+    _input_edit->setFocus();
+
+    disconnect(_client, &QTcpSocket::readyRead, this, &ChatPage::SlotReadFromServer);
+
+    // 中断的回答也保留已收到的部分，但只缓存完整的回答
+    if (!_answer.isEmpty()) {
+        appendToHistory(ChatHistory::Assistant, _answer);
+        if (error.isEmpty()) {
+            _answerCache.insert(_requestKey, _answer);
+        }
+        _answer.clear();
+    }
+
+    if (!error.isEmpty()) {
+        appendToTranscript(QString("[%1]").arg(error));
+        _stats_label->setText(error);
+    } else {
+        _stats_label->setText(QString("首字延迟 %1 ms，共 %2 个片段，总耗时 %3 ms；%4")
+                                  .arg(_firstChunkMs)
+                                  .arg(_chunkCount)
+                                  .arg(_requestTimer.elapsed())
+                                  .arg(cacheSummary()));
+    }
+    emit streamFinished();
+}
+
+QString ChatPage::cacheSummary() const
+{
+    const AnswerCache::Stats stats = _answerCache.stats();
+    return QString("缓存命中率 %1%（%2/%3），%4 条 %5 KB")
+        .arg(stats.hitRate() * 100.0, 0, 'f', 1)
+        .arg(stats.hits)
+        .arg(stats.hits + stats.misses)
+        .arg(stats.entries)
+        .arg(stats.bytes / 1024);
+}
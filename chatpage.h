@@ -0,0 +1,87 @@
+#ifndef CHATPAGE_H
+#define CHATPAGE_H
+
+#include "jsonframereader.h"
+#include "chathistory.h"
+#include "chathistorymodel.h"
+#include "answercache.h"
+#include "metrics.h"
+
+#include <QWidget>
+#include <QTcpSocket>
+#include <QPlainTextEdit>
+#include <QListView>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QLabel>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+
+// AI 学习助手页面
+// 回答以 ChatChunk 消息流式返回；收到的片段先缓存，每帧（约 16 ms）最多向文档末尾追加一次，
+// 只会对末尾段落重新排版，长回答时界面依然流畅。
+// 完成的问答写入 ChatHistory，历史记录在上方的虚拟化列表中显示，双击查看全文；
+// 完整的回答同时放入 AnswerCache，重复的问题不再请求服务器
+class ChatPage : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ChatPage(const QString &username, QWidget *parent = nullptr);
+    ~ChatPage();
+
+    void setKnowledgeContext(const QStringList &knowledgePoints);  // 提问时附带的知识库
+    bool isStreaming() const { return _streaming; }  // 回答期间 socket 的 readyRead 由本页面独占
+
+signals:
+    void streamFinished();              // 回答结束（包括出错和超时），socket 可以交给其他页面
+
+private slots:
+    void onSend();                      // 发送问题
+    void SlotReadFromServer();          // 接收回答片段
+    void flushPending();                // 把缓存的片段追加到文档
+    void onStreamTimeout();             // 长时间没有收到片段
+    void onHistoryActivated(const QModelIndex &index);  // 查看历史消息全文
+
+private:
+    QString _username;
+    QStringList _knowledgePoints;
+    QTcpSocket *_client;
+    JsonFrameReader _reader;
+
+    // UI 组件
+    QListView *_history_list;           // 历史消息
+    QPlainTextEdit *_transcript;        // 当前对话
+    QLineEdit *_input_edit;             // 问题输入框
+    QPushButton *_send_btn;             // 发送按钮
+    QLabel *_stats_label;               // 首字延迟等统计
+
+    // 当前回答的流式状态
+    bool _streaming;
+    int _requestId;
+    int _chunkCount;
+    qint64 _firstChunkMs;               // 首字延迟，-1 表示尚未收到
+    QString _pending;                   // 尚未显示的片段
+    QString _answer;                    // 当前回答的全文，结束后写入历史
+    QElapsedTimer _requestTimer;
+    QScopedPointer<Metrics::RoundTrip> _roundTrip;   // 当前回答的网络指标
+    QTimer _flushTimer;
+    QTimer _timeoutTimer;
+
+    // 对话历史
+    ChatHistory _history;
+    ChatHistoryModel *_historyModel;
+
+    AnswerCache _answerCache;
+    AnswerCache::Key _requestKey;       // 当前问题的缓存键
+
+    void setupUI();
+    void openHistory();
+    void appendToHistory(ChatHistory::Role sender, const QString &text);
+    QString cacheSummary() const;
+    void appendToTranscript(const QString &text);
+    void finishStream(const QString &error = QString());
+};
+
+#endif // CHATPAGE_H
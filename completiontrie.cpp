@@ -0,0 +1,250 @@
+#include "completiontrie.h"
+
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char Magic[8] = {'S', 'L', 'T', 'R', 'I', 'E', '0', '1'};
+const int HeaderSize = 40;
+const int NodeSize = 12;
+const int EdgeSize = 12;
+const int EntrySize = 16;
+
+inline quint32 u32(const uchar *p, qint64 index)
+{
+    return qFromLittleEndian<quint32>(p + index * 4);
+}
+
+inline quint16 u16(const uchar *p, qint64 index)
+{
+    return qFromLittleEndian<quint16>(p + index * 2);
+}
+
+inline qint64 align4(qint64 bytes)
+{
+    return (bytes + 3) & ~qint64(3);
+}
+
+// 单个字符的归一化，对应 KnowledgeCanon::normalize 中对输入有意义的部分；返回 0 表示跳过
+inline ushort foldUnit(ushort u)
+{
+    if (u >= 0xFF01 && u <= 0xFF5E) {
+        u -= 0xFEE0;                    // 全角 ASCII 转半角
+    } else if (u == 0x3000) {
+        return 0;                       // 全角空格
+    }
+    switch (u) {
+    case '-': case '_': case '.': case '/': case 0x00B7:
+        return 0;
+    default:
+        break;
+    }
+    const QChar ch(u);
+    return ch.isSpace() ? 0 : ch.toCaseFolded().unicode();
+}
+
+}
+
+CompletionTrie::CompletionTrie()
+    : _nodes(nullptr)
+    , _edgeChars(nullptr)
+    , _edges(nullptr)
+    , _tops(nullptr)
+    , _entries(nullptr)
+    , _labels(nullptr)
+    , _strings(nullptr)
+    , _nodeCount(0)
+    , _edgeCount(0)
+    , _entryCount(0)
+    , _topK(0)
+{
+}
+
+bool CompletionTrie::load(const QString &path, QString *error)
+{
+    auto fail = [&](const QString &message) {
+        if (error) *error = QString("加载知识点补全表 %1 失败: %2").arg(path, message);
+        _file.reset();
+        _nodes = nullptr;
+        _nodeCount = _edgeCount = _entryCount = _topK = 0;
+        return false;
+    };
+
+    _file.reset(new QFile(path));
+    if (!_file->open(QIODevice::ReadOnly)) {
+        return fail(_file->errorString());
+    }
+
+    const qint64 fileSize = _file->size();
+    const uchar *data = fileSize >= HeaderSize ? _file->map(0, fileSize) : nullptr;
+    if (!data || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return fail("文件格式错误");
+    }
+
+    const quint32 nodeCount = u32(data + 8, 0);
+    const quint32 edgeCount = u32(data + 8, 1);
+    const quint32 topCount = u32(data + 8, 2);
+    const quint32 entryCount = u32(data + 8, 3);
+    const quint32 labelUnits = u32(data + 8, 4);
+    const quint32 stringUnits = u32(data + 8, 5);
+    if (nodeCount > quint32(std::numeric_limits<int>::max()) || edgeCount > quint32(std::numeric_limits<int>::max())
+        || entryCount > quint32(std::numeric_limits<int>::max())) {
+        return fail("文件头错误");
+    }
+
+    // 依次定位各段并检查文件长度
+    qint64 offset = HeaderSize;
+    auto section = [&](qint64 bytes) {
+        const uchar *p = data + offset;
+        offset += align4(bytes);
+        return p;
+    };
+    _nodes = section(qint64(nodeCount) * NodeSize);
+    _edgeChars = section(qint64(edgeCount) * 2);
+    _edges = section(qint64(edgeCount) * EdgeSize);
+    _tops = section(qint64(topCount) * 4);
+    _entries = section(qint64(entryCount) * EntrySize);
+    _labels = section(qint64(labelUnits) * 2);
+    _strings = section(qint64(stringUnits) * 2);
+    if (nodeCount == 0 || offset > fileSize) {
+        return fail("数据不完整");
+    }
+
+    // 查询时不再检查下标，这里把文件中所有的下标和偏移都检查一遍，损坏或过期的文件不会越界读取
+    for (quint32 i = 0; i < nodeCount; ++i) {
+        const uchar *n = _nodes + qint64(i) * NodeSize;
+        if (quint64(u32(n, 0)) + qFromLittleEndian<quint16>(n + 8) > edgeCount
+            || quint64(u32(n, 1)) + qFromLittleEndian<quint16>(n + 10) > topCount) {
+            return fail(QString("节点 %1 的边或候选超出范围").arg(i));
+        }
+    }
+    for (quint32 i = 0; i < edgeCount; ++i) {
+        const uchar *e = _edges + qint64(i) * EdgeSize;
+        if (u32(e, 0) >= nodeCount || u32(e, 2) == 0 || quint64(u32(e, 1)) + u32(e, 2) > labelUnits) {
+            return fail(QString("边 %1 的目标或标签超出范围").arg(i));
+        }
+    }
+    for (quint32 i = 0; i < topCount; ++i) {
+        if (u32(_tops, i) >= entryCount) {
+            return fail(QString("候选 %1 超出范围").arg(i));
+        }
+    }
+    for (quint32 i = 0; i < entryCount; ++i) {
+        const uchar *e = _entries + qint64(i) * EntrySize;
+        if (quint64(u32(e, 0)) + qFromLittleEndian<quint16>(e + 4) > stringUnits
+            || quint64(u32(e, 2)) + qFromLittleEndian<quint16>(e + 6) > stringUnits) {
+            return fail(QString("条目 %1 的字符串超出范围").arg(i));
+        }
+    }
+
+    _nodeCount = int(nodeCount);
+    _edgeCount = int(edgeCount);
+    _entryCount = int(entryCount);
+    _topK = int(u32(data + 8, 6));
+    return true;
+}
+
+int CompletionTrie::findNode(const QString &prefix) const
+{
+    int node = 0;
+    int edge = -1;                      // 正在匹配的边
+    quint32 labelPos = 0;
+    quint32 labelLength = 0;
+    const uchar *label = nullptr;
+
+    const QChar *units = prefix.constData();
+    for (int i = 0; i < prefix.size(); ++i) {
+        const ushort u = foldUnit(units[i].unicode());
+        if (u == 0) {
+            continue;
+        }
+
+        if (edge < 0) {
+            // 在当前节点的边中二分查找首字符
+            const uchar *n = _nodes + qint64(node) * NodeSize;
+            int lo = int(u32(n, 0));
+            int hi = lo + qFromLittleEndian<quint16>(n + 8);
+            while (lo < hi) {
+                const int mid = (lo + hi) / 2;
+                if (u16(_edgeChars, mid) < u) lo = mid + 1;
+                else hi = mid;
+            }
+            if (lo >= int(u32(n, 0)) + qFromLittleEndian<quint16>(n + 8) || u16(_edgeChars, lo) != u) {
+                return -1;
+            }
+            edge = lo;
+            const uchar *e = _edges + qint64(edge) * EdgeSize;
+            label = _labels + qint64(u32(e, 1)) * 2;
+            labelLength = u32(e, 2);
+            labelPos = 1;
+        } else if (u16(label, labelPos) == u) {
+            ++labelPos;
+        } else {
+            return -1;
+        }
+
+        if (labelPos == labelLength) {
+            node = int(u32(_edges + qint64(edge) * EdgeSize, 0));
+            edge = -1;
+        }
+    }
+
+    // 前缀停在边的中间时，补全结果就是边指向的子树
+    return edge < 0 ? node : int(u32(_edges + qint64(edge) * EdgeSize, 0));
+}
+
+int CompletionTrie::complete(const QString &prefix, Completion *out, int max) const
+{
+    if (!_nodes) {
+        return 0;
+    }
+
+    const int node = findNode(prefix);
+    if (node < 0 || node >= _nodeCount) {
+        return 0;
+    }
+
+    const uchar *n = _nodes + qint64(node) * NodeSize;
+    const quint32 firstTop = u32(n, 1);
+    const int count = qMin<int>(qFromLittleEndian<quint16>(n + 10), max);
+    for (int i = 0; i < count; ++i) {
+        const quint32 entry = u32(_tops, firstTop + i);
+        out[i].entry = int(entry);
+        out[i].weight = u32(_entries + qint64(entry) * EntrySize, 3);
+    }
+    return count;
+}
+
+QString CompletionTrie::string(quint32 offset, int length) const
+{
+    return QString(reinterpret_cast<const QChar *>(_strings + qint64(offset) * 2), length);
+}
+
+QString CompletionTrie::name(int entry) const
+{
+    if (entry < 0 || entry >= _entryCount) {
+        return QString();
+    }
+    const uchar *e = _entries + qint64(entry) * EntrySize;
+    return string(u32(e, 0), qFromLittleEndian<quint16>(e + 4));
+}
+
+QString CompletionTrie::path(int entry) const
+{
+    if (entry < 0 || entry >= _entryCount) {
+        return QString();
+    }
+    const uchar *e = _entries + qint64(entry) * EntrySize;
+    return string(u32(e, 2), qFromLittleEndian<quint16>(e + 6));
+}
+
+quint32 CompletionTrie::weight(int entry) const
+{
+    if (entry < 0 || entry >= _entryCount) {
+        return 0;
+    }
+    return u32(_entries + qint64(entry) * EntrySize, 3);
+}
@@ -0,0 +1,65 @@
+#ifndef COMPLETIONTRIE_H
+#define COMPLETIONTRIE_H
+
+#include <QString>
+#include <QFile>
+#include <QScopedPointer>
+
+// 知识点输入补全
+// 由 tools/build_trie.py 离线生成的压缩前缀树（边上是多个字符的基数树），整个文件内存映射。
+// 每个节点预先存好其子树中权重最高的若干条目，补全时只需沿前缀走到对应节点，
+// 不遍历子树、不分配内存。
+// 文件格式（小端，各段 4 字节对齐）：
+//   char[8]  "SLTRIE01"
+//   uint32   nodeCount, edgeCount, topCount, entryCount, labelUnits, stringUnits, topK, reserved
+//   节点     nodeCount 个 { uint32 firstEdge; uint32 firstTop; uint16 edgeCount; uint16 topCount }
+//   边首字符 edgeCount 个 uint16，同一节点的边按首字符升序，用于二分查找
+//   边       edgeCount 个 { uint32 target; uint32 labelOffset; uint32 labelLength }
+//   候选     topCount 个 uint32 条目下标，按权重降序
+//   条目     entryCount 个 { uint32 nameOffset; uint16 nameLength; uint16 pathLength; uint32 pathOffset; uint32 weight }
+//   边标签   labelUnits 个 uint16（UTF-16）
+//   字符串   stringUnits 个 uint16（UTF-16）
+class CompletionTrie
+{
+public:
+    struct Completion {
+        int entry;
+        quint32 weight;
+    };
+
+    CompletionTrie();
+
+    bool load(const QString &path, QString *error = nullptr);
+    bool isLoaded() const { return _nodes != nullptr; }
+    int entryCount() const { return _entryCount; }
+    int maxCompletions() const { return _topK; }
+
+    // 把前缀的补全结果写入 out（最多 max 个），返回个数
+    // 前缀按字符做全角转半角、大小写折叠并跳过空白和 - _ . · /，与生成文件时的归一化一致
+    int complete(const QString &prefix, Completion *out, int max) const;
+
+    QString name(int entry) const;
+    QString path(int entry) const;      // 分类路径，如 "计算机基础/数据结构"
+    quint32 weight(int entry) const;
+
+private:
+    Q_DISABLE_COPY(CompletionTrie)
+
+    QScopedPointer<QFile> _file;
+    const uchar *_nodes;
+    const uchar *_edgeChars;
+    const uchar *_edges;
+    const uchar *_tops;
+    const uchar *_entries;
+    const uchar *_labels;
+    const uchar *_strings;
+    int _nodeCount;
+    int _edgeCount;
+    int _entryCount;
+    int _topK;
+
+    int findNode(const QString &prefix) const;
+    QString string(quint32 offset, int length) const;
+};
+
+#endif // COMPLETIONTRIE_H
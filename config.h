@@ -5,12 +5,47 @@
 #define HOSTNAME "127.0.0.1"
 #define PORT 8080
 
+// 本地数据文件（相对程序目录）
+#define RESOURCE_CATALOG_FILE "data/resources.jsonl"   // 学习资源目录
+#define RESOURCE_EMBEDDING_FILE "data/resource_embeddings.bin"   // 资源向量
+#define RESOURCE_EMBEDDING_INT8 true    // 资源向量是否量化为 int8（内存减为四分之一）
+#define CF_INTERACTIONS_FILE "data/knowledge_interactions.jsonl"   // 匿名学生知识库导出
+#define CF_MODEL_FILE "data/cf_model.bin"                          // 训练好的推荐模型缓存
+#define KNOWLEDGE_TRIE_FILE "data/knowledge_trie.bin"              // 知识点补全前缀树（tools/build_trie.py 生成）
+#define KNOWLEDGE_TAXONOMY_FILE "data/knowledge_taxonomy.tsv"      // 知识点分类树
+#define LEARNING_GOALS_FILE "data/learning_goals.tsv"              // 学习目标（考研大纲、岗位技能）
+#define QUIZ_ITEMS_FILE "data/quiz_items.jsonl"                    // 知识点自测题库
+#define QUIZ_MAX_QUESTIONS 10                                      // 每次自测最多出题数
+#define CHAT_HISTORY_DIR "chat"                                    // 对话记录目录（位于用户数据目录下）
+#define ANSWER_CACHE_BYTES (8 * 1024 * 1024)                       // AI 回答缓存的内存上限
+#define ANSWER_CACHE_TTL_SEC (24 * 3600)                           // AI 回答缓存的有效期
+#define REVIEW_SYNC_BATCH 500                                      // 复习记录每批同步的卡片数
+#define REVIEW_SYNC_BACKOFF_MS (30 * 1000)                         // 复习同步失败后暂停的时间，连续失败时加倍
+#define REVIEW_SYNC_BACKOFF_MAX_MS (30 * 60 * 1000)                // 暂停时间的上限
+#define TRACE_FILE_ENV "SMARTLEARN_TRACE"                          // 设为文件路径时记录追踪，退出时写入 Chrome trace JSON
+#define LOG_LEVEL_ENV "SMARTLEARN_LOG_LEVEL"                       // 日志级别：trace/debug/info/warning/error/off，默认 info
+#define LOG_FILE_ENV "SMARTLEARN_LOG_FILE"                         // 设置时日志同时追加到该文件
+#define CAPTURE_FILE_ENV "SMARTLEARN_CAPTURE"                      // 设为文件路径时录制与服务器的收发，供 tools/replay 回放
+#define LOG_PREVIEW_BYTES 256                                      // 日志中报文预览的最大字节数
+#define LOG_QUEUE_LIMIT 10000                                      // 待写日志的上限，超出时丢弃
+#define UI_STALL_MS 100                                            // 事件循环超过该时间未响应计为一次卡顿（默认值）
+#define STALL_MS_ENV "SMARTLEARN_STALL_MS"                         // 覆盖卡顿阈值（毫秒）
+#define STALL_REPORT_FILE "stalls.jsonl"                           // 卡顿报告（位于用户数据目录下）
+#define STALL_REPORT_MAX_BYTES (1024 * 1024)                       // 卡顿报告超过该大小时轮换
+#define BATCH_FALLBACK_MS 2000                                     // 首次试探批量请求时，超过该时间没有回复则补发逐条登录
+#define CLIENT_SETTINGS_FILE "settings.ini"                        // 客户端记住的服务器能力（位于用户数据目录下）
+
 
 // 用于判断传输消息类型
 #define LoginType "LoginType"
 #define RegisterType "RegisterType"
 #define SaveKnowledgeType "SaveKnowledgeType"      // 保存知识库
 #define GetKnowledgeType "GetKnowledgeType"        // 获取知识库
+#define GetPathType "GetPathType"                  // 获取学习路径
+#define ChatType "ChatType"                        // AI对话提问（回答以 ChatChunk 流式返回）
+#define SaveReviewsType "SaveReviewsType"          // 上传一批复习记录（removed 为删除的知识点 id）
+#define GetReviewsType "GetReviewsType"            // 分页获取复习记录
+#define BatchType "BatchType"                      // 多条请求合成一帧，回复 BatchResponse
 
 // 注册错误码
 enum RegisterErrorCode {
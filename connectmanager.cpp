@@ -1,7 +1,7 @@
 #include "connectmanager.h"
 #include "config.h"
-
-#include <QDebug>
+#include "logger.h"
+#include "metrics.h"
 
 
 ConnectManager& ConnectManager::getInstance()
@@ -9,11 +9,31 @@ ConnectManager& ConnectManager::getInstance()
     static ConnectManager connect;
     if (!connect._isCreate) {
         connect._socket = new QTcpSocket();
+
+        // 连接、断开和连接失败的次数计入指标，设置页据此显示
+        QAbstractSocket::SocketState previous = QAbstractSocket::UnconnectedState;
+        Metrics::Counter *connects = &Metrics::counter("net.connects");
+        Metrics::Counter *disconnects = &Metrics::counter("net.disconnects");
+        Metrics::Counter *failures = &Metrics::counter("net.connect_failures");
+        QObject::connect(connect._socket, &QAbstractSocket::stateChanged, connect._socket,
+                         [previous, connects, disconnects, failures](QAbstractSocket::SocketState state) mutable {
+                             if (state == QAbstractSocket::ConnectedState) {
+                                 connects->add();
+                             } else if (previous == QAbstractSocket::ConnectedState) {
+                                 disconnects->add();
+                             } else if (state == QAbstractSocket::UnconnectedState
+                                        && (previous == QAbstractSocket::HostLookupState
+                                            || previous == QAbstractSocket::ConnectingState)) {
+                                 failures->add();
+                             }
+                             previous = state;
+                         });
+
         connect._socket->connectToHost(HOSTNAME, PORT);
         if (!connect._socket->waitForConnected(3000)) {
-            qDebug() << "连接失败: " << connect._socket->errorString();
+            LOG_WARNING() << "连接失败: " << connect._socket->errorString();
         } else {
-            qDebug() << "连接到服务器成功";
+            LOG_DEBUG() << "连接到服务器成功";
         }
         connect._isCreate = true;
     }
@@ -0,0 +1,22 @@
+#include "datafiles.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+
+QString DataFiles::locate(const QString &relativePath)
+{
+    const QString appDir = QCoreApplication::applicationDirPath();
+    const QString candidates[] = {
+        QDir(appDir).filePath(relativePath),
+        QDir(appDir + "/..").filePath(relativePath),
+        QDir::current().filePath(relativePath),
+    };
+
+    for (const QString &path : candidates) {
+        if (QFileInfo::exists(path)) {
+            return QDir::cleanPath(path);
+        }
+    }
+    return QDir::cleanPath(candidates[0]);
+}
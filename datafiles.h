@@ -0,0 +1,15 @@
+#ifndef DATAFILES_H
+#define DATAFILES_H
+
+#include <QString>
+
+namespace DataFiles {
+
+// 查找运行时数据文件（资源目录、同义词表等）
+// 依次尝试：程序所在目录、其上级目录（MSVC/MinGW 的 debug/release 子目录）、当前工作目录
+// 找不到时返回程序目录下的路径，由调用方报告错误
+QString locate(const QString &relativePath);
+
+}
+
+#endif // DATAFILES_H
@@ -0,0 +1,247 @@
+#include "embeddingindex.h"
+#include "simdkernels.h"
+
+#include <QtConcurrent>
+#include <QThread>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char Magic[8] = {'S', 'L', 'E', 'M', 'B', 'E', 'D', '1'};
+const int HeaderSize = 16;
+const quint32 MaxDim = 65536;           // 远大于实际使用的嵌入维度，只用于拒绝损坏的文件头
+
+// 每个线程至少扫描的条目数，太少时线程调度开销大于收益
+const int MinItemsPerThread = 32768;
+
+float norm(const float *v, int dim)
+{
+    return std::sqrt(SimdKernels::dotF32(v, v, dim));
+}
+
+float maxAbs(const float *v, int dim)
+{
+    float m = 0.0f;
+    for (int i = 0; i < dim; ++i) {
+        m = std::max(m, std::fabs(v[i]));
+    }
+    return m;
+}
+
+void quantizeRow(const float *v, int dim, float scale, std::int8_t *out)
+{
+    const float inv = scale > 0.0f ? 1.0f / scale : 0.0f;
+    for (int i = 0; i < dim; ++i) {
+        out[i] = std::int8_t(qBound(-127, qRound(v[i] * inv), 127));
+    }
+}
+
+bool lessByScore(const EmbeddingIndex::Match &a, const EmbeddingIndex::Match &b)
+{
+    return a.score > b.score;           // 用于小顶堆：堆顶是当前最小得分
+}
+
+}
+
+EmbeddingIndex::EmbeddingIndex()
+    : _vectors(nullptr)
+    , _count(0)
+    , _dim(0)
+    , _quantized(false)
+{
+}
+
+EmbeddingIndex::~EmbeddingIndex()
+{
+}
+
+bool EmbeddingIndex::load(const QString &path, bool quantize, QString *error)
+{
+    auto fail = [&](const QString &message) {
+        if (error) *error = QString("加载资源向量 %1 失败: %2").arg(path, message);
+        _file.reset();
+        _vectors = nullptr;
+        _count = 0;
+        _dim = 0;
+        return false;
+    };
+
+    _file.reset(new QFile(path));
+    if (!_file->open(QIODevice::ReadOnly)) {
+        return fail(_file->errorString());
+    }
+
+    const qint64 fileSize = _file->size();
+    uchar *data = fileSize >= HeaderSize ? _file->map(0, fileSize) : nullptr;
+    if (!data || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return fail("文件格式错误");
+    }
+
+    // 先限制 count 和 dim 的范围，相乘才不会溢出
+    const quint32 count = qFromLittleEndian<quint32>(data + 8);
+    const quint32 dim = qFromLittleEndian<quint32>(data + 12);
+    if (count > quint32(std::numeric_limits<int>::max()) || dim == 0 || dim > MaxDim) {
+        return fail("文件头错误");
+    }
+    const qint64 vectorBytes = qint64(count) * qint64(dim) * qint64(sizeof(float));
+    if (vectorBytes > fileSize - HeaderSize) {
+        return fail("向量数据不完整");
+    }
+    _count = int(count);
+    _dim = int(dim);
+    _vectors = reinterpret_cast<const float *>(data + HeaderSize);
+
+    // 条目 id 表
+    const uchar *p = data + HeaderSize + vectorBytes;
+    const uchar *end = data + fileSize;
+    _ids.clear();
+    _idToItem.clear();
+    _ids.reserve(_count);
+    _idToItem.reserve(_count);
+    for (int i = 0; i < _count; ++i) {
+        if (end - p < 2) return fail("id 表不完整");
+        quint16 len = qFromLittleEndian<quint16>(p);
+        p += 2;
+        if (end - p < len) return fail("id 表不完整");
+        QString id = QString::fromUtf8(reinterpret_cast<const char *>(p), len);
+        p += len;
+        _ids.append(id);
+        _idToItem.insert(id, i);
+    }
+
+    // 预计算每行的归一化系数，打分时直接得到余弦相似度
+    _rowScale.resize(_count);
+    _quantized = quantize;
+    if (quantize) {
+        _int8Vectors.resize(size_t(_count) * _dim);
+        for (int i = 0; i < _count; ++i) {
+            const float *v = row(i);
+            float n = norm(v, _dim);
+            float scale = maxAbs(v, _dim) / 127.0f;
+            quantizeRow(v, _dim, scale, _int8Vectors.data() + size_t(i) * _dim);
+            _rowScale[i] = n > 0.0f ? scale / n : 0.0f;
+        }
+        // 量化后不再需要浮点数据，释放映射
+        _file->unmap(data);
+        _file.reset();
+        _vectors = nullptr;
+    } else {
+        for (int i = 0; i < _count; ++i) {
+            float n = norm(row(i), _dim);
+            _rowScale[i] = n > 0.0f ? 1.0f / n : 0.0f;
+        }
+    }
+
+    return true;
+}
+
+QVector<float> EmbeddingIndex::centroid(const QVector<int> &items) const
+{
+    QVector<float> result(_dim, 0.0f);
+    for (int item : items) {
+        if (item < 0 || item >= _count) continue;
+        const float scale = _rowScale[item];
+        if (_quantized) {
+            const std::int8_t *v = _int8Vectors.data() + size_t(item) * _dim;
+            for (int i = 0; i < _dim; ++i) result[i] += v[i] * scale;
+        } else {
+            const float *v = row(item);
+            for (int i = 0; i < _dim; ++i) result[i] += v[i] * scale;
+        }
+    }
+    return result;
+}
+
+QVector<EmbeddingIndex::Match> EmbeddingIndex::topK(const QVector<float> &query, int k,
+                                                    const QSet<int> &exclude) const
+{
+    if (k <= 0 || _count == 0 || query.size() != _dim) {
+        return QVector<Match>();
+    }
+
+    // 归一化查询向量，量化模式下同时转换为 int8
+    QVector<float> q = query;
+    const float qNorm = norm(q.constData(), _dim);
+    if (qNorm <= 0.0f) {
+        return QVector<Match>();
+    }
+    for (float &x : q) x /= qNorm;
+
+    std::vector<std::int8_t> q8;
+    float qScale = 1.0f;
+    if (_quantized) {
+        qScale = maxAbs(q.constData(), _dim) / 127.0f;
+        q8.resize(_dim);
+        quantizeRow(q.constData(), _dim, qScale, q8.data());
+    }
+
+    const int threads = qMax(1, qMin(QThread::idealThreadCount(), _count / MinItemsPerThread));
+    const int chunk = (_count + threads - 1) / threads;
+    const float *qData = q.constData();
+    const std::int8_t *q8Data = q8.data();
+
+    QVector<QFuture<QVector<Match>>> futures;
+    for (int t = 1; t < threads; ++t) {
+        int begin = t * chunk;
+        int end = qMin(_count, begin + chunk);
+        futures.append(QtConcurrent::run([=, &exclude]() {
+            return scanRange(begin, end, qData, q8Data, qScale, k, exclude);
+        }));
+    }
+
+    // 第一段在当前线程扫描
+    QVector<Match> merged = scanRange(0, qMin(_count, chunk), qData, q8Data, qScale, k, exclude);
+    for (QFuture<QVector<Match>> &future : futures) {
+        merged += future.result();
+    }
+
+    const int top = qMin(k, merged.size());
+    std::partial_sort(merged.begin(), merged.begin() + top, merged.end(),
+                      [](const Match &a, const Match &b) { return a.score > b.score; });
+    merged.resize(top);
+    return merged;
+}
+
+QVector<EmbeddingIndex::Match> EmbeddingIndex::scanRange(int begin, int end, const float *query,
+                                                         const std::int8_t *query8, float queryScale,
+                                                         int k, const QSet<int> &exclude) const
+{
+    std::vector<Match> heap;
+    heap.reserve(k);
+    const float *rowScale = _rowScale.constData();
+    const bool checkExclude = !exclude.isEmpty();
+
+    for (int item = begin; item < end; ++item) {
+        float score;
+        if (_quantized) {
+            const std::int8_t *v = _int8Vectors.data() + size_t(item) * _dim;
+            score = SimdKernels::dotI8(v, query8, _dim) * (rowScale[item] * queryScale);
+        } else {
+            score = SimdKernels::dotF32(row(item), query, _dim) * rowScale[item];
+        }
+
+        // 只有可能进入 top-k 时才查排除集合
+        if (int(heap.size()) < k) {
+            if (checkExclude && exclude.contains(item)) continue;
+            heap.push_back(Match{item, score});
+            std::push_heap(heap.begin(), heap.end(), lessByScore);
+        } else if (score > heap.front().score) {
+            if (checkExclude && exclude.contains(item)) continue;
+            std::pop_heap(heap.begin(), heap.end(), lessByScore);
+            heap.back() = Match{item, score};
+            std::push_heap(heap.begin(), heap.end(), lessByScore);
+        }
+    }
+
+    QVector<Match> result;
+    result.reserve(int(heap.size()));
+    for (const Match &m : heap) {
+        result.append(m);
+    }
+    return result;
+}
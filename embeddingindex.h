@@ -0,0 +1,65 @@
+#ifndef EMBEDDINGINDEX_H
+#define EMBEDDINGINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QFile>
+#include <QScopedPointer>
+
+#include <cstdint>
+#include <vector>
+
+// 资源向量相似度检索
+// 向量文件格式（小端）：
+//   char[8]  "SLEMBED1"
+//   uint32   count, dim
+//   float32  vectors[count * dim]
+//   count 个 { uint16 len; char id[len] (UTF-8) }，与资源目录中的 id 对应
+// 浮点模式下向量直接内存映射；量化模式下转换为 int8 + 每行缩放系数，内存占用为四分之一
+class EmbeddingIndex
+{
+public:
+    struct Match {
+        int item;
+        float score;                    // 余弦相似度
+    };
+
+    EmbeddingIndex();
+    ~EmbeddingIndex();
+
+    bool load(const QString &path, bool quantize, QString *error = nullptr);
+
+    int size() const { return _count; }
+    int dimension() const { return _dim; }
+    bool isQuantized() const { return _quantized; }
+    QString itemId(int item) const { return _ids.value(item); }
+    int findItem(const QString &id) const { return _idToItem.value(id, -1); }
+
+    // 用若干条目向量的平均值作为学生画像向量
+    QVector<float> centroid(const QVector<int> &items) const;
+
+    // 多线程扫描全部条目，返回与 query 余弦相似度最高的 k 个（跳过 exclude 中的条目）
+    QVector<Match> topK(const QVector<float> &query, int k, const QSet<int> &exclude = QSet<int>()) const;
+
+private:
+    Q_DISABLE_COPY(EmbeddingIndex)
+
+    QScopedPointer<QFile> _file;
+    const float *_vectors;              // 内存映射的浮点向量（量化后为空）
+    std::vector<std::int8_t> _int8Vectors;
+    QVector<float> _rowScale;           // 浮点模式为 1/|v|，量化模式为 缩放系数/|v|
+    QStringList _ids;
+    QHash<QString, int> _idToItem;
+    int _count;
+    int _dim;
+    bool _quantized;
+
+    QVector<Match> scanRange(int begin, int end, const float *query, const std::int8_t *query8,
+                             float queryScale, int k, const QSet<int> &exclude) const;
+    const float *row(int item) const { return _vectors + qint64(item) * _dim; }
+};
+
+#endif // EMBEDDINGINDEX_H
@@ -0,0 +1,58 @@
+#ifndef GOALMATCHER_H
+#define GOALMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+#include <cstdint>
+#include <vector>
+
+// 学习目标匹配（考研大纲、岗位技能要求等）
+// 所有目标中出现的知识点规范 id 编成技能表，每个目标是一行定长位集；
+// 学生的知识库也编成同样的位集，覆盖数 = popcount(学生 & 目标)，
+// 用 SimdKernels::andPopcount 计算，目标很多时按行分块多线程扫描。
+// 数据来自 data/learning_goals.tsv（类别<TAB>目标<TAB>知识点|知识点|...）
+class GoalMatcher
+{
+public:
+    struct Goal {
+        QString category;
+        QString name;
+        QStringList points;             // 显示名称
+        QStringList ids;                // 与 points 一一对应的规范 id
+    };
+
+    struct Match {
+        int goal;
+        int covered;                    // 已掌握的要求知识点个数
+        int total;                      // 要求的知识点个数
+        double coverage() const { return total > 0 ? double(covered) / total : 0.0; }
+        int gap() const { return total - covered; }
+    };
+
+    GoalMatcher();
+
+    bool load(const QString &path, QString *error = nullptr);
+
+    int goalCount() const { return _goals.size(); }
+    int skillCount() const { return _skillIds.size(); }
+    const Goal &goal(int index) const { return _goals[index]; }
+
+    // 按覆盖率降序、缺口升序排序，返回前 count 个至少覆盖一个知识点的目标
+    // threads 为 0 时使用全部硬件线程，数据量小时总在当前线程计算
+    QVector<Match> rank(const QSet<QString> &knowledgeIds, int count, int threads = 0) const;
+
+    // 目标中尚未掌握的知识点（显示名称）
+    QStringList missing(int goal, const QSet<QString> &knowledgeIds) const;
+
+private:
+    QVector<Goal> _goals;
+    QHash<QString, int> _skillIds;      // 规范 id -> 位下标
+    int _words;                         // 每行 64 位字数，补齐到 4 的倍数以便整段走 AVX2
+    std::vector<std::uint64_t> _bits;   // goalCount x _words
+};
+
+#endif // GOALMATCHER_H
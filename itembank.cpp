@@ -0,0 +1,94 @@
+#include "itembank.h"
+#include "knowledgecanon.h"
+#include "logger.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+ItemBank::ItemBank()
+{
+}
+
+bool ItemBank::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开题库 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    // 先按知识点收集题目，再按知识点顺序排成连续区间
+    QVector<QVector<QJsonObject>> groups;
+    _pointNames.clear();
+    _pointIds.clear();
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty()) continue;
+
+        const QJsonObject item = QJsonDocument::fromJson(line).object();
+        const QString knowledge = item["knowledge"].toString();
+        const QString id = KnowledgeCanon::canonicalId(knowledge);
+        const int answer = item["answer"].toInt(-1);
+        const int optionCount = item["options"].toArray().size();
+        if (id.isEmpty() || item["stem"].toString().isEmpty()
+            || answer < 0 || answer >= optionCount) {
+            continue;
+        }
+        // 测验界面只有 MaxOptions 个选项按钮，多出的选项无法显示
+        if (optionCount > MaxOptions) {
+            LOG_WARNING() << QString("题库 %1 第 %2 行有 %3 个选项，超过 %4 个，已跳过")
+                                 .arg(path).arg(lineNumber).arg(optionCount).arg(MaxOptions);
+            continue;
+        }
+
+        auto it = _pointIds.constFind(id);
+        int point;
+        if (it == _pointIds.constEnd()) {
+            point = _pointNames.size();
+            _pointIds.insert(id, point);
+            _pointNames.append(KnowledgeCanon::displayName(knowledge));
+            groups.append(QVector<QJsonObject>());
+        } else {
+            point = it.value();
+        }
+        groups[point].append(item);
+    }
+
+    if (groups.isEmpty()) {
+        if (error) *error = QString("题库 %1 为空").arg(path);
+        return false;
+    }
+
+    _a.clear();
+    _b.clear();
+    _c.clear();
+    _answers.clear();
+    _stems.clear();
+    _options.clear();
+    _pointOffsets.assign(1, 0);
+    for (const QVector<QJsonObject> &group : groups) {
+        for (const QJsonObject &item : group) {
+            _a.push_back(float(item["a"].toDouble(1.0)));
+            _b.push_back(float(item["b"].toDouble(0.0)));
+            _c.push_back(float(qBound(0.0, item["c"].toDouble(0.0), 0.99)));
+            _stems.append(item["stem"].toString());
+            QStringList options;
+            for (const QJsonValue &option : item["options"].toArray()) {
+                options.append(option.toString());
+            }
+            _options.append(options);
+            _answers.push_back(item["answer"].toInt());
+        }
+        _pointOffsets.push_back(int(_a.size()));
+    }
+    return true;
+}
+
+int ItemBank::findPoint(const QString &knowledgePoint) const
+{
+    return _pointIds.value(KnowledgeCanon::canonicalId(knowledgePoint), -1);
+}
@@ -0,0 +1,55 @@
+#ifndef ITEMBANK_H
+#define ITEMBANK_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+#include <vector>
+
+// 测验题库
+// 题目按知识点分组连续存放，每个知识点对应区间 [pointBegin, pointEnd)；
+// 选题时只用到的 IRT 参数（区分度 a、难度 b、猜测 c）按列分别存成连续的 float 数组，
+// 扫描一个区间时只读这三列，可以直接交给 SimdKernels::argmaxInformation3pl。
+// 题干和选项只在出题时按下标读取。
+// 数据来自 data/quiz_items.jsonl，每行 {"knowledge", "a", "b", "c", "stem", "options", "answer"}
+class ItemBank
+{
+public:
+    static const int MaxOptions = 4;    // 每题最多的选项数，多于此数的题目不载入
+
+    ItemBank();
+
+    bool load(const QString &path, QString *error = nullptr);
+
+    int itemCount() const { return int(_a.size()); }
+    int pointCount() const { return _pointNames.size(); }
+
+    int findPoint(const QString &knowledgePoint) const;    // 按规范 id 查找，没有题目时返回 -1
+    int pointBegin(int point) const { return _pointOffsets[size_t(point)]; }
+    int pointEnd(int point) const { return _pointOffsets[size_t(point) + 1]; }
+    QString pointName(int point) const { return _pointNames.value(point); }
+
+    const float *discrimination() const { return _a.data(); }
+    const float *difficulty() const { return _b.data(); }
+    const float *guessing() const { return _c.data(); }
+
+    QString stem(int item) const { return _stems.value(item); }
+    QStringList options(int item) const { return _options.value(item); }
+    int answer(int item) const { return _answers[size_t(item)]; }
+
+private:
+    std::vector<float> _a;
+    std::vector<float> _b;
+    std::vector<float> _c;
+    std::vector<int> _pointOffsets;     // 知识点 -> 题目区间，长度 pointCount + 1
+    QStringList _pointNames;
+    QHash<QString, int> _pointIds;      // 规范 id -> 知识点下标
+
+    QStringList _stems;
+    QVector<QStringList> _options;
+    std::vector<int> _answers;
+};
+
+#endif // ITEMBANK_H
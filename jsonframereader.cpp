@@ -0,0 +1,114 @@
+#include "jsonframereader.h"
+
+namespace {
+
+bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+// "yes"/"no" 的真前缀
+bool isPartialToken(const QByteArray &text)
+{
+    return text == "y" || text == "ye" || text == "n";
+}
+
+}
+
+JsonFrameReader::JsonFrameReader()
+    : _start(0)
+    , _scan(0)
+    , _depth(0)
+    , _inString(false)
+    , _escape(false)
+{
+}
+
+void JsonFrameReader::append(const QByteArray &data)
+{
+    // 已消费的部分超过一半时整理缓冲区，避免无限增长
+    if (_start > 0 && _start * 2 >= _buffer.size()) {
+        _buffer.remove(0, _start);
+        _scan -= _start;
+        _start = 0;
+    }
+    _buffer.append(data);
+}
+
+void JsonFrameReader::clear()
+{
+    _buffer.clear();
+    _start = 0;
+    _scan = 0;
+    _depth = 0;
+    _inString = false;
+    _escape = false;
+}
+
+void JsonFrameReader::consume(int end, QByteArray *frame)
+{
+    *frame = _buffer.mid(_start, end - _start);
+    _start = end;
+    _scan = end;
+    _depth = 0;
+    _inString = false;
+    _escape = false;
+}
+
+bool JsonFrameReader::next(QByteArray *frame)
+{
+    const char *data = _buffer.constData();
+    const int size = _buffer.size();
+
+    // 跳过帧之间的空白
+    if (_depth == 0 && _scan == _start) {
+        while (_start < size && isSpace(data[_start])) {
+            ++_start;
+        }
+        _scan = _start;
+        if (_start >= size) {
+            return false;
+        }
+
+        // 不是 JSON 的裸文本回复（如 "yes"/"no"）：取到下一个 '{' 为止；
+        // 缓冲区末尾的 "y"、"ye"、"n" 可能是被拆开的 "yes"/"no"，等后续字节到达，其他文本直接成帧
+        if (data[_start] != '{' && data[_start] != '[') {
+            int end = _start;
+            while (end < size && data[end] != '{' && data[end] != '[') {
+                ++end;
+            }
+            if (end == size && isPartialToken(_buffer.mid(_start, end - _start))) {
+                return false;
+            }
+            consume(end, frame);
+            *frame = frame->trimmed();
+            return true;
+        }
+    }
+
+    for (; _scan < size; ++_scan) {
+        const char ch = data[_scan];
+        if (_inString) {
+            if (_escape) {
+                _escape = false;
+            } else if (ch == '\\') {
+                _escape = true;
+            } else if (ch == '"') {
+                _inString = false;
+            }
+            continue;
+        }
+
+        if (ch == '"') {
+            _inString = true;
+        } else if (ch == '{' || ch == '[') {
+            ++_depth;
+        } else if (ch == '}' || ch == ']') {
+            if (--_depth == 0) {
+                consume(_scan + 1, frame);
+                return true;
+            }
+        }
+    }
+    return false;
+}
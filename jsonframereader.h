@@ -0,0 +1,35 @@
+#ifndef JSONFRAMEREADER_H
+#define JSONFRAMEREADER_H
+
+#include <QByteArray>
+
+// 把 socket 字节流切分成完整的消息帧
+// 协议没有长度前缀，消息是一个接一个的 JSON 对象（也可能是 "yes"/"no" 这样的裸文本）。
+// 裸文本回复没有结束标记，缓冲区末尾是 "yes"/"no" 的前缀时等后续字节，其他裸文本立即成帧。
+// TCP 会把多条消息合并或把一条消息拆开，这里按括号深度（忽略字符串内的括号）找出每个完整对象。
+// 扫描状态跨 append 保留，每个字节只扫描一次。
+class JsonFrameReader
+{
+public:
+    JsonFrameReader();
+
+    void append(const QByteArray &data);
+
+    // 取出下一条完整的消息，没有完整消息时返回 false
+    bool next(QByteArray *frame);
+
+    void clear();
+    int pendingBytes() const { return _buffer.size() - _start; }
+
+private:
+    QByteArray _buffer;
+    int _start;                         // 当前帧在 _buffer 中的起点
+    int _scan;                          // 下一个待扫描的位置
+    int _depth;                         // 括号深度
+    bool _inString;
+    bool _escape;
+
+    void consume(int end, QByteArray *frame);
+};
+
+#endif // JSONFRAMEREADER_H
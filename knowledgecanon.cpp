@@ -0,0 +1,117 @@
+#include "knowledgecanon.h"
+#include "synonymtable.h"
+
+#include <QSet>
+
+#include <cstring>
+
+namespace {
+
+bool isStripped(QChar ch)
+{
+    switch (ch.unicode()) {
+    case '-': case '_': case '.': case '/': case 0x00B7:    // ·
+        return true;
+    default:
+        return ch.isSpace();
+    }
+}
+
+// 与 tools/gen_synonyms.py 中的 hash_key 一致：按 UTF-16 编码单元的低、高字节做 FNV-1a
+quint32 hashKey(const QChar *units, int length, quint32 seed)
+{
+    quint32 h = 2166136261u ^ seed;
+    for (int i = 0; i < length; ++i) {
+        const ushort u = units[i].unicode();
+        h ^= u & 0xFF;
+        h *= 16777619u;
+        h ^= u >> 8;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+}
+
+namespace KnowledgeCanon {
+
+QString normalize(const QString &text)
+{
+    // 纯 ASCII 时 NFKC 不改变文本，跳过以减少一次分配
+    bool ascii = true;
+    for (const QChar ch : text) {
+        if (ch.unicode() >= 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+
+    QString folded = ascii ? text.toLower() : text.normalized(QString::NormalizationForm_KC).toCaseFolded();
+    int out = 0;
+    for (int i = 0; i < folded.size(); ++i) {
+        if (!isStripped(folded[i])) {
+            folded[out++] = folded[i];
+        }
+    }
+    folded.truncate(out);
+    return folded;
+}
+
+int lookup(const QString &normalized)
+{
+    const QChar *units = normalized.constData();
+    const int length = normalized.size();
+
+    const quint32 bucket = hashKey(units, length, 0) % SynonymTable::BucketCount;
+    const quint32 seed = SynonymTable::Seeds[bucket];
+    const SynonymTable::Slot &slot = SynonymTable::Slots[hashKey(units, length, seed) % SynonymTable::SlotCount];
+
+    // 完美哈希只保证表内写法不冲突，表外的文本需要比较原文
+    if (!slot.key || slot.length != length
+        || std::memcmp(slot.key, units, size_t(length) * sizeof(char16_t)) != 0) {
+        return -1;
+    }
+    return slot.canonical;
+}
+
+QString canonicalId(const QString &text)
+{
+    const QString normalized = normalize(text);
+    const int index = lookup(normalized);
+    return index >= 0 ? QString::fromLatin1(SynonymTable::Canonicals[index].id) : normalized;
+}
+
+QStringList canonicalIds(const QStringList &points)
+{
+    QStringList ids;
+    ids.reserve(points.size());
+    for (const QString &point : points) {
+        ids.append(canonicalId(point));
+    }
+    return ids;
+}
+
+QStringList uniquePoints(const QStringList &points, QStringList *ids)
+{
+    QStringList names;
+    QSet<QString> seen;
+    seen.reserve(points.size());
+    for (const QString &point : points) {
+        const QString id = canonicalId(point);
+        if (id.isEmpty() || seen.contains(id)) {
+            continue;
+        }
+        seen.insert(id);
+        names.append(displayName(point));
+        if (ids) ids->append(id);
+    }
+    return names;
+}
+
+QString displayName(const QString &text)
+{
+    const int index = lookup(normalize(text));
+    return index >= 0 ? QString::fromUtf8(SynonymTable::Canonicals[index].name) : text.trimmed();
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef KNOWLEDGECANON_H
+#define KNOWLEDGECANON_H
+
+#include <QString>
+#include <QStringList>
+
+// 知识点规范化
+// "C++"、"c++"、"cpp"、"C加加" 等写法映射到同一个规范 id（如 "cpp"）。
+// 先做 NFKC（全角转半角）和大小写折叠，去掉空白和 - _ . · /，
+// 再查 synonymtable.h 中的完美哈希表（由 tools/gen_synonyms.py 根据 data/knowledge_synonyms.txt 生成）。
+// 表中没有的知识点以归一化后的文本作为 id，同样可以去重。
+namespace KnowledgeCanon {
+
+QString normalize(const QString &text);
+
+// 归一化文本在同义词表中的下标，没有时返回 -1
+int lookup(const QString &normalized);
+
+QString canonicalId(const QString &text);
+QStringList canonicalIds(const QStringList &points);
+
+// 按规范 id 去重，保留第一次出现的写法对应的规范名称；ids 非空时写入与结果一一对应的规范 id
+QStringList uniquePoints(const QStringList &points, QStringList *ids = nullptr);
+
+// 表中的知识点返回规范名称（如 "cpp" -> "C++"），否则返回去掉首尾空白的原文
+QString displayName(const QString &text);
+
+}
+
+#endif // KNOWLEDGECANON_H
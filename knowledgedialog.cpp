@@ -2,21 +2,31 @@
 #include "ui_knowledgedialog.h"
 #include "connectmanager.h"
 #include "config.h"
+#include "tracer.h"
+#include "logger.h"
+#include "metrics.h"
+#include "capture.h"
+#include "messages.h"
+#include "knowledgecanon.h"
+#include "datafiles.h"
+#include "synonymtable.h"
+#include "quizdialog.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QMessageBox>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include <QAbstractSocket>
+#include <QInputDialog>
+#include <QRegularExpression>
+#include <QtConcurrent>
 
 KnowledgeDialog::KnowledgeDialog(const QString &username, QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::KnowledgeDialog)
     , _username(username)
 {
+    TRACE_SCOPE("KnowledgeDialog::KnowledgeDialog");
     ui->setupUi(this);
 
     setWindowTitle("填写我的知识库");
@@ -81,6 +91,13 @@ KnowledgeDialog::KnowledgeDialog(const QString &username, QWidget *parent)
         QPushButton#add_btn:hover {
             background-color: #45a049;
         }
+        QPushButton#import_btn {
+            background-color: #FF9800;
+            color: white;
+        }
+        QPushButton#import_btn:hover {
+            background-color: #F57C00;
+        }
         QPushButton#remove_btn {
             background-color: #f44336;
             color: white;
@@ -92,6 +109,17 @@ KnowledgeDialog::KnowledgeDialog(const QString &username, QWidget *parent)
             background-color: #cccccc;
             color: #666666;
         }
+        QPushButton#quiz_btn {
+            background-color: #9C27B0;
+            color: white;
+        }
+        QPushButton#quiz_btn:hover {
+            background-color: #7B1FA2;
+        }
+        QPushButton#quiz_btn:disabled {
+            background-color: #cccccc;
+            color: #666666;
+        }
         QPushButton#skip_btn {
             background-color: #9E9E9E;
             color: white;
@@ -112,18 +140,18 @@ KnowledgeDialog::KnowledgeDialog(const QString &username, QWidget *parent)
     ConnectManager &manager = ConnectManager::getInstance();
     _client = manager.getSocket();
 
-    qDebug() << "=== KnowledgeDialog构造 ===";
-    qDebug() << "当前socket状态:" << _client->state();
+    LOG_TRACE() << "=== KnowledgeDialog构造 ===";
+    LOG_DEBUG() << "当前socket状态:" << _client->state();
 
     // 确保socket已连接
     if (_client->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "Socket未连接，尝试重新连接";
+        LOG_DEBUG() << "Socket未连接，尝试重新连接";
         _client->abort();
         _client->connectToHost("127.0.0.1", 8080);
         if (!_client->waitForConnected(3000)) {
-            qDebug() << "Socket连接失败:" << _client->errorString();
+            LOG_WARNING() << "Socket连接失败:" << _client->errorString();
         } else {
-            qDebug() << "Socket重新连接成功";
+            LOG_DEBUG() << "Socket重新连接成功";
         }
     }
 
@@ -132,7 +160,7 @@ KnowledgeDialog::KnowledgeDialog(const QString &username, QWidget *parent)
 
     // 连接readyRead信号
     connect(_client, &QTcpSocket::readyRead, this, &KnowledgeDialog::SlotReadFromServer);
-    qDebug() << "已连接KnowledgeDialog::SlotReadFromServer到readyRead信号";
+    LOG_DEBUG() << "已连接KnowledgeDialog::SlotReadFromServer到readyRead信号";
 
     // 加载已有知识点
     loadKnowledge();
@@ -178,12 +206,35 @@ void KnowledgeDialog::setupUI()
     _knowledge_edit = new QLineEdit(this);
     _knowledge_edit->setPlaceholderText("输入已掌握的知识点，如：C++、Python、数据结构...");
 
+    // 输入补全：候选由前缀树直接给出，QCompleter 不再自行过滤
+    QString trieError;
+    if (!_trie.load(DataFiles::locate(KNOWLEDGE_TRIE_FILE), &trieError)) {
+        LOG_WARNING() << trieError;
+    }
+    _completion_model = new QStringListModel(this);
+    _completer = new QCompleter(_completion_model, this);
+    _completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    _completer->setMaxVisibleItems(8);
+    _knowledge_edit->setCompleter(_completer);
+    connect(_knowledge_edit, &QLineEdit::textEdited,
+            this, &KnowledgeDialog::onKnowledgeTextEdited);
+
+    // 拼写纠错索引在后台建立，建好之前添加知识点不做纠错
+    connect(&_spellWatcher, &QFutureWatcher<QSharedPointer<SpellData>>::finished, this, [this]() {
+        _spell = _spellWatcher.result();
+    });
+    _spellWatcher.setFuture(spellData());
+
     _add_btn = new QPushButton("添加", this);
     _add_btn->setObjectName("add_btn");
     _add_btn->setMinimumWidth(80);
 
+    _import_btn = new QPushButton("批量导入", this);
+    _import_btn->setObjectName("import_btn");
+
     inputLayout->addWidget(_knowledge_edit);
     inputLayout->addWidget(_add_btn);
+    inputLayout->addWidget(_import_btn);
     mainLayout->addLayout(inputLayout);
 
     // 知识点列表
@@ -200,11 +251,34 @@ void KnowledgeDialog::setupUI()
     _knowledge_list->setMaximumHeight(200);
     mainLayout->addWidget(_knowledge_list);
 
-    // 删除按钮
+    // 删除和自测按钮
+    QHBoxLayout *listBtnLayout = new QHBoxLayout();
     _remove_btn = new QPushButton("删除选中的知识点", this);
     _remove_btn->setObjectName("remove_btn");
     _remove_btn->setEnabled(false);
-    mainLayout->addWidget(_remove_btn);
+    listBtnLayout->addWidget(_remove_btn);
+
+    _quiz_btn = new QPushButton("测一测", this);
+    _quiz_btn->setObjectName("quiz_btn");
+    _quiz_btn->setToolTip("针对列表中的知识点自适应出题，检验是否真的掌握");
+    _quiz_btn->setEnabled(false);       // 题库加载完成后启用
+    listBtnLayout->addWidget(_quiz_btn);
+    mainLayout->addLayout(listBtnLayout);
+
+    QString bankPath = DataFiles::locate(QUIZ_ITEMS_FILE);
+    connect(&_bankWatcher, &QFutureWatcher<QSharedPointer<const ItemBank>>::finished, this, [this]() {
+        _bank = _bankWatcher.result();
+        _quiz_btn->setEnabled(_bank != nullptr);
+    });
+    _bankWatcher.setFuture(QtConcurrent::run([bankPath]() {
+        QSharedPointer<ItemBank> bank(new ItemBank());
+        QString error;
+        if (!bank->load(bankPath, &error)) {
+            LOG_WARNING() << error;
+            return QSharedPointer<const ItemBank>();
+        }
+        return QSharedPointer<const ItemBank>(bank);
+    }));
 
     // 按钮区域
     QHBoxLayout *btnLayout = new QHBoxLayout();
@@ -228,8 +302,12 @@ void KnowledgeDialog::setupUI()
     // 连接信号槽
     connect(_add_btn, &QPushButton::clicked,
             this, &KnowledgeDialog::onAddKnowledge);
+    connect(_import_btn, &QPushButton::clicked,
+            this, &KnowledgeDialog::onBulkImport);
     connect(_remove_btn, &QPushButton::clicked,
             this, &KnowledgeDialog::onRemoveKnowledge);
+    connect(_quiz_btn, &QPushButton::clicked,
+            this, &KnowledgeDialog::onQuiz);
     connect(_save_btn, &QPushButton::clicked,
             this, &KnowledgeDialog::onSave);
     connect(_skip_btn, &QPushButton::clicked,
@@ -242,6 +320,30 @@ void KnowledgeDialog::setupUI()
             this, &KnowledgeDialog::onAddKnowledge);
 }
 
+void KnowledgeDialog::onKnowledgeTextEdited(const QString &text)
+{
+    if (!_trie.isLoaded() || text.trimmed().isEmpty()) {
+        _completion_model->setStringList(QStringList());
+        return;
+    }
+
+    CompletionTrie::Completion completions[MaxCompletions];
+    const int count = _trie.complete(text, completions, MaxCompletions);
+
+    // 同名知识点可能出现在多个分类下，只显示一次
+    QStringList names;
+    for (int i = 0; i < count; ++i) {
+        QString name = _trie.name(completions[i].entry);
+        if (!names.contains(name)) {
+            names.append(name);
+        }
+    }
+    _completion_model->setStringList(names);
+    if (!names.isEmpty()) {
+        _completer->complete();
+    }
+}
+
 void KnowledgeDialog::onAddKnowledge()
 {
     QString text = _knowledge_edit->text().trimmed();
@@ -249,15 +351,33 @@ void KnowledgeDialog::onAddKnowledge()
         return;
     }
 
-    // 检查是否已存在
-    for (int i = 0; i < _knowledge_list->count(); ++i) {
-        if (_knowledge_list->item(i)->text() == text) {
-            QMessageBox::information(this, "提示", "该知识点已存在");
+    // 不认识的写法先查拼写纠错，如 "数据结购" -> "数据结构"
+    QString suggestion = correctSpelling(text);
+    if (!suggestion.isEmpty()) {
+        QMessageBox::StandardButton answer = QMessageBox::question(
+            this, "拼写提示",
+            QString("没有找到「%1」，你是不是要输入「%2」？").arg(text, suggestion),
+            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+        if (answer == QMessageBox::Cancel) {
             return;
         }
+        if (answer == QMessageBox::Yes) {
+            text = suggestion;
+        }
+    }
+
+    // 只由分隔符组成的输入（如 "--"、"./"）规范 id 为空，不是重复
+    if (KnowledgeCanon::canonicalId(text).isEmpty()) {
+        QMessageBox::information(this, "提示", "无效的知识点");
+        return;
+    }
+
+    // 按规范 id 检查是否已存在，"cpp"、"C加加" 都视为 "C++"
+    if (!addKnowledgeItem(text)) {
+        QMessageBox::information(this, "提示", "该知识点已存在");
+        return;
     }
 
-    _knowledge_list->addItem(text);
     _knowledge_edit->clear();
     _knowledge_edit->setFocus();
 
@@ -265,43 +385,199 @@ void KnowledgeDialog::onAddKnowledge()
     _count_label->setText(QString("共 %1 个").arg(_knowledge_list->count()));
 }
 
+bool KnowledgeDialog::addKnowledgeItem(const QString &text)
+{
+    const QString id = KnowledgeCanon::canonicalId(text);
+    if (id.isEmpty() || _knowledge_ids.contains(id)) {
+        return false;
+    }
+
+    QListWidgetItem *item = new QListWidgetItem(KnowledgeCanon::displayName(text), _knowledge_list);
+    item->setData(Qt::UserRole, id);
+    _knowledge_ids.insert(id);
+    return true;
+}
+
+void KnowledgeDialog::onBulkImport()
+{
+    bool ok = false;
+    QString input = QInputDialog::getMultiLineText(
+        this, "批量导入知识点", "每行一个知识点，也可以用逗号、顿号或分号分隔：", QString(), &ok);
+    if (!ok) {
+        return;
+    }
+
+    // 批量导入时直接采用纠错结果，最后统一列出
+    int added = 0;
+    int duplicates = 0;
+    QStringList corrections;
+    const QStringList points = input.split(QRegularExpression("[\\n,，、;；]"));
+    for (QString point : points) {
+        point = point.trimmed();
+        if (point.isEmpty()) {
+            continue;
+        }
+        QString suggestion = correctSpelling(point);
+        if (!suggestion.isEmpty()) {
+            corrections.append(QString("%1 → %2").arg(point, suggestion));
+            point = suggestion;
+        }
+        if (addKnowledgeItem(point)) {
+            added++;
+        } else {
+            duplicates++;
+        }
+    }
+    _count_label->setText(QString("共 %1 个").arg(_knowledge_list->count()));
+
+    QString summary = QString("新增 %1 个知识点，跳过 %2 个重复项。").arg(added).arg(duplicates);
+    if (!corrections.isEmpty()) {
+        summary += QString("\n\n已自动纠正 %1 处拼写：\n%2").arg(corrections.size()).arg(corrections.join("\n"));
+    }
+    QMessageBox::information(this, "批量导入", summary);
+}
+
+QString KnowledgeDialog::correctSpelling(const QString &text) const
+{
+    if (!_spell) {
+        return QString();
+    }
+
+    // 同义词表中的写法不需要纠错
+    const QString normalized = KnowledgeCanon::normalize(text);
+    if (normalized.isEmpty() || KnowledgeCanon::lookup(normalized) >= 0) {
+        return QString();
+    }
+
+    std::u16string key(reinterpret_cast<const char16_t *>(normalized.utf16()), size_t(normalized.size()));
+    std::vector<SpellIndex::Suggestion> suggestions =
+        _spell->index.lookup(key, SpellIndex::maxDistanceFor(key.size()), 1);
+    if (suggestions.empty() || suggestions.front().distance == 0) {
+        return QString();
+    }
+    return _spell->names.at(suggestions.front().term);
+}
+
+QFuture<QSharedPointer<KnowledgeDialog::SpellData>> KnowledgeDialog::spellData()
+{
+    // 只在第一次打开对话框时建立，之后的对话框共用同一个结果（已完成的 future 也会发出 finished）
+    static const QFuture<QSharedPointer<SpellData>> future = QtConcurrent::run([]() {
+        return buildSpellData(DataFiles::locate(KNOWLEDGE_TRIE_FILE));
+    });
+    return future;
+}
+
+QSharedPointer<KnowledgeDialog::SpellData> KnowledgeDialog::buildSpellData(const QString &triePath)
+{
+    // 词条：分类中的知识点名称 + 同义词表中的全部写法，键为归一化文本
+    QSharedPointer<SpellData> data(new SpellData());
+    std::vector<std::u16string> terms;
+    std::vector<std::uint32_t> weights;
+    QHash<QString, int> seen;
+    auto addTerm = [&](const QString &key, const QString &name, quint32 weight) {
+        if (key.isEmpty() || seen.contains(key)) {
+            return;
+        }
+        seen.insert(key, int(terms.size()));
+        terms.emplace_back(reinterpret_cast<const char16_t *>(key.utf16()), size_t(key.size()));
+        weights.push_back(weight);
+        data->names.append(name);
+    };
+
+    CompletionTrie trie;
+    QString error;
+    if (trie.load(triePath, &error)) {
+        for (int i = 0; i < trie.entryCount(); ++i) {
+            const QString name = trie.name(i);
+            addTerm(KnowledgeCanon::normalize(name), name, trie.weight(i));
+        }
+    } else {
+        LOG_WARNING() << error;
+    }
+    for (const SynonymTable::Slot &slot : SynonymTable::Slots) {
+        if (slot.key) {
+            addTerm(QString::fromUtf16(slot.key, slot.length),
+                    QString::fromUtf8(SynonymTable::Canonicals[slot.canonical].name), 0);
+        }
+    }
+
+    data->index.build(terms, weights);
+    return data;
+}
+
 void KnowledgeDialog::onRemoveKnowledge()
 {
     QListWidgetItem *item = _knowledge_list->currentItem();
     if (item) {
+        _knowledge_ids.remove(item->data(Qt::UserRole).toString());
         delete item;
         _count_label->setText(QString("共 %1 个").arg(_knowledge_list->count()));
     }
 }
 
-void KnowledgeDialog::onSave()
+void KnowledgeDialog::onQuiz()
 {
-    // 收集知识点
-    QJsonArray knowledgeArray;
+    if (!_bank) {
+        return;
+    }
+
+    QStringList points;
     for (int i = 0; i < _knowledge_list->count(); ++i) {
-        knowledgeArray.append(_knowledge_list->item(i)->text());
+        points.append(_knowledge_list->item(i)->text());
+    }
+    if (points.isEmpty()) {
+        QMessageBox::information(this, "知识点自测", "请先添加已掌握的知识点");
+        return;
     }
 
-    // 构造JSON请求
-    QJsonObject json;
-    json["type"] = SaveKnowledgeType;
-    json["username"] = _username;
-    json["learning_goal"] = _goal_edit->text().trimmed();
-    json["knowledge_points"] = knowledgeArray;
+    QuizDialog quiz(_bank, points, this);
+    if (quiz.exec() != QDialog::Accepted || quiz.weakPoints().isEmpty()) {
+        return;
+    }
 
-    QJsonDocument doc(json);
+    const QStringList weak = quiz.weakPoints();
+    if (QMessageBox::question(this, "知识点自测",
+                              QString("以下知识点答错较多：\n%1\n\n是否从已掌握的列表中移除？").arg(weak.join("、")))
+        != QMessageBox::Yes) {
+        return;
+    }
+
+    const QStringList weakIds = KnowledgeCanon::canonicalIds(weak);
+    for (int i = _knowledge_list->count() - 1; i >= 0; --i) {
+        const QString id = _knowledge_list->item(i)->data(Qt::UserRole).toString();
+        if (weakIds.contains(id)) {
+            _knowledge_ids.remove(id);
+            delete _knowledge_list->takeItem(i);
+        }
+    }
+    _count_label->setText(QString("共 %1 个").arg(_knowledge_list->count()));
+}
+
+void KnowledgeDialog::onSave()
+{
+    TRACE_SCOPE("KnowledgeDialog::onSave");
+    // 收集知识点
+    Messages::SaveKnowledgeRequest request;
+    request.username = _username;
+    request.learningGoal = _goal_edit->text().trimmed();
+    request.knowledgePoints.reserve(_knowledge_list->count());
+    request.knowledgeIds.reserve(_knowledge_list->count());
+    for (int i = 0; i < _knowledge_list->count(); ++i) {
+        request.knowledgePoints.append(_knowledge_list->item(i)->text());
+        request.knowledgeIds.append(_knowledge_list->item(i)->data(Qt::UserRole).toString());
+    }
 
     // 检查socket连接状态
-    qDebug() << "当前socket状态:" << _client->state();
+    LOG_DEBUG() << "当前socket状态:" << _client->state();
     if (_client->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "Socket未连接，尝试重新连接";
+        LOG_DEBUG() << "Socket未连接，尝试重新连接";
         _client->abort();
         _client->connectToHost("127.0.0.1", 8080);
         if (!_client->waitForConnected(3000)) {
             QMessageBox::warning(this, "连接错误", "无法连接到服务器");
             return;
         }
-        qDebug() << "重新连接成功，状态:" << _client->state();
+        LOG_DEBUG() << "重新连接成功，状态:" << _client->state();
     }
 
     // 禁用按钮
@@ -313,33 +589,48 @@ void KnowledgeDialog::onSave()
     disconnect(_client, &QTcpSocket::readyRead, this, &KnowledgeDialog::SlotReadFromServer);
 
     // 发送请求
-    QByteArray data = doc.toJson();
-    qDebug() << "发送保存知识库请求:" << _username;
-    qDebug() << "请求数据:" << data;
+    QByteArray data;
+    {
+        TRACE_SCOPE("json.encode");
+        data = Messages::encode(request);
+    }
+    LOG_DEBUG() << "发送保存知识库请求:" << _username;
+    LOG_DEBUG() << "请求数据:" << Logger::preview(data);
 
+    Metrics::RoundTrip roundTrip(SaveKnowledgeType);
+    Capture::sent(data);
     qint64 bytesWritten = _client->write(data);
+    roundTrip.sent(bytesWritten);
     _client->flush();
 
-    qDebug() << "已写入" << bytesWritten << "字节";
+    LOG_DEBUG() << "已写入" << bytesWritten << "字节";
 
     // 直接等待响应，不依赖信号
-    if (_client->waitForReadyRead(5000)) {
+    bool ready;
+    {
+        TRACE_SCOPE("net.wait");
+        ready = _client->waitForReadyRead(5000);
+    }
+    if (ready) {
         QByteArray responseData = _client->readAll();
-        qDebug() << "收到响应数据:" << responseData;
-
-        QJsonDocument responseDoc = QJsonDocument::fromJson(responseData);
-        if (!responseDoc.isNull() && responseDoc.isObject()) {
-            QJsonObject responseJson = responseDoc.object();
-            QString type = responseJson["type"].toString();
-            QString status = responseJson["status"].toString();
-            QString message = responseJson["message"].toString();
-            qDebug() << "响应类型:" << type << "状态:" << status;
-
-            if (type == "KnowledgeResponse" && status == "success") {
-                QMessageBox::information(this, "保存成功", message);
+        Capture::received(responseData);
+        roundTrip.received(responseData.size());
+        LOG_DEBUG() << "收到响应数据:" << Logger::preview(responseData);
+
+        Messages::KnowledgeResponse reply;
+        bool parsed;
+        {
+            TRACE_SCOPE("json.parse");
+            parsed = Messages::decode(responseData, &reply);
+        }
+        if (parsed) {
+            LOG_DEBUG() << "响应状态:" << reply.status;
+
+            if (reply.status == "success") {
+                QMessageBox::information(this, "保存成功", reply.message);
                 accept();
             } else {
-                QMessageBox::warning(this, "保存失败", message);
+                QMessageBox::warning(this, "保存失败", reply.message);
                 _save_btn->setEnabled(true);
                 _skip_btn->setEnabled(true);
                 _save_btn->setText("保存并继续");
@@ -347,7 +638,7 @@ void KnowledgeDialog::onSave()
                 connect(_client, &QTcpSocket::readyRead, this, &KnowledgeDialog::SlotReadFromServer);
             }
         } else {
-            qDebug() << "响应解析失败";
+            LOG_WARNING() << "响应解析失败";
             QMessageBox::warning(this, "错误", "服务器响应格式错误");
             _save_btn->setEnabled(true);
             _skip_btn->setEnabled(true);
@@ -356,7 +647,7 @@ void KnowledgeDialog::onSave()
             connect(_client, &QTcpSocket::readyRead, this, &KnowledgeDialog::SlotReadFromServer);
         }
     } else {
-        qDebug() << "等待响应超时";
+        LOG_WARNING() << "等待响应超时";
         QMessageBox::warning(this, "超时", "服务器无响应，请检查网络连接");
         _save_btn->setEnabled(true);
         _skip_btn->setEnabled(true);
@@ -374,35 +665,33 @@ void KnowledgeDialog::onSkip()
 
 void KnowledgeDialog::SlotReadFromServer()
 {
+    TRACE_SCOPE("KnowledgeDialog::SlotReadFromServer");
     QByteArray data = _client->readAll();
-    qDebug() << "=== KnowledgeDialog::SlotReadFromServer 被调用 ===";
-    qDebug() << "响应数据:" << data;
-    qDebug() << "响应长度:" << data.length();
+    Capture::received(data);
+    LOG_TRACE() << "=== KnowledgeDialog::SlotReadFromServer 被调用 ===";
+    LOG_DEBUG() << "响应数据:" << Logger::preview(data);
+    LOG_DEBUG() << "响应长度:" << data.length();
 
     if (data.isEmpty()) {
-        qDebug() << "收到空数据，忽略";
+        LOG_DEBUG() << "收到空数据，忽略";
         return;
     }
 
-    // 先尝试解析JSON
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
-        qDebug() << "不是JSON格式，可能是登录响应或其他非知识库响应，忽略";
-        return;  // 不是知识库相关的JSON响应，忽略
-    }
-
-    QJsonObject json = doc.object();
-    QString type = json["type"].toString();
-    qDebug() << "响应类型:" << type;
-
-    if (type != "KnowledgeResponse") {
-        qDebug() << "不是KnowledgeResponse，忽略";
-        return;
+    // 只处理知识库响应，登录响应等其他数据解析失败时忽略
+    Messages::KnowledgeResponse reply;
+    if (!Messages::decode(data, &reply)) {
+        if (Messages::typeOf(data) != Messages::KnowledgeResponse::Type) {
+            LOG_DEBUG() << "不是KnowledgeResponse，忽略";
+            return;
+        }
+        // 知识库响应但格式错误：按保存失败处理，恢复按钮
+        reply.status = "error";
+        reply.message = "服务器回复无法解析";
     }
 
-    QString status = json["status"].toString();
-    QString message = json["message"].toString();
-    qDebug() << "状态:" << status << "消息:" << message;
+    const QString &status = reply.status;
+    const QString &message = reply.message;
+    LOG_DEBUG() << "状态:" << status << "消息:" << message;
 
     // 恢复按钮状态
     _save_btn->setEnabled(true);
@@ -419,69 +708,87 @@ void KnowledgeDialog::SlotReadFromServer()
 
 void KnowledgeDialog::loadKnowledge()
 {
-    qDebug() << "=== loadKnowledge 开始 ===";
+    TRACE_SCOPE("KnowledgeDialog::loadKnowledge");
+    LOG_TRACE() << "=== loadKnowledge 开始 ===";
 
     // 构造获取知识库请求
-    QJsonObject json;
-    json["type"] = GetKnowledgeType;
-    json["username"] = _username;
+    Messages::GetKnowledgeRequest request;
+    request.username = _username;
 
-    QJsonDocument doc(json);
-    QByteArray data = doc.toJson();
+    QByteArray data;
+    {
+        TRACE_SCOPE("json.encode");
+        data = Messages::encode(request);
+    }
 
-    qDebug() << "发送获取知识库请求:" << _username;
+    LOG_DEBUG() << "发送获取知识库请求:" << _username;
 
     // 断开信号，使用同步等待
     disconnect(_client, &QTcpSocket::readyRead, this, &KnowledgeDialog::SlotReadFromServer);
 
     // 发送请求
-    _client->write(data);
+    Metrics::RoundTrip roundTrip(GetKnowledgeType);
+    Capture::sent(data);
+    roundTrip.sent(_client->write(data));
     _client->flush();
 
     // 等待响应
-    if (_client->waitForReadyRead(3000)) {
+    bool ready;
+    {
+        TRACE_SCOPE("net.wait");
+        ready = _client->waitForReadyRead(3000);
+    }
+    if (ready) {
         QByteArray responseData = _client->readAll();
-        qDebug() << "收到知识库数据:" << responseData;
-
-        QJsonDocument responseDoc = QJsonDocument::fromJson(responseData);
-        if (!responseDoc.isNull() && responseDoc.isObject()) {
-            QJsonObject responseJson = responseDoc.object();
-            QString type = responseJson["type"].toString();
-            QString status = responseJson["status"].toString();
-
-            if (type == "KnowledgeResponse" && status == "success") {
-                QJsonArray knowledgeArray = responseJson["knowledge_points"].toArray();
-
+        Capture::received(responseData);
+        roundTrip.received(responseData.size());
+        LOG_DEBUG() << "收到知识库数据:" << Logger::preview(responseData);
+
+        Messages::KnowledgeResponse reply;
+        quint32 present = 0;
+        bool parsed;
+        {
+            TRACE_SCOPE("json.parse");
+            parsed = Messages::decode(responseData, &reply, &present);
+        }
+        if (parsed) {
+            if (reply.status == "success") {
                 // 清空列表
+                TRACE_SCOPE("list.knowledge");
                 _knowledge_list->clear();
+                _knowledge_ids.clear();
 
                 // 填充知识点
-                for (const QJsonValue &value : knowledgeArray) {
-                    QString point = value.toString();
-                    _knowledge_list->addItem(point);
+                // 旧数据中可能有同一知识点的多种写法，加载时合并
+                QStringList ids;
+                const QStringList names = KnowledgeCanon::uniquePoints(reply.knowledgePoints, &ids);
+                for (int i = 0; i < names.size(); ++i) {
+                    QListWidgetItem *item = new QListWidgetItem(names[i], _knowledge_list);
+                    item->setData(Qt::UserRole, ids[i]);
+                    _knowledge_ids.insert(ids[i]);
                 }
 
                 // 更新计数
                 _count_label->setText(QString("共 %1 个").arg(_knowledge_list->count()));
 
-                qDebug() << "知识库加载成功，共" << knowledgeArray.size() << "个知识点";
+                LOG_DEBUG() << "知识库加载成功，共" << reply.knowledgePoints.size() << "个知识点";
 
                 // 尝试获取学习目标
-                if (responseJson.contains("learning_goal")) {
-                    _goal_edit->setText(responseJson["learning_goal"].toString());
+                if (present & Messages::fieldBit<Messages::KnowledgeResponse>("learning_goal")) {
+                    _goal_edit->setText(reply.learningGoal);
                 }
             } else {
-                qDebug() << "获取知识库失败:" << responseJson["message"].toString();
+                LOG_WARNING() << "获取知识库失败:" << reply.message;
             }
         } else {
-            qDebug() << "响应解析失败";
+            LOG_WARNING() << "响应解析失败";
         }
     } else {
-        qDebug() << "获取知识库超时";
+        LOG_WARNING() << "获取知识库超时";
     }
 
     // 重连信号
     connect(_client, &QTcpSocket::readyRead, this, &KnowledgeDialog::SlotReadFromServer);
 
-    qDebug() << "=== loadKnowledge 结束 ===";
+    LOG_TRACE() << "=== loadKnowledge 结束 ===";
 }
@@ -8,6 +8,15 @@
 #include <QListWidget>
 #include <QPushButton>
 #include <QLabel>
+#include <QCompleter>
+#include <QStringListModel>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QSet>
+
+#include "completiontrie.h"
+#include "spellindex.h"
+#include "itembank.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class KnowledgeDialog; }
@@ -25,8 +34,11 @@ public slots:
     void SlotReadFromServer();          // 接收服务器响应
 
 private slots:
+    void onKnowledgeTextEdited(const QString &text);  // 更新补全候选
     void onAddKnowledge();              // 添加知识点
+    void onBulkImport();                // 批量导入知识点
     void onRemoveKnowledge();           // 删除选中的知识点
+    void onQuiz();                      // 对列表中的知识点自测
     void onSave();                      // 保存知识库
     void onSkip();                      // 跳过
 
@@ -39,14 +51,39 @@ private:
     QLineEdit *_goal_edit;              // 学习目标输入框
     QLineEdit *_knowledge_edit;         // 知识点输入框
     QPushButton *_add_btn;              // 添加按钮
+    QPushButton *_import_btn;           // 批量导入按钮
     QPushButton *_remove_btn;           // 删除按钮
+    QPushButton *_quiz_btn;             // 自测按钮
     QPushButton *_save_btn;             // 保存按钮
     QPushButton *_skip_btn;             // 跳过按钮
     QListWidget *_knowledge_list;       // 知识点列表
+    QSet<QString> _knowledge_ids;       // 列表中知识点的规范 id，用于去重
     QLabel *_count_label;               // 知识点计数标签
+    QCompleter *_completer;             // 知识点输入补全
+    QStringListModel *_completion_model;  // 补全候选
+
+    static const int MaxCompletions = 8;
+    CompletionTrie _trie;               // 知识点分类前缀树（内存映射）
+
+    // 拼写纠错
+    struct SpellData {
+        SpellIndex index;
+        QStringList names;              // 词条下标 -> 显示名称
+    };
+    QSharedPointer<SpellData> _spell;
+    QFutureWatcher<QSharedPointer<SpellData>> _spellWatcher;  // 后台建立纠错索引
+
+    // 自测题库
+    QSharedPointer<const ItemBank> _bank;
+    QFutureWatcher<QSharedPointer<const ItemBank>> _bankWatcher;  // 后台加载题库
 
     void setupUI();                     // 设置UI布局
     void loadKnowledge();               // 从服务器加载已有知识点
+    bool addKnowledgeItem(const QString &text);  // 按规范 id 去重后加入列表
+    QString correctSpelling(const QString &text) const;  // 返回纠正后的知识点，无需纠正时为空
+
+    static QFuture<QSharedPointer<SpellData>> spellData();  // 进程内只建一次
+    static QSharedPointer<SpellData> buildSpellData(const QString &triePath);
 };
 
 #endif // KNOWLEDGEDIALOG_H
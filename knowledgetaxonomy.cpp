@@ -0,0 +1,143 @@
+#include "knowledgetaxonomy.h"
+#include "knowledgecanon.h"
+
+#include <QFile>
+#include <QTextStream>
+
+KnowledgeTaxonomy::KnowledgeTaxonomy()
+{
+}
+
+bool KnowledgeTaxonomy::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = QString("无法打开知识点分类 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    // 先按文件顺序建临时树（节点下标为创建顺序），中间分类按需补齐
+    QStringList names;
+    QVector<int> parents;
+    QVector<QVector<int>> children(1);  // children[0] 是虚拟根
+    QHash<QString, int> byPath;         // 完整路径 -> 临时下标 + 1
+
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        const QStringList parts = line.section('\t', 0, 0).split('/');
+
+        int parent = 0;
+        QString prefix;
+        for (const QString &rawPart : parts) {
+            const QString part = rawPart.trimmed();
+            if (part.isEmpty()) continue;
+            prefix += '/' + part;
+            int node = byPath.value(prefix);
+            if (node == 0) {
+                names.append(part);
+                parents.append(parent);
+                children.append(QVector<int>());
+                node = names.size();
+                byPath.insert(prefix, node);
+                children[parent].append(node);
+            }
+            parent = node;
+        }
+    }
+
+    // 迭代先序遍历重新编号，并记录每个子树的结束位置
+    const int count = names.size();
+    _names.clear();
+    _names.reserve(count);
+    _parent.fill(-1, count);
+    _depth.fill(0, count);
+    _category.fill(0, count);
+    _end.fill(0, count);
+    _idToNode.clear();
+
+    QVector<int> order(count + 1, -1);  // 临时下标 -> 先序编号
+    struct Frame { int node; int next; };
+    QVector<Frame> stack;
+    stack.append({0, 0});
+    while (!stack.isEmpty()) {
+        Frame &frame = stack.last();
+        if (frame.next < children[frame.node].size()) {
+            const int child = children[frame.node][frame.next++];
+            const int id = _names.size();
+            order[child] = id;
+            _names.append(names[child - 1]);
+            const int parent = parents[child - 1] == 0 ? -1 : order[parents[child - 1]];
+            _parent[id] = parent;
+            _depth[id] = parent < 0 ? 0 : _depth[parent] + 1;
+            _category[id] = parent < 0 ? id : _category[parent];
+            stack.append({child, 0});
+        } else {
+            if (frame.node != 0) {
+                _end[order[frame.node]] = _names.size();
+            }
+            stack.removeLast();
+        }
+    }
+
+    // 同一知识点出现在多个分类下时，以先序中第一次出现的为准
+    for (int i = 0; i < count; ++i) {
+        const QString id = KnowledgeCanon::canonicalId(_names[i]);
+        if (!id.isEmpty() && !_idToNode.contains(id)) {
+            _idToNode.insert(id, i);
+        }
+    }
+    return true;
+}
+
+int KnowledgeTaxonomy::find(const QString &knowledgePoint) const
+{
+    return _idToNode.value(KnowledgeCanon::canonicalId(knowledgePoint), -1);
+}
+
+QString KnowledgeTaxonomy::path(int node) const
+{
+    QStringList parts;
+    for (int p = _parent.value(node, -1); p >= 0; p = _parent[p]) {
+        parts.prepend(_names[p]);
+    }
+    return parts.join('/');
+}
+
+int KnowledgeTaxonomy::nextSibling(int node) const
+{
+    const int next = _end[node];
+    const int parent = _parent[node];
+    const int limit = parent < 0 ? size() : _end[parent];
+    return next < limit ? next : -1;
+}
+
+QVector<int> KnowledgeTaxonomy::roots() const
+{
+    QVector<int> result;
+    for (int node = 0; node < size(); node = _end[node]) {
+        result.append(node);
+    }
+    return result;
+}
+
+KnowledgeTaxonomy::Mastery::Mastery(const KnowledgeTaxonomy &taxonomy, const QSet<QString> &knowledgeIds)
+    : _taxonomy(&taxonomy)
+    , _prefix(taxonomy.size() + 1, 0)
+    , _unclassified(0)
+{
+    QVector<char> marked(taxonomy.size(), 0);
+    for (const QString &id : knowledgeIds) {
+        const int node = taxonomy._idToNode.value(id, -1);
+        if (node >= 0) {
+            marked[node] = 1;
+        } else {
+            _unclassified++;
+        }
+    }
+    for (int i = 0; i < taxonomy.size(); ++i) {
+        _prefix[i + 1] = _prefix[i] + marked[i];
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef KNOWLEDGETAXONOMY_H
+#define KNOWLEDGETAXONOMY_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+// 知识点分类树（如 编程语言 → C++ → 模板）
+// 节点按先序遍历编号，每个节点的子树恰好是区间 [node, subtreeEnd(node))，
+// 祖先判断、子树大小都是 O(1)；掌握情况做一次前缀和后，任意分类的汇总也是 O(1)。
+// 数据来自 data/knowledge_taxonomy.tsv（路径<TAB>权重），路径中的中间分类会自动补齐。
+class KnowledgeTaxonomy
+{
+public:
+    // 一个学生在分类树上的掌握情况
+    class Mastery
+    {
+    public:
+        Mastery(const KnowledgeTaxonomy &taxonomy, const QSet<QString> &knowledgeIds);
+
+        int mastered(int node) const { return _prefix[_taxonomy->_end[node]] - _prefix[node]; }
+        int total(int node) const { return _taxonomy->_end[node] - node; }
+        bool any(int node) const { return mastered(node) > 0; }     // 是否掌握该分类下的任何知识点
+        bool isMastered(int node) const { return _prefix[node + 1] - _prefix[node] > 0; }
+        int unclassified() const { return _unclassified; }          // 不在分类树中的知识点个数
+
+    private:
+        const KnowledgeTaxonomy *_taxonomy;
+        QVector<int> _prefix;           // _prefix[i] = 先序编号小于 i 的已掌握节点数
+        int _unclassified;
+    };
+
+    KnowledgeTaxonomy();
+
+    bool load(const QString &path, QString *error = nullptr);
+
+    int size() const { return _names.size(); }
+    int find(const QString &knowledgePoint) const;  // 按规范 id 查找，找不到返回 -1
+
+    QString name(int node) const { return _names.value(node); }
+    QString path(int node) const;                   // 如 "计算机基础/数据结构"
+    int parent(int node) const { return _parent[node]; }
+    int depth(int node) const { return _depth[node]; }
+    int category(int node) const { return _category[node]; }   // 所属的顶层分类
+
+    int subtreeEnd(int node) const { return _end[node]; }
+    bool isAncestor(int ancestor, int node) const { return ancestor <= node && node < _end[ancestor]; }
+    bool hasChildren(int node) const { return _end[node] > node + 1; }
+
+    // 遍历子节点：for (int c = firstChild(v); c >= 0; c = nextSibling(c))
+    int firstChild(int node) const { return hasChildren(node) ? node + 1 : -1; }
+    int nextSibling(int node) const;
+    QVector<int> roots() const;
+
+private:
+    QStringList _names;
+    QVector<int> _parent;
+    QVector<int> _depth;
+    QVector<int> _category;
+    QVector<int> _end;
+    QHash<QString, int> _idToNode;
+};
+
+#endif // KNOWLEDGETAXONOMY_H
@@ -0,0 +1,268 @@
+#include "logger.h"
+#include "config.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QThread>
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const char LevelNames[] = {'T', 'D', 'I', 'W', 'E'};
+
+struct Entry {
+    qint64 msecs;
+    Logger::Level level;
+    quintptr thread;
+    const char *file;                   // 源文件名指向字符串字面量，无需复制
+    int line;
+    QString text;
+};
+
+// 后台写线程：调用方只在入队时短暂持锁
+class Writer
+{
+public:
+    static Writer &instance()
+    {
+        static Writer writer;
+        return writer;
+    }
+
+    void push(Entry &&entry)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_queue.size() >= std::size_t(LOG_QUEUE_LIMIT)) {
+                _dropped++;             // 写不过来时丢弃新记录，不阻塞调用方
+                return;
+            }
+            _queue.push_back(std::move(entry));
+        }
+        _wake.notify_one();
+    }
+
+    bool setFile(const QString &path, QString *error)
+    {
+        FILE *file = nullptr;
+        if (!path.isEmpty()) {
+            file = std::fopen(QFile::encodeName(path).constData(), "a");
+            if (!file) {
+                if (error) *error = QString("无法打开日志文件 %1").arg(path);
+                return false;
+            }
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingFile = file;
+        _fileChanged = true;
+        _wake.notify_one();
+        return true;
+    }
+
+    // 等待队列写完
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this]() { return _queue.empty() && !_writing; });
+    }
+
+    ~Writer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+        if (_file) {
+            std::fclose(_file);
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _idle;
+    std::deque<Entry> _queue;
+    std::size_t _dropped = 0;
+    bool _writing = false;
+    bool _stop = false;
+    bool _fileChanged = false;
+    FILE *_pendingFile = nullptr;
+    FILE *_file = nullptr;              // 只由写线程访问
+    std::thread _thread;
+
+    Writer()
+        : _thread([this]() { run(); })
+    {
+    }
+
+    void run()
+    {
+        std::deque<Entry> batch;
+        for (;;) {
+            std::size_t dropped = 0;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _writing = false;
+                _idle.notify_all();
+                _wake.wait(lock, [this]() { return _stop || _fileChanged || !_queue.empty(); });
+                if (_fileChanged) {
+                    if (_file) std::fclose(_file);
+                    _file = _pendingFile;
+                    _pendingFile = nullptr;
+                    _fileChanged = false;
+                }
+                if (_queue.empty() && _stop) {
+                    return;
+                }
+                batch.swap(_queue);
+                dropped = _dropped;
+                _dropped = 0;
+                _writing = true;
+            }
+
+            QByteArray out;
+            if (dropped > 0) {
+                out += QString("日志队列已满，丢弃了 %1 条记录\n").arg(dropped).toUtf8();
+            }
+            for (const Entry &entry : batch) {
+                out += format(entry);
+            }
+            batch.clear();
+
+            std::fwrite(out.constData(), 1, std::size_t(out.size()), stderr);
+            if (_file) {
+                std::fwrite(out.constData(), 1, std::size_t(out.size()), _file);
+                std::fflush(_file);
+            }
+        }
+    }
+
+    static QByteArray format(const Entry &entry)
+    {
+        // 时间 级别 [线程] 文件:行 内容
+        QByteArray line = QDateTime::fromMSecsSinceEpoch(entry.msecs).toString("yyyy-MM-dd hh:mm:ss.zzz").toLatin1();
+        line += ' ';
+        line += LevelNames[entry.level];
+        line += " [";
+        line += QByteArray::number(qulonglong(entry.thread), 16);
+        line += "] ";
+        if (entry.file) {
+            const char *name = entry.file;
+            for (const char *p = entry.file; *p; ++p) {
+                if (*p == '/' || *p == '\\') name = p + 1;
+            }
+            line += name;
+            line += ':';
+            line += QByteArray::number(entry.line);
+            line += ' ';
+        }
+        line += entry.text.toUtf8();
+        line += '\n';
+        return line;
+    }
+};
+
+void enqueue(Logger::Level level, const char *file, int line, const QString &text)
+{
+    Writer::instance().push({QDateTime::currentMSecsSinceEpoch(), level,
+                             quintptr(QThread::currentThreadId()), file, line, text});
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    if (type == QtFatalMsg) {
+        // 致命错误同步输出后终止，不能指望写线程
+        Writer::instance().flush();
+        std::fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+        std::abort();
+    }
+
+    Logger::Level level = Logger::Debug;
+    switch (type) {
+    case QtInfoMsg: level = Logger::Info; break;
+    case QtWarningMsg: level = Logger::Warning; break;
+    case QtCriticalMsg: level = Logger::Error; break;
+    default: break;
+    }
+    if (Logger::isEnabled(level)) {
+        enqueue(level, context.file, context.line, message);
+    }
+}
+
+}
+
+std::atomic<int> Logger::detail::level{Logger::Info};
+
+void Logger::setLevel(Level level)
+{
+    detail::level.store(int(level), std::memory_order_relaxed);
+}
+
+bool Logger::setFile(const QString &path, QString *error)
+{
+    return Writer::instance().setFile(path, error);
+}
+
+void Logger::install()
+{
+    const QByteArray name = qgetenv(LOG_LEVEL_ENV).trimmed().toLower();
+    const char *const names[] = {"trace", "debug", "info", "warning", "error", "off"};
+    for (int i = 0; i <= int(Off); ++i) {
+        if (name == names[i]) {
+            setLevel(Level(i));
+        }
+    }
+
+    const QString file = qEnvironmentVariable(LOG_FILE_ENV);
+    QString error;
+    if (!file.isEmpty() && !setFile(file, &error)) {
+        std::fprintf(stderr, "%s\n", error.toLocal8Bit().constData());
+    }
+
+    qInstallMessageHandler(messageHandler);
+}
+
+void Logger::shutdown()
+{
+    qInstallMessageHandler(nullptr);
+    Writer::instance().flush();
+}
+
+QString Logger::preview(const QByteArray &data)
+{
+    if (data.size() <= LOG_PREVIEW_BYTES) {
+        return QString::fromUtf8(data);
+    }
+    // 回退到 UTF-8 字符的起始字节，避免截出半个汉字
+    int end = LOG_PREVIEW_BYTES;
+    while (end > 0 && (uchar(data[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    return QString::fromUtf8(data.constData(), end) + QString("...（共 %1 字节）").arg(data.size());
+}
+
+Logger::Record::Record(Level level, const char *file, int line)
+    : _level(level)
+    , _file(file)
+    , _line(line)
+    , _stream(new QDebug(&_text))
+{
+    _stream->noquote();
+}
+
+Logger::Record::~Record()
+{
+    delete _stream;                     // QDebug 析构时才把内容写入 _text
+    if (_text.endsWith(' ')) {
+        _text.chop(1);                  // QDebug 在每项之后加的空格
+    }
+    enqueue(_level, _file, _line, _text);
+}
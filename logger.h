@@ -0,0 +1,88 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QDebug>
+#include <QString>
+#include <QByteArray>
+
+#include <atomic>
+
+// 分级日志
+// LOG_DEBUG() << ... 的用法与 qDebug() 相同，区别在于：
+//   - 低于 SMARTLEARN_LOG_MIN_LEVEL 的语句在编译期去掉，参数不会求值（发布版本只保留 Info 及以上）；
+//   - 低于运行时级别（环境变量 SMARTLEARN_LOG_LEVEL，默认 info）的语句同样不求值、不格式化；
+//   - 格式化后的记录交给后台线程写入 stderr 和日志文件（SMARTLEARN_LOG_FILE），界面线程不等待 I/O。
+// 报文用 Logger::preview() 输出，只保留开头一段。
+// install() 之后 qDebug() 等也经由同一个写线程输出。
+
+#ifndef SMARTLEARN_LOG_MIN_LEVEL
+#ifdef QT_NO_DEBUG
+#define SMARTLEARN_LOG_MIN_LEVEL 2      // Info
+#else
+#define SMARTLEARN_LOG_MIN_LEVEL 1      // Debug
+#endif
+#endif
+
+namespace Logger {
+
+enum Level {
+    Trace = 0,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+namespace detail {
+extern std::atomic<int> level;
+}
+
+inline bool isEnabled(Level level)
+{
+    return int(level) >= detail::level.load(std::memory_order_relaxed);
+}
+
+void setLevel(Level level);
+bool setFile(const QString &path, QString *error = nullptr);   // 空路径表示只写 stderr
+
+// 按环境变量设置级别和日志文件，启动写线程并接管 Qt 的消息输出
+void install();
+// 写完队列中的记录并恢复 Qt 默认的消息输出；程序退出前调用
+void shutdown();
+
+// 报文预览：超过 LOG_PREVIEW_BYTES 时截断（不拆开 UTF-8 字符）并注明总长度
+QString preview(const QByteArray &data);
+
+// 一条日志：析构时把内容交给写线程
+class Record
+{
+public:
+    Record(Level level, const char *file, int line);
+    ~Record();
+
+    QDebug &stream() { return *_stream; }
+
+private:
+    Q_DISABLE_COPY(Record)
+
+    Level _level;
+    const char *_file;
+    int _line;
+    QString _text;
+    QDebug *_stream;
+};
+
+}
+
+#define SMARTLEARN_LOG(level) \
+    if (int(level) < SMARTLEARN_LOG_MIN_LEVEL || !Logger::isEnabled(level)) {} \
+    else Logger::Record(level, __FILE__, __LINE__).stream()
+
+#define LOG_TRACE() SMARTLEARN_LOG(Logger::Trace)
+#define LOG_DEBUG() SMARTLEARN_LOG(Logger::Debug)
+#define LOG_INFO() SMARTLEARN_LOG(Logger::Info)
+#define LOG_WARNING() SMARTLEARN_LOG(Logger::Warning)
+#define LOG_ERROR() SMARTLEARN_LOG(Logger::Error)
+
+#endif // LOGGER_H
@@ -4,18 +4,40 @@
 #include "config.h"
 #include "registerdialog.h"
 #include "knowledgedialog.h"
+#include "tracer.h"
+#include "logger.h"
+#include "metrics.h"
+#include "messages.h"
+#include "capture.h"
 
 #include <QFile>
-#include <QDebug>
 #include <QMessageBox>
 #include <QStyle>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QJsonArray>
+#include <QSettings>
+#include <QStandardPaths>
+
+namespace {
+
+const char BatchSupportKey[] = "server/batch";
+
+QString clientSettingsPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/" + CLIENT_SETTINGS_FILE;
+}
+
+}
 
 LoginDialog::LoginDialog(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::LoginDialog)
+    , _batchSupport(BatchSupport::Unknown)
+    , _batchPending(false)
+    , _fallbackSent(false)
+    , _discardLoginReply(false)
+    , _hasKnowledge(false)
+    , _knowledgeFields(0)
 {
     ui->setupUi(this);
     setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
@@ -27,7 +49,7 @@ LoginDialog::LoginDialog(QWidget *parent)
         this->setStyleSheet(style);
         qss.close();
     } else {
-        qDebug() << "qss打开失败";
+        LOG_WARNING() << "qss打开失败";
     }
 
     // 设置图片
@@ -51,6 +73,17 @@ LoginDialog::LoginDialog(QWidget *parent)
     // 连接服务器响应信号槽
     connect(_client, &QTcpSocket::readyRead,
             this, &LoginDialog::SlotReadFromServer);
+
+    _batchTimer.setSingleShot(true);
+    _batchTimer.setInterval(BATCH_FALLBACK_MS);
+    connect(&_batchTimer, &QTimer::timeout, this, &LoginDialog::onBatchTimeout);
+
+    const QString support = QSettings(clientSettingsPath(), QSettings::IniFormat).value(BatchSupportKey).toString();
+    if (support == "supported") {
+        _batchSupport = BatchSupport::Supported;
+    } else if (support == "unsupported") {
+        _batchSupport = BatchSupport::Unsupported;
+    }
 }
 
 LoginDialog::~LoginDialog()
@@ -63,19 +96,87 @@ QString LoginDialog::getUser()
     return _user;
 }
 
+const Messages::KnowledgeResponse *LoginDialog::knowledge(quint32 *fields) const
+{
+    if (!_hasKnowledge) {
+        return nullptr;
+    }
+    if (fields) *fields = _knowledgeFields;
+    return &_knowledge;
+}
+
 void LoginDialog::on_login_btn_clicked()
 {
+    if (_batchPending || _discardLoginReply) {
+        return;                         // 上一次登录还在等待回复
+    }
     _user = ui->user->text();
     _pass = ui->password->text();
-    QJsonObject jsonobj;
-    jsonobj.insert("type", LoginType);
-    jsonobj.insert("user", ui->user->text());
-    jsonobj.insert("password", ui->password->text());
-    QJsonDocument jsondoc(jsonobj);
-    _client->write(jsondoc.toJson());
+    if (_batchSupport == BatchSupport::Unsupported) {
+        sendLogin();
+    } else {
+        sendLoginBatch();
+    }
+}
+
+void LoginDialog::setBatchSupport(BatchSupport support)
+{
+    if (_batchSupport == support) {
+        return;
+    }
+    _batchSupport = support;
+    QSettings settings(clientSettingsPath(), QSettings::IniFormat);
+    settings.setValue(BatchSupportKey, support == BatchSupport::Supported ? "supported" : "unsupported");
+}
+
+void LoginDialog::sendLogin()
+{
+    Messages::LoginRequest request;
+    request.user = _user;
+    request.password = _pass;
+    const QByteArray data = Messages::encode(request);
+    Capture::sent(data);
+    _client->write(data);
     _client->flush();
 }
 
+void LoginDialog::sendLoginBatch()
+{
+    Messages::LoginRequest login;
+    login.user = _user;
+    login.password = _pass;
+    Messages::GetKnowledgeRequest knowledge;
+    knowledge.username = _user;
+
+    Messages::Batch batch;
+    batch.add(login);
+    batch.add(knowledge);
+    const QByteArray data = batch.encode();
+
+    _batchRoundTrip.reset(new Metrics::RoundTrip(BatchType));
+    Capture::sent(data);
+    _batchRoundTrip->sent(_client->write(data));
+    _client->flush();
+    _batchPending = true;
+    _fallbackSent = false;
+    // 还不知道服务器是否支持时才设超时；已知支持时一直等，高延迟链路上也只有一次往返
+    if (_batchSupport == BatchSupport::Unknown) {
+        _batchTimer.start();
+    }
+}
+
+void LoginDialog::onBatchTimeout()
+{
+    if (!_batchPending || _fallbackSent) {
+        return;
+    }
+    // 旧服务器可能不回复不认识的消息：再逐条发送登录，批量回复仍然有效。
+    // 同一连接上回复按发送顺序到达，先到的是批量回复说明支持，先到的是登录回复说明不支持
+    LOG_WARNING() << "批量请求" << BATCH_FALLBACK_MS << "ms 内没有回复，同时逐条发送登录";
+    _fallbackSent = true;
+    sendLogin();
+}
+
 void LoginDialog::on_register_btn_clicked()
 {
     // 断开LoginDialog的信号连接，避免与RegisterDialog冲突
@@ -103,84 +204,171 @@ void LoginDialog::on_register_btn_clicked()
 // 处理server回复
 void LoginDialog::SlotReadFromServer()
 {
+    TRACE_SCOPE("LoginDialog::SlotReadFromServer");
     QByteArray data = _client->readAll();
-    qDebug() << "LoginDialog收到数据:" << data;
+    Capture::received(data);
+    LOG_DEBUG() << "LoginDialog收到数据:" << Logger::preview(data);
+
+    _reader.append(data);
+    QByteArray reply;
+    while (_reader.next(&reply)) {
+        handleReply(reply);
+    }
+}
+
+void LoginDialog::handleReply(const QByteArray &reply)
+{
+    if (_discardLoginReply) {
+        // 试探时补发的逐条登录的回复，批量结果已经包含
+        _discardLoginReply = false;
+        onBatchResults(_batchResults);
+        return;
+    }
+
+    if (_batchPending) {
+        QList<QByteArray> results;
+        bool parsed;
+        {
+            TRACE_SCOPE("json.parse");
+            parsed = Messages::decodeBatch(reply, &results);
+        }
+        _batchPending = false;
+        _batchTimer.stop();
+
+        if (parsed && !results.isEmpty()) {
+            _batchRoundTrip->received(reply.size());
+            _batchRoundTrip.reset();
+            setBatchSupport(BatchSupport::Supported);
+            if (_fallbackSent) {
+                _batchResults = results;
+                _discardLoginReply = true;
+                return;
+            }
+            onBatchResults(results);
+            return;
+        }
+
+        // 服务器不认识批量请求
+        LOG_WARNING() << "服务器不支持批量请求，改为逐条发送";
+        _batchRoundTrip.reset();
+        setBatchSupport(BatchSupport::Unsupported);
+        if (!_fallbackSent) {
+            sendLogin();                // 这是对批量请求的回复，丢弃
+            return;
+        }
+        // 已补发逐条登录：回复是 "yes"/"no" 时就是登录的回复；
+        // 否则是旧服务器对批量请求的回复，按下面的连接错误记录后继续等登录的回复
+    }
 
     // 检查是否为JSON格式的响应
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(data);
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(reply);
     if (!jsonDoc.isNull() && jsonDoc.isObject()) {
         QJsonObject jsonObj = jsonDoc.object();
         QString type = jsonObj["type"].toString();
-        qDebug() << "LoginDialog收到的JSON类型:" << type;
-        // 如果是注册响应或知识库响应，不处理
-        if (type == "RegisterResponse" || type == "KnowledgeResponse") {
-            qDebug() << "LoginDialog忽略" << type << "消息";
+        LOG_DEBUG() << "LoginDialog收到的JSON类型:" << type;
+        // 如果是注册响应、知识库响应或超时后才到的批量响应，不处理
+        if (type == "RegisterResponse" || type == "KnowledgeResponse" || type == "BatchResponse") {
+            LOG_DEBUG() << "LoginDialog忽略" << type << "消息";
             return;
         }
     }
 
     // 处理登录响应
-    QString reply = QString::fromUtf8(data);
-    if (reply == "yes") {
-        qDebug() << "登录成功，检查用户知识库状态";
+    const QString text = QString::fromUtf8(reply);
+    if (text == "yes") {
+        LOG_DEBUG() << "登录成功，检查用户知识库状态";
+        onLoggedIn(nullptr);
+    } else if (text == "no") {
+        ui->message_label->setText(tr("    用户名或密码错误"));
+    } else {
+        LOG_WARNING() << "连接错误: " << text;
+    }
+}
+
+void LoginDialog::onBatchResults(const QList<QByteArray> &results)
+{
+    const QString login = QString::fromUtf8(results[0]);
+    if (login == "yes") {
+        LOG_DEBUG() << "登录成功，知识库状态随批量回复返回";
+        onLoggedIn(results.size() > 1 ? &results[1] : nullptr);
+    } else if (login == "no") {
+        ui->message_label->setText(tr("    用户名或密码错误"));
+    } else {
+        LOG_WARNING() << "连接错误: " << login;
+    }
+}
 
-        // 断开LoginDialog的信号连接，避免冲突
-        disconnect(_client, &QTcpSocket::readyRead, this, &LoginDialog::SlotReadFromServer);
+void LoginDialog::onLoggedIn(const QByteArray *knowledgeReply)
+{
+    // 断开LoginDialog的信号连接，避免冲突；之后的数据交给知识库对话框和主窗口
+    disconnect(_client, &QTcpSocket::readyRead, this, &LoginDialog::SlotReadFromServer);
+    _reader.clear();
 
+    QByteArray responseData;
+    bool ready = true;
+    if (knowledgeReply) {
+        responseData = *knowledgeReply;
+    } else {
         // 先查询用户是否已有知识库数据
-        QJsonObject json;
-        json["type"] = GetKnowledgeType;
-        json["username"] = _user;
-        QJsonDocument doc(json);
-        _client->write(doc.toJson());
+        Messages::GetKnowledgeRequest request;
+        request.username = _user;
+        Metrics::RoundTrip roundTrip(GetKnowledgeType);
+        const QByteArray requestData = Messages::encode(request);
+        Capture::sent(requestData);
+        roundTrip.sent(_client->write(requestData));
         _client->flush();
 
         // 等待知识库响应
-        if (_client->waitForReadyRead(3000)) {
-            QByteArray responseData = _client->readAll();
-            QJsonDocument responseDoc = QJsonDocument::fromJson(responseData);
-
-            if (!responseDoc.isNull() && responseDoc.isObject()) {
-                QJsonObject responseJson = responseDoc.object();
-                QString type = responseJson["type"].toString();
-                QString status = responseJson["status"].toString();
-
-                if (type == "KnowledgeResponse" && status == "success") {
-                    QJsonArray knowledgeArray = responseJson["knowledge_points"].toArray();
-
-                    if (knowledgeArray.isEmpty()) {
-                        // 用户没有知识库数据，弹出填写对话框
-                        qDebug() << "用户无知识库数据，打开填写对话框";
-                        KnowledgeDialog knowledgeDlg(_user, this);
-                        knowledgeDlg.exec();
-                    } else {
-                        qDebug() << "用户已有知识库数据，直接进入主窗口";
-                    }
-                } else {
-                    // 查询失败，默认弹出填写对话框
-                    qDebug() << "查询知识库失败，打开填写对话框";
+        {
+            TRACE_SCOPE("net.wait");
+            ready = _client->waitForReadyRead(3000);
+        }
+        if (ready) {
+            responseData = _client->readAll();
+            Capture::received(responseData);
+            roundTrip.received(responseData.size());
+        }
+    }
+
+    if (ready) {
+        Messages::KnowledgeResponse reply;
+        bool parsed;
+        {
+            TRACE_SCOPE("json.parse");
+            parsed = Messages::decode(responseData, &reply, &_knowledgeFields);
+        }
+
+        if (parsed) {
+            if (reply.status == "success") {
+                if (reply.knowledgePoints.isEmpty()) {
+                    // 用户没有知识库数据，弹出填写对话框
+                    LOG_DEBUG() << "用户无知识库数据，打开填写对话框";
                     KnowledgeDialog knowledgeDlg(_user, this);
                     knowledgeDlg.exec();
+                } else {
+                    LOG_DEBUG() << "用户已有知识库数据，直接进入主窗口";
+                    _knowledge = reply;
+                    _hasKnowledge = true;
                 }
             } else {
-                // 响应解析失败，默认弹出填写对话框
-                qDebug() << "知识库响应解析失败，打开填写对话框";
+                // 查询失败，默认弹出填写对话框
+                LOG_WARNING() << "查询知识库失败，打开填写对话框";
                 KnowledgeDialog knowledgeDlg(_user, this);
                 knowledgeDlg.exec();
             }
         } else {
-            // 查询超时，默认弹出填写对话框
-            qDebug() << "查询知识库超时，打开填写对话框";
+            // 响应解析失败，默认弹出填写对话框
+            LOG_WARNING() << "知识库响应解析失败，打开填写对话框";
             KnowledgeDialog knowledgeDlg(_user, this);
             knowledgeDlg.exec();
         }
-
-        // 登录成功，对话框即将关闭，不需要重新连接信号
-        accept();
-    } else if (reply == "no") {
-        ui->message_label->setText(tr("    用户名或密码错误"));
     } else {
-        qDebug() << "连接错误: " << reply;
+        // 查询超时，默认弹出填写对话框
+        LOG_WARNING() << "查询知识库超时，打开填写对话框";
+        KnowledgeDialog knowledgeDlg(_user, this);
+        knowledgeDlg.exec();
     }
-}
 
+    // 登录成功，对话框即将关闭，不需要重新连接信号
+    accept();
+}
@@ -1,8 +1,17 @@
 #ifndef LOGINDIALOG_H
 #define LOGINDIALOG_H
 
+#include "jsonframereader.h"
+#include "messages.h"
+
 #include <QDialog>
 #include <QTcpServer>
+#include <QTimer>
+#include <QScopedPointer>
+
+namespace Metrics {
+class RoundTrip;
+}
 
 namespace Ui {
 class LoginDialog;
@@ -16,12 +25,39 @@ public:
     explicit LoginDialog(QWidget *parent = nullptr);
     ~LoginDialog();
     QString getUser();
+    // 登录时随批量回复（或登录后单独查询）取到的知识库，主窗口直接使用，不再查询；
+    // 没有取到或之后又打开了填写对话框时返回空，fields 为 Messages::decode 的 present
+    const Messages::KnowledgeResponse *knowledge(quint32 *fields) const;
 
 private:
     Ui::LoginDialog *ui;
     QString _user;
     QString _pass;
     QTcpSocket *_client;
+    JsonFrameReader _reader;            // 把收到的数据切分成完整的回复
+
+    // 登录和查询知识库合成一个批量请求，一次往返进入主窗口
+    // 服务器是否支持批量请求记在用户数据目录下，只在第一次连接时试探
+    enum class BatchSupport { Unknown, Supported, Unsupported };
+    BatchSupport _batchSupport;
+    bool _batchPending;                 // 正在等待批量请求的回复
+    bool _fallbackSent;                 // 试探超时后又逐条发送了登录
+    bool _discardLoginReply;            // 批量回复已到，还需读掉逐条登录的回复
+    QList<QByteArray> _batchResults;    // 等待读掉逐条登录回复时暂存的批量结果
+    QTimer _batchTimer;
+    QScopedPointer<Metrics::RoundTrip> _batchRoundTrip;
+
+    bool _hasKnowledge;
+    Messages::KnowledgeResponse _knowledge;
+    quint32 _knowledgeFields;
+
+    void sendLogin();                   // 逐条发送：登录成功后再查询知识库
+    void sendLoginBatch();
+    void handleReply(const QByteArray &reply);
+    void onBatchTimeout();
+    void onBatchResults(const QList<QByteArray> &results);
+    void setBatchSupport(BatchSupport support);
+    void onLoggedIn(const QByteArray *knowledgeReply);  // knowledgeReply 为空时单独查询知识库
 
 signals:
     void SigLogin(const QString&);
@@ -1,20 +1,52 @@
 #include "mainwindow.h"
 #include "logindialog.h"
+#include "logger.h"
+#include "tracer.h"
+#include "capture.h"
+#include "stallwatchdog.h"
+#include "config.h"
 
 #include <QApplication>
-#include <QDebug>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    Logger::install();
+
+    // 设置了追踪文件时记录热点路径，退出时导出
+    const QString tracePath = qEnvironmentVariable(TRACE_FILE_ENV);
+    Tracer::setEnabled(!tracePath.isEmpty());
+
+    // 设置了录制文件时记录与服务器的全部收发
+    const QString capturePath = qEnvironmentVariable(CAPTURE_FILE_ENV);
+    QString error;
+    if (!capturePath.isEmpty() && !Capture::start(capturePath, &error)) {
+        LOG_WARNING() << error;
+    }
+
+    // 检测界面线程的卡顿，登录对话框里的阻塞调用也在内
+    StallWatchdog watchdog;
+
     LoginDialog login;
-    MainWindow w;
 
+    int result = 0;
     if (login.exec() == QDialog::Accepted) {
+        // 登录后才知道用户名，主窗口在此时创建
+        // 登录时已取到的知识库直接交给主窗口，进入主窗口不再等待网络
+        quint32 knowledgeFields = 0;
+        const Messages::KnowledgeResponse *knowledge = login.knowledge(&knowledgeFields);
+        MainWindow w(login.getUser(), knowledge, knowledgeFields);
         w.show();
-    } else {
-        return 0; // 直接关闭login
+        result = a.exec();
     }
+    // 否则直接关闭login
 
-    return a.exec();
+    Capture::stop();
+    if (!tracePath.isEmpty()) {
+        if (!Tracer::writeChromeTrace(tracePath, &error)) {
+            LOG_WARNING() << error;
+        }
+    }
+    Logger::shutdown();
+    return result;
 }
@@ -2,6 +2,21 @@
 #include "ui_mainwindow.h"
 #include "knowledgedialog.h"
 #include "connectmanager.h"
+#include "pathgraphview.h"
+#include "chatpage.h"
+#include "resourceindex.h"
+#include "embeddingindex.h"
+#include "cfrecommender.h"
+#include "datafiles.h"
+#include "knowledgecanon.h"
+#include "knowledgetaxonomy.h"
+#include "goalmatcher.h"
+#include "tracer.h"
+#include "logger.h"
+#include "metrics.h"
+#include "capture.h"
+#include "messages.h"
+#include "stallwatchdog.h"
 #include "config.h"
 
 #include <QVBoxLayout>
@@ -9,26 +24,54 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QListWidget>
+#include <QTreeWidget>
+#include <QHeaderView>
 #include <QStackedWidget>
 #include <QWidget>
 #include <QMessageBox>
-#include <QDebug>
 #include <QTcpSocket>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
-
-MainWindow::MainWindow(const QString &username, QWidget *parent)
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QFileInfo>
+#include <QDesktopServices>
+#include <QDateTime>
+#include <QInputDialog>
+#include <QUrl>
+#include <QtConcurrent>
+
+MainWindow::MainWindow(const QString &username, const Messages::KnowledgeResponse *knowledge,
+                       quint32 knowledgeFields, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , _username(username)
+    , _reviewsLoaded(false)
+    , _reviewSyncRetryAt(0)
+    , _reviewSyncBackoffMs(REVIEW_SYNC_BACKOFF_MS)
+    , _deferredRefreshes(0)
+    , _knowledgeLoaded(false)
 {
+    TRACE_SCOPE("MainWindow::MainWindow");
     ui->setupUi(this);
 
     setWindowTitle("SmartLearn - 智能学习路径规划系统");
     resize(1400, 850);
 
     setupUI();
+    loadRecommender();
+    loadTaxonomy();
+    loadGoalMatcher();
+
+    // 推荐和资源检索不必等用户打开知识库页面；登录时没取到知识库才在这里查询。
+    // 复习记录等到打开知识库页面时再同步
+    if (knowledge) {
+        applyKnowledge(*knowledge, knowledgeFields);
+    } else {
+        fetchKnowledge();
+    }
 }
 
 MainWindow::~MainWindow()
@@ -205,6 +248,7 @@ void MainWindow::setupUI()
     createAIChatPage();
     createPathPage();
     createResourcePage();
+    createSettingsPage();
 
     contentLayout->addWidget(_stackedWidget);
 
@@ -219,6 +263,7 @@ void MainWindow::setupUI()
 
 void MainWindow::createHomePage()
 {
+    TRACE_SCOPE("MainWindow::createHomePage");
     _homePage = new QWidget();
     _homePage->setStyleSheet("background-color: white; border-radius: 10px;");
 
@@ -275,6 +320,27 @@ void MainWindow::createHomePage()
     cardsLayout->addWidget(card3);
 
     layout->addLayout(cardsLayout);
+
+    layout->addSpacing(20);
+
+    // 协同过滤推荐
+    _homeSuggestLabel = new QLabel(_homePage);
+    _homeSuggestLabel->setWordWrap(true);
+    _homeSuggestLabel->setTextFormat(Qt::RichText);
+    _homeSuggestLabel->setStyleSheet("font-size: 14px; color: #34495e;");
+    _homeSuggestLabel->hide();
+    connect(_homeSuggestLabel, &QLabel::linkActivated, this, &MainWindow::onSuggestionClicked);
+    layout->addWidget(_homeSuggestLabel);
+
+    // 最匹配的学习目标
+    _homeGoalLabel = new QLabel(_homePage);
+    _homeGoalLabel->setWordWrap(true);
+    _homeGoalLabel->setTextFormat(Qt::RichText);
+    _homeGoalLabel->setStyleSheet("font-size: 14px; color: #34495e;");
+    _homeGoalLabel->hide();
+    connect(_homeGoalLabel, &QLabel::linkActivated, this, &MainWindow::onGoalClicked);
+    layout->addWidget(_homeGoalLabel);
+
     layout->addStretch();
 
     _stackedWidget->addWidget(_homePage);
@@ -282,6 +348,7 @@ void MainWindow::createHomePage()
 
 void MainWindow::createKnowledgePage()
 {
+    TRACE_SCOPE("MainWindow::createKnowledgePage");
     _knowledgePage = new QWidget();
     _knowledgePage->setStyleSheet("background-color: white; border-radius: 10px;");
 
@@ -339,6 +406,40 @@ void MainWindow::createKnowledgePage()
     _knowledgeListWidget->setMaximumHeight(300);
     layout->addWidget(_knowledgeListWidget);
 
+    // 今日复习区域
+    _reviewStatusLabel = new QLabel("今日复习", _knowledgePage);
+    _reviewStatusLabel->setStyleSheet("font-size: 16px; font-weight: bold; color: #34495e;");
+    layout->addWidget(_reviewStatusLabel);
+
+    _reviewListWidget = new QListWidget(_knowledgePage);
+    _reviewListWidget->setStyleSheet(_knowledgeListWidget->styleSheet());
+    _reviewListWidget->setToolTip("双击一个知识点开始复习");
+    _reviewListWidget->setMaximumHeight(160);
+    connect(_reviewListWidget, &QListWidget::itemDoubleClicked, this, &MainWindow::onReviewItemActivated);
+    layout->addWidget(_reviewListWidget);
+
+    // 分类汇总区域
+    QLabel *rollupTitleLabel = new QLabel("按分类汇总", _knowledgePage);
+    rollupTitleLabel->setStyleSheet("font-size: 16px; font-weight: bold; color: #34495e;");
+    layout->addWidget(rollupTitleLabel);
+
+    _knowledgeTreeWidget = new QTreeWidget(_knowledgePage);
+    _knowledgeTreeWidget->setColumnCount(2);
+    _knowledgeTreeWidget->setHeaderLabels(QStringList() << "分类" << "已掌握");
+    _knowledgeTreeWidget->header()->setStretchLastSection(false);
+    _knowledgeTreeWidget->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    _knowledgeTreeWidget->setStyleSheet(
+        "QTreeWidget {"
+        "   border: 1px solid #ddd;"
+        "   border-radius: 8px;"
+        "   background-color: #f8f9fa;"
+        "   color: #2c3e50;"
+        "   font-size: 14px;"
+        "}"
+    );
+    _knowledgeTreeWidget->setMaximumHeight(260);
+    layout->addWidget(_knowledgeTreeWidget);
+
     // 提示标签
     QLabel *tip = new QLabel("点击上方「修改知识库」按钮来更新你的知识点", _knowledgePage);
     tip->setStyleSheet("color: #95a5a6; font-size: 12px; font-style: italic;");
@@ -352,28 +453,15 @@ void MainWindow::createKnowledgePage()
 
 void MainWindow::createAIChatPage()
 {
-    _aiChatPage = new QWidget();
-    _aiChatPage->setStyleSheet("background-color: white; border-radius: 10px;");
-
-    QVBoxLayout *layout = new QVBoxLayout(_aiChatPage);
-    layout->setContentsMargins(30, 30, 30, 30);
-
-    QLabel *title = new QLabel("AI 学习助手", _aiChatPage);
-    title->setStyleSheet("font-size: 24px; font-weight: bold; color: #2c3e50;");
-    layout->addWidget(title);
-
-    QLabel *content = new QLabel("AI对话功能开发中...\n\n敬请期待！", _aiChatPage);
-    content->setStyleSheet("color: #7f8c8d; font-size: 16px;");
-    content->setAlignment(Qt::AlignCenter);
-    layout->addWidget(content);
-
-    layout->addStretch();
-
+    TRACE_SCOPE("MainWindow::createAIChatPage");
+    _aiChatPage = new ChatPage(_username);
     _stackedWidget->addWidget(_aiChatPage);
+    connect(_aiChatPage, &ChatPage::streamFinished, this, &MainWindow::runDeferredRefreshes);
 }
 
 void MainWindow::createPathPage()
 {
+    TRACE_SCOPE("MainWindow::createPathPage");
     _pathPage = new QWidget();
     _pathPage->setStyleSheet("background-color: white; border-radius: 10px;");
 
@@ -384,18 +472,33 @@ void MainWindow::createPathPage()
     title->setStyleSheet("font-size: 24px; font-weight: bold; color: #2c3e50;");
     layout->addWidget(title);
 
-    QLabel *content = new QLabel("学习路径规划功能开发中...\n\n敬请期待！", _pathPage);
-    content->setStyleSheet("color: #7f8c8d; font-size: 16px;");
-    content->setAlignment(Qt::AlignCenter);
-    layout->addWidget(content);
+    _pathStatusLabel = new QLabel("暂无学习路径数据", _pathPage);
+    _pathStatusLabel->setStyleSheet("color: #7f8c8d; font-size: 14px;");
+    layout->addWidget(_pathStatusLabel);
 
-    layout->addStretch();
+    _pathRollupLabel = new QLabel(_pathPage);
+    _pathRollupLabel->setStyleSheet("color: #34495e; font-size: 14px;");
+    _pathRollupLabel->setWordWrap(true);
+    _pathRollupLabel->hide();
+    layout->addWidget(_pathRollupLabel);
+
+    // 路径图：拖动平移，滚轮缩放
+    _pathView = new PathGraphView(_pathPage);
+    _pathView->setStyleSheet("border: 1px solid #ddd; border-radius: 8px;");
+    layout->addWidget(_pathView, 1);
+
+    connect(_pathView, &PathGraphView::layoutFinished, this,
+            [this](int nodeCount, int layerCount, qint64 elapsedMs) {
+                _pathStatusLabel->setText(QString("共 %1 个知识点，%2 个阶段（布局耗时 %3 ms）  拖动平移，滚轮缩放")
+                                              .arg(nodeCount).arg(layerCount).arg(elapsedMs));
+            });
 
     _stackedWidget->addWidget(_pathPage);
 }
 
 void MainWindow::createResourcePage()
 {
+    TRACE_SCOPE("MainWindow::createResourcePage");
     _resourcePage = new QWidget();
     _resourcePage->setStyleSheet("background-color: white; border-radius: 10px;");
 
@@ -406,12 +509,88 @@ void MainWindow::createResourcePage()
     title->setStyleSheet("font-size: 24px; font-weight: bold; color: #2c3e50;");
     layout->addWidget(title);
 
-    QLabel *content = new QLabel("学习资源推荐功能开发中...\n\n敬请期待！", _resourcePage);
-    content->setStyleSheet("color: #7f8c8d; font-size: 16px;");
-    content->setAlignment(Qt::AlignCenter);
-    layout->addWidget(content);
+    // 搜索框：留空时按知识缺口推荐
+    _resourceSearchEdit = new QLineEdit(_resourcePage);
+    _resourceSearchEdit->setPlaceholderText("搜索资源（留空则根据你的学习目标和未掌握的知识点推荐）");
+    _resourceSearchEdit->setStyleSheet(
+        "padding: 10px; border: 2px solid #ddd; border-radius: 6px; font-size: 14px;"
+    );
+    layout->addWidget(_resourceSearchEdit);
+
+    _resourceSuggestLabel = new QLabel(_resourcePage);
+    _resourceSuggestLabel->setWordWrap(true);
+    _resourceSuggestLabel->setTextFormat(Qt::RichText);
+    _resourceSuggestLabel->setStyleSheet("font-size: 13px; color: #34495e;");
+    _resourceSuggestLabel->hide();
+    connect(_resourceSuggestLabel, &QLabel::linkActivated, this, &MainWindow::onSuggestionClicked);
+    layout->addWidget(_resourceSuggestLabel);
+
+    _resourceStatusLabel = new QLabel("资源目录尚未加载", _resourcePage);
+    _resourceStatusLabel->setStyleSheet("color: #7f8c8d; font-size: 12px;");
+    layout->addWidget(_resourceStatusLabel);
+
+    _resourceList = new QListWidget(_resourcePage);
+    _resourceList->setStyleSheet(
+        "QListWidget {"
+        "   border: 1px solid #ddd;"
+        "   border-radius: 8px;"
+        "   background-color: #f8f9fa;"
+        "   padding: 5px;"
+        "}"
+        "QListWidget::item {"
+        "   padding: 10px;"
+        "   margin: 2px;"
+        "   border-radius: 5px;"
+        "   background-color: white;"
+        "   color: #2c3e50;"
+        "   font-size: 14px;"
+        "}"
+        "QListWidget::item:selected {"
+        "   background-color: #2196F3;"
+        "   color: white;"
+        "}"
+    );
+    layout->addWidget(_resourceList, 2);
 
-    layout->addStretch();
+    _similarTitleLabel = new QLabel("与你的学习画像相似的资源", _resourcePage);
+    _similarTitleLabel->setStyleSheet("font-size: 16px; font-weight: bold; color: #34495e;");
+    layout->addWidget(_similarTitleLabel);
+
+    _similarList = new QListWidget(_resourcePage);
+    _similarList->setStyleSheet(_resourceList->styleSheet());
+    layout->addWidget(_similarList, 1);
+
+    // 没有资源向量文件时不显示相似推荐
+    _similarTitleLabel->hide();
+    _similarList->hide();
+
+    QLabel *tip = new QLabel("双击资源在浏览器中打开", _resourcePage);
+    tip->setStyleSheet("color: #95a5a6; font-size: 12px; font-style: italic;");
+    tip->setAlignment(Qt::AlignCenter);
+    layout->addWidget(tip);
+
+    connect(_resourceSearchEdit, &QLineEdit::returnPressed, this, [this]() {
+        QString query = _resourceSearchEdit->text().trimmed();
+        searchResources(query.isEmpty() ? knowledgeGapQuery() : query);
+    });
+    auto openResource = [](QListWidgetItem *item) {
+        QString url = item->data(Qt::UserRole).toString();
+        if (!url.isEmpty()) {
+            QDesktopServices::openUrl(QUrl(url));
+        }
+    };
+    connect(_resourceList, &QListWidget::itemDoubleClicked, this, openResource);
+    connect(_similarList, &QListWidget::itemDoubleClicked, this, openResource);
+    connect(&_resourceIndexWatcher, &QFutureWatcher<QSharedPointer<ResourceIndex>>::finished,
+            this, &MainWindow::onResourceIndexLoaded);
+    connect(&_embeddingWatcher, &QFutureWatcher<QSharedPointer<EmbeddingIndex>>::finished,
+            this, [this]() {
+                _embeddingIndex = _embeddingWatcher.result();
+                if (_embeddingIndex && _resourceIndex
+                    && _stackedWidget->currentWidget() == _resourcePage) {
+                    refreshResourcePage();
+                }
+            });
 
     _stackedWidget->addWidget(_resourcePage);
 }
@@ -455,8 +634,200 @@ QWidget* MainWindow::createFeatureCard(const QString &icon, const QString &title
     return card;
 }
 
+void MainWindow::createSettingsPage()
+{
+    TRACE_SCOPE("MainWindow::createSettingsPage");
+    _settingsPage = new QWidget();
+    _settingsPage->setStyleSheet("background-color: white; border-radius: 10px;");
+
+    QVBoxLayout *layout = new QVBoxLayout(_settingsPage);
+    layout->setContentsMargins(30, 30, 30, 30);
+
+    QLabel *title = new QLabel("运行状态", _settingsPage);
+    title->setStyleSheet("font-size: 24px; font-weight: bold; color: #2c3e50;");
+    layout->addWidget(title);
+
+    _connectionLabel = new QLabel(_settingsPage);
+    _connectionLabel->setStyleSheet("font-size: 14px; color: #34495e;");
+    layout->addWidget(_connectionLabel);
+
+    // 按消息类型统计的网络请求
+    _netMetricsTree = new QTreeWidget(_settingsPage);
+    _netMetricsTree->setColumnCount(7);
+    _netMetricsTree->setHeaderLabels(QStringList() << "消息类型" << "请求" << "超时" << "发送"
+                                                   << "接收" << "RTT p50" << "RTT p95");
+    _netMetricsTree->setRootIsDecorated(false);
+    _netMetricsTree->header()->setStretchLastSection(false);
+    _netMetricsTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    _netMetricsTree->setStyleSheet(
+        "QTreeWidget {"
+        "   border: 1px solid #ddd;"
+        "   border-radius: 8px;"
+        "   background-color: #f8f9fa;"
+        "   color: #2c3e50;"
+        "   font-size: 13px;"
+        "}"
+    );
+    _netMetricsTree->setMaximumHeight(240);
+    layout->addWidget(_netMetricsTree);
+
+    QLabel *histogramTitle = new QLabel("往返时间分布（全部消息类型）", _settingsPage);
+    histogramTitle->setStyleSheet("font-size: 16px; font-weight: bold; color: #2c3e50; margin-top: 10px;");
+    layout->addWidget(histogramTitle);
+
+    _rttHistogramLabel = new QLabel(_settingsPage);
+    _rttHistogramLabel->setStyleSheet(
+        "font-family: monospace; font-size: 12px; color: #34495e;"
+        "background-color: #f8f9fa; border: 1px solid #ddd; padding: 8px;"
+    );
+    layout->addWidget(_rttHistogramLabel);
+
+    _runtimeMetricsLabel = new QLabel(_settingsPage);
+    _runtimeMetricsLabel->setStyleSheet("font-size: 14px; color: #34495e;");
+    layout->addWidget(_runtimeMetricsLabel);
+
+    // 历次卡顿按操作汇总，优先处理累计最久的
+    QLabel *stallTitle = new QLabel("界面卡顿最多的操作", _settingsPage);
+    stallTitle->setStyleSheet("font-size: 16px; font-weight: bold; color: #2c3e50; margin-top: 10px;");
+    layout->addWidget(stallTitle);
+
+    _stallTree = new QTreeWidget(_settingsPage);
+    _stallTree->setColumnCount(4);
+    _stallTree->setHeaderLabels(QStringList() << "操作" << "次数" << "累计" << "最长");
+    _stallTree->setRootIsDecorated(false);
+    _stallTree->header()->setStretchLastSection(false);
+    _stallTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    _stallTree->setStyleSheet(
+        "QTreeWidget {"
+        "   border: 1px solid #ddd;"
+        "   border-radius: 8px;"
+        "   background-color: #f8f9fa;"
+        "   color: #2c3e50;"
+        "   font-size: 13px;"
+        "}"
+    );
+    _stallTree->setMaximumHeight(180);
+    layout->addWidget(_stallTree);
+
+    layout->addStretch();
+
+    _metricsTimer.setInterval(1000);
+    connect(&_metricsTimer, &QTimer::timeout, this, &MainWindow::refreshMetrics);
+
+    _stackedWidget->addWidget(_settingsPage);
+}
+
+void MainWindow::refreshMetrics()
+{
+    TRACE_SCOPE("MainWindow::refreshMetrics");
+
+    auto bytes = [](quint64 n) {
+        if (n < 1024) return QString("%1 B").arg(n);
+        if (n < 1024 * 1024) return QString("%1 KB").arg(n / 1024.0, 0, 'f', 1);
+        return QString("%1 MB").arg(n / (1024.0 * 1024.0), 0, 'f', 1);
+    };
+    auto millis = [](qint64 micros) {
+        return QString("%1 ms").arg(micros / 1000.0, 0, 'f', micros < 10000 ? 2 : 0);
+    };
+
+    // 连接状态
+    const char *state = "未连接";
+    switch (ConnectManager::getInstance().getSocket()->state()) {
+    case QAbstractSocket::HostLookupState:
+    case QAbstractSocket::ConnectingState: state = "正在连接"; break;
+    case QAbstractSocket::ConnectedState: state = "已连接"; break;
+    case QAbstractSocket::ClosingState: state = "正在断开"; break;
+    default: break;
+    }
+    _connectionLabel->setText(QString("服务器 %1:%2  %3    连接 %4 次，断开 %5 次，连接失败 %6 次")
+                                  .arg(HOSTNAME).arg(PORT).arg(state)
+                                  .arg(Metrics::counter("net.connects").value())
+                                  .arg(Metrics::counter("net.disconnects").value())
+                                  .arg(Metrics::counter("net.connect_failures").value()));
+
+    // 每种消息类型一行，往返时间按所有类型合并成一张分布
+    _netMetricsTree->clear();
+    quint64 merged[Metrics::Histogram::Buckets] = {};
+    quint64 mergedCount = 0;
+    const QStringList names = Metrics::counterNames();
+    for (const QString &name : names) {
+        if (!name.startsWith("net.") || !name.endsWith(".requests")) continue;
+        const QString type = name.mid(4, name.size() - 4 - 9);
+        const QString prefix = "net." + type;
+        const Metrics::Histogram &rtt = Metrics::histogram(prefix + ".rtt");
+
+        QTreeWidgetItem *item = new QTreeWidgetItem(_netMetricsTree);
+        item->setText(0, type);
+        item->setText(1, QString::number(Metrics::counter(name).value()));
+        item->setText(2, QString::number(Metrics::counter(prefix + ".timeouts").value()));
+        item->setText(3, bytes(Metrics::counter(prefix + ".bytes_out").value()));
+        item->setText(4, bytes(Metrics::counter(prefix + ".bytes_in").value()));
+        item->setText(5, rtt.count() ? millis(rtt.percentile(50)) : "-");
+        item->setText(6, rtt.count() ? millis(rtt.percentile(95)) : "-");
+        for (int column = 1; column < 7; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+
+        for (int i = 0; i < Metrics::Histogram::Buckets; ++i) {
+            merged[i] += rtt.bucket(i);
+        }
+        mergedCount += rtt.count();
+    }
+
+    // 只画有样本的桶范围，条长按最大的桶缩放
+    if (mergedCount == 0) {
+        _rttHistogramLabel->setText("暂无请求");
+    } else {
+        int first = 0;
+        int last = Metrics::Histogram::Buckets - 1;
+        while (merged[first] == 0) ++first;
+        while (merged[last] == 0) --last;
+        quint64 peak = 0;
+        for (int i = first; i <= last; ++i) peak = qMax(peak, merged[i]);
+
+        QStringList lines;
+        for (int i = first; i <= last; ++i) {
+            const int width = int((merged[i] * 40 + peak - 1) / peak);
+            lines << QString("≤ %1 %2 %3")
+                         .arg(millis(Metrics::Histogram::bucketUpper(i)), 10)
+                         .arg(QString(width, QChar(0x2588)), -40)
+                         .arg(merged[i]);
+        }
+        _rttHistogramLabel->setText(lines.join('\n'));
+    }
+
+    // 在途请求、缓存命中率和界面卡顿
+    const Metrics::Gauge &inFlight = Metrics::gauge("net.in_flight");
+    const quint64 hits = Metrics::counter("cache.answer.hits").value();
+    const quint64 misses = Metrics::counter("cache.answer.misses").value();
+    const Metrics::Histogram &lag = Metrics::histogram("ui.loop_lag");
+    _runtimeMetricsLabel->setText(
+        QString("在途请求：%1（最多 %2）\nAI 回答缓存命中率：%3（%4/%5）\n界面卡顿（超过 %6 ms）：%7 次，事件循环延迟 p99：%8")
+            .arg(inFlight.value()).arg(inFlight.max())
+            .arg(hits + misses ? QString("%1%").arg(100.0 * hits / (hits + misses), 0, 'f', 1) : QString("-"))
+            .arg(hits).arg(hits + misses)
+            .arg(StallWatchdog::thresholdMs())
+            .arg(Metrics::counter("ui.stalls").value())
+            .arg(lag.count() ? millis(lag.percentile(99)) : QString("-")));
+
+    _stallTree->clear();
+    const QVector<StallWatchdog::Offender> offenders = StallWatchdog::offenders();
+    for (int i = 0; i < offenders.size() && i < 10; ++i) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(_stallTree);
+        item->setText(0, offenders[i].operation);
+        item->setToolTip(0, offenders[i].operation);
+        item->setText(1, QString::number(offenders[i].count));
+        item->setText(2, QString("%1 ms").arg(offenders[i].totalMs));
+        item->setText(3, QString("%1 ms").arg(offenders[i].maxMs));
+        for (int column = 1; column < 4; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+}
+
 void MainWindow::onMenuClicked(int index)
 {
+    TRACE_SCOPE("MainWindow::onMenuClicked");
     _stackedWidget->setCurrentIndex(index);
 
     // 根据选中的菜单更新标题和按钮
@@ -466,6 +837,18 @@ void MainWindow::onMenuClicked(int index)
     // 切换到知识库页面时，自动刷新数据
     if (index == 1) {  // "我的知识库" 的索引是 1
         refreshKnowledgePage();
+    } else if (index == 3) {  // "学习路径" 的索引是 3
+        refreshPathPage();
+    } else if (index == 4) {  // "学习资源" 的索引是 4
+        refreshResourcePage();
+    }
+
+    // 设置页可见时才刷新运行指标
+    if (index == 5) {
+        refreshMetrics();
+        _metricsTimer.start();
+    } else {
+        _metricsTimer.stop();
     }
 }
 
@@ -478,6 +861,12 @@ void MainWindow::onLogoutClicked()
 
 void MainWindow::onKnowledgeClicked()
 {
+    // 对话框同样独占 socket，不能打断正在返回的回答
+    if (_aiChatPage->isStreaming()) {
+        QMessageBox::information(this, "提示", "请等待 AI 助手回答结束后再编辑知识库");
+        return;
+    }
+
     // 打开知识库填写对话框
     KnowledgeDialog knowledgeDlg(_username, this);
 
@@ -487,7 +876,7 @@ void MainWindow::onKnowledgeClicked()
 
     // 确保socket已连接
     if (client->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "MainWindow: Socket未连接，尝试重新连接";
+        LOG_DEBUG() << "MainWindow: Socket未连接，尝试重新连接";
         client->connectToHost("127.0.0.1", 8080);
         if (!client->waitForConnected(3000)) {
             QMessageBox::warning(this, "连接错误", "无法连接到服务器");
@@ -504,7 +893,19 @@ void MainWindow::onKnowledgeClicked()
 
 void MainWindow::refreshKnowledgePage()
 {
-    qDebug() << "=== refreshKnowledgePage 开始 ===";
+    TRACE_SCOPE("MainWindow::refreshKnowledgePage");
+    if (deferWhileStreaming(DeferKnowledge)) {
+        return;
+    }
+    if (fetchKnowledge()) {
+        syncReviews();
+    }
+}
+
+bool MainWindow::fetchKnowledge()
+{
+    TRACE_SCOPE("MainWindow::fetchKnowledge");
+    LOG_TRACE() << "=== fetchKnowledge 开始 ===";
 
     // 获取socket连接
     ConnectManager &manager = ConnectManager::getInstance();
@@ -512,12 +913,12 @@ void MainWindow::refreshKnowledgePage()
 
     // 确保socket已连接
     if (client->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "刷新知识库页面：Socket未连接，尝试重新连接";
+        LOG_DEBUG() << "刷新知识库页面：Socket未连接，尝试重新连接";
         client->abort();
         client->connectToHost("127.0.0.1", 8080);
         if (!client->waitForConnected(3000)) {
-            qDebug() << "刷新知识库页面：连接失败";
-            return;
+            LOG_WARNING() << "刷新知识库页面：连接失败";
+            return false;
         }
     }
 
@@ -526,63 +927,847 @@ void MainWindow::refreshKnowledgePage()
     disconnect(client, &QTcpSocket::readyRead, nullptr, nullptr);
 
     // 构造获取知识库请求
-    QJsonObject json;
-    json["type"] = GetKnowledgeType;
-    json["username"] = _username;
+    Messages::GetKnowledgeRequest request;
+    request.username = _username;
 
-    QJsonDocument doc(json);
-    QByteArray data = doc.toJson();
+    QByteArray data;
+    {
+        TRACE_SCOPE("json.encode");
+        data = Messages::encode(request);
+    }
 
-    qDebug() << "刷新知识库：发送请求";
+    LOG_DEBUG() << "刷新知识库：发送请求";
 
     // 发送请求
-    client->write(data);
+    Metrics::RoundTrip roundTrip(GetKnowledgeType);
+    Capture::sent(data);
+    roundTrip.sent(client->write(data));
     client->flush();
 
     // 等待响应
-    if (client->waitForReadyRead(3000)) {
+    bool ready;
+    {
+        TRACE_SCOPE("net.wait");
+        ready = client->waitForReadyRead(3000);
+    }
+    if (ready) {
         QByteArray responseData = client->readAll();
-        qDebug() << "刷新知识库：收到响应" << responseData;
-
-        QJsonDocument responseDoc = QJsonDocument::fromJson(responseData);
-        if (!responseDoc.isNull() && responseDoc.isObject()) {
-            QJsonObject responseJson = responseDoc.object();
-            QString type = responseJson["type"].toString();
-            QString status = responseJson["status"].toString();
-
-            if (type == "KnowledgeResponse" && status == "success") {
-                // 更新学习目标
-                if (responseJson.contains("learning_goal")) {
-                    QString goal = responseJson["learning_goal"].toString();
-                    if (goal.isEmpty()) {
-                        _learningGoalLabel->setText("暂未设置学习目标");
-                    } else {
-                        _learningGoalLabel->setText(goal);
-                    }
-                }
+        Capture::received(responseData);
+        roundTrip.received(responseData.size());
+        LOG_DEBUG() << "刷新知识库：收到响应" << Logger::preview(responseData);
+
+        Messages::KnowledgeResponse reply;
+        quint32 present = 0;
+        bool parsed;
+        {
+            TRACE_SCOPE("json.parse");
+            parsed = Messages::decode(responseData, &reply, &present);
+        }
+        if (parsed) {
+            if (reply.status == "success") {
+                applyKnowledge(reply, present);
+                LOG_DEBUG() << "刷新知识库页面成功，共" << reply.knowledgePoints.size() << "个知识点";
+                return true;
+            }
+            LOG_WARNING() << "刷新知识库页面失败:" << reply.message;
+        } else {
+            LOG_WARNING() << "刷新知识库页面：响应解析失败";
+        }
+    } else {
+        LOG_WARNING() << "刷新知识库页面：等待响应超时";
+    }
+    return false;
+}
 
-                // 更新知识点列表
-                QJsonArray knowledgeArray = responseJson["knowledge_points"].toArray();
-                _knowledgeListWidget->clear();
+void MainWindow::applyKnowledge(const Messages::KnowledgeResponse &reply, quint32 fields)
+{
+    // 更新学习目标
+    if (fields & Messages::fieldBit<Messages::KnowledgeResponse>("learning_goal")) {
+        const QString goal = reply.learningGoal;
+        _learningGoal = goal;
+        if (goal.isEmpty()) {
+            _learningGoalLabel->setText("暂未设置学习目标");
+        } else {
+            _learningGoalLabel->setText(goal);
+        }
+    }
 
-                if (knowledgeArray.isEmpty()) {
-                    _knowledgeListWidget->addItem("(暂无知识点)");
-                } else {
-                    for (const QJsonValue &value : knowledgeArray) {
-                        _knowledgeListWidget->addItem(value.toString());
-                    }
-                }
+    // 更新知识点列表
+    TRACE_SCOPE("list.knowledge");
+    _knowledgeListWidget->clear();
+    _knowledgePoints.clear();
+    _knowledgeIds.clear();
 
-                qDebug() << "刷新知识库页面成功，共" << knowledgeArray.size() << "个知识点";
-            } else {
-                qDebug() << "刷新知识库页面失败:" << responseJson["message"].toString();
+    if (reply.knowledgePoints.isEmpty()) {
+        _knowledgeListWidget->addItem("(暂无知识点)");
+    } else {
+        for (const QString &point : reply.knowledgePoints) {
+            const QString id = KnowledgeCanon::canonicalId(point);
+            if (id.isEmpty() || _knowledgeIds.contains(id)) {
+                continue;
             }
+            _knowledgeIds.insert(id);
+            _knowledgePoints.append(KnowledgeCanon::displayName(point));
+            _knowledgeListWidget->addItem(_knowledgePoints.last());
+        }
+    }
+    _knowledgeLoaded = true;
+    updateSuggestions();
+    updateKnowledgeRollup();
+    updateGoalMatches();
+    _aiChatPage->setKnowledgeContext(_knowledgePoints);
+}
+
+void MainWindow::refreshPathPage()
+{
+    TRACE_SCOPE("MainWindow::refreshPathPage");
+    if (deferWhileStreaming(DeferPath)) {
+        _pathStatusLabel->setText("AI 助手回答结束后刷新");
+        return;
+    }
+    LOG_TRACE() << "=== refreshPathPage 开始 ===";
+
+    ConnectManager &manager = ConnectManager::getInstance();
+    QTcpSocket *client = manager.getSocket();
+
+    if (client->state() != QAbstractSocket::ConnectedState) {
+        LOG_DEBUG() << "刷新学习路径：Socket未连接，尝试重新连接";
+        client->abort();
+        client->connectToHost("127.0.0.1", 8080);
+        if (!client->waitForConnected(3000)) {
+            _pathStatusLabel->setText("无法连接到服务器");
+            return;
+        }
+    }
+
+    disconnect(client, &QTcpSocket::readyRead, nullptr, nullptr);
+
+    QJsonObject json;
+    json["type"] = GetPathType;
+    json["username"] = _username;
+    json["knowledge_ids"] = QJsonArray::fromStringList(_knowledgeIds.values());
+
+    Metrics::RoundTrip roundTrip(GetPathType);
+    {
+        TRACE_SCOPE("json.encode");
+        const QByteArray request = QJsonDocument(json).toJson();
+        Capture::sent(request);
+        roundTrip.sent(client->write(request));
+    }
+    client->flush();
+
+    // 路径图可能很大，等到 JSON 完整再解析
+    QByteArray responseData;
+    QJsonDocument responseDoc;
+    while (true) {
+        {
+            TRACE_SCOPE("net.wait");
+            if (!client->waitForReadyRead(3000)) {
+                break;
+            }
+        }
+        TRACE_SCOPE("json.parse");
+        const QByteArray chunk = client->readAll();
+        Capture::received(chunk);
+        roundTrip.received(chunk.size());
+        responseData += chunk;
+        responseDoc = QJsonDocument::fromJson(responseData);
+        if (!responseDoc.isNull()) {
+            break;
+        }
+    }
+
+    if (responseDoc.isNull() || !responseDoc.isObject()) {
+        LOG_WARNING() << "刷新学习路径：响应解析失败或超时";
+        _pathStatusLabel->setText("获取学习路径失败");
+        return;
+    }
+
+    QJsonObject responseJson = responseDoc.object();
+    if (responseJson["type"].toString() != "PathResponse"
+        || responseJson["status"].toString() != "success") {
+        LOG_WARNING() << "刷新学习路径失败:" << responseJson["message"].toString();
+        _pathStatusLabel->setText("获取学习路径失败");
+        return;
+    }
+
+    // nodes: [{"id": ..., "name": ..., "mastered": bool}], edges: [[from, to], ...]
+    // 按规范 id 合并同一知识点的不同写法；没有 id 的节点由名称推出
+    TRACE_SCOPE("list.path");
+    PathGraph graph;
+    const QJsonArray nodes = responseJson["nodes"].toArray();
+    QVector<int> nodeToGraph(nodes.size(), -1);
+    QHash<QString, int> idToGraph;
+    graph.names.reserve(nodes.size());
+    graph.mastered.reserve(nodes.size());
+    for (int i = 0; i < nodes.size(); ++i) {
+        QJsonObject node = nodes[i].toObject();
+        const QString name = node["name"].toString();
+        QString id = node["id"].toString();
+        if (id.isEmpty()) {
+            id = KnowledgeCanon::canonicalId(name);
+        }
+        const bool mastered = node["mastered"].toBool() || _knowledgeIds.contains(id);
+
+        auto it = idToGraph.constFind(id);
+        if (it != idToGraph.constEnd()) {
+            nodeToGraph[i] = *it;
+            graph.mastered[*it] = graph.mastered[*it] || mastered;
+            continue;
+        }
+        nodeToGraph[i] = graph.names.size();
+        idToGraph.insert(id, graph.names.size());
+        graph.names.append(KnowledgeCanon::displayName(name));
+        graph.mastered.append(mastered);
+    }
+
+    _pathGaps.clear();
+    for (int i = 0; i < graph.names.size(); ++i) {
+        if (!graph.mastered[i]) {
+            _pathGaps.append(graph.names[i]);
+        }
+    }
+    updatePathRollup();
+
+    const QJsonArray edges = responseJson["edges"].toArray();
+    graph.edges.reserve(edges.size());
+    for (const QJsonValue &value : edges) {
+        QJsonArray edge = value.toArray();
+        const int from = edge.at(0).toInt(-1);
+        const int to = edge.at(1).toInt(-1);
+        if (from < 0 || to < 0 || from >= nodes.size() || to >= nodes.size()
+            || nodeToGraph[from] == nodeToGraph[to]) {
+            continue;
+        }
+        graph.edges.append(qMakePair(nodeToGraph[from], nodeToGraph[to]));
+    }
+
+    if (graph.names.isEmpty()) {
+        _pathStatusLabel->setText("暂无学习路径数据");
+    } else {
+        _pathStatusLabel->setText(QString("正在布局 %1 个知识点...").arg(graph.names.size()));
+    }
+    _pathView->setGraph(graph);
+
+    LOG_TRACE() << "=== refreshPathPage 结束 ===";
+}
+
+void MainWindow::refreshResourcePage()
+{
+    // 知识缺口查询用到学习目标和已掌握的知识点，登录时没取到就先取一次
+    if (!_knowledgeLoaded && !deferWhileStreaming(DeferKnowledge)) {
+        fetchKnowledge();
+    }
+
+    if (!_resourceIndex) {
+        loadResourceIndex();
+        return;  // 索引建好后会自动检索
+    }
+
+    QString query = _resourceSearchEdit->text().trimmed();
+    searchResources(query.isEmpty() ? knowledgeGapQuery() : query);
+}
+
+void MainWindow::loadResourceIndex()
+{
+    if (_resourceIndexWatcher.isRunning()) {
+        return;
+    }
+
+    QString path = DataFiles::locate(RESOURCE_CATALOG_FILE);
+    _resourceStatusLabel->setText("正在加载资源目录...");
+
+    // 百万级目录解析和建索引耗时较长，放到工作线程
+    _resourceIndexWatcher.setFuture(QtConcurrent::run([path]() {
+        QSharedPointer<ResourceIndex> index(new ResourceIndex());
+        QString error;
+        if (!index->loadCatalog(path, &error)) {
+            LOG_WARNING() << error;
+            return QSharedPointer<ResourceIndex>();
+        }
+        return index;
+    }));
+
+    // 资源向量是可选的，单独加载
+    QString embeddingPath = DataFiles::locate(RESOURCE_EMBEDDING_FILE);
+    _embeddingWatcher.setFuture(QtConcurrent::run([embeddingPath]() {
+        QSharedPointer<EmbeddingIndex> index(new EmbeddingIndex());
+        QString error;
+        if (!index->load(embeddingPath, RESOURCE_EMBEDDING_INT8, &error)) {
+            LOG_WARNING() << error;
+            return QSharedPointer<EmbeddingIndex>();
+        }
+        return index;
+    }));
+}
+
+void MainWindow::onResourceIndexLoaded()
+{
+    _resourceIndex = _resourceIndexWatcher.result();
+    if (!_resourceIndex) {
+        _resourceStatusLabel->setText("资源目录加载失败");
+        return;
+    }
+
+    _resourceStatusLabel->setText(QString("已加载 %1 个资源（去重后 %2 个）")
+                                      .arg(_resourceIndex->size())
+                                      .arg(_resourceIndex->clusterCount()));
+    if (_stackedWidget->currentWidget() == _resourcePage) {
+        refreshResourcePage();
+    }
+}
+
+QString MainWindow::knowledgeGapQuery() const
+{
+    QStringList parts;
+    if (!_learningGoal.isEmpty()) {
+        parts.append(_learningGoal);
+    }
+    parts.append(_pathGaps);
+    return parts.join(' ');
+}
+
+void MainWindow::searchResources(const QString &query)
+{
+    TRACE_SCOPE("MainWindow::searchResources");
+    if (!_resourceIndex) {
+        return;
+    }
+
+    _resourceList->clear();
+    if (query.isEmpty()) {
+        _resourceStatusLabel->setText("请先设置学习目标，或在上方输入关键词搜索");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<ResourceIndex::Hit> hits = _resourceIndex->search(query, 50);
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    for (const ResourceIndex::Hit &hit : hits) {
+        const ResourceIndex::Resource &res = _resourceIndex->resource(hit.doc);
+        QString text = res.title;
+        if (!res.tags.isEmpty()) {
+            text += "\n标签：" + res.tags.join("、");
+        }
+        QListWidgetItem *item = new QListWidgetItem(text, _resourceList);
+        item->setData(Qt::UserRole, res.url);
+        item->setToolTip(res.url);
+    }
+
+    _resourceStatusLabel->setText(QString("共 %1 个资源，找到 %2 条结果（%3 ms）")
+                                      .arg(_resourceIndex->size())
+                                      .arg(hits.size())
+                                      .arg(elapsedMs, 0, 'f', 2));
+    if (hits.isEmpty()) {
+        _resourceList->addItem("(没有找到相关资源)");
+    }
+
+    // 以前几条检索结果作为学生画像，补充语义相近但关键词不匹配的资源
+    QVector<int> seeds;
+    for (int i = 0; i < hits.size() && i < 10; ++i) {
+        seeds.append(hits[i].doc);
+    }
+    showSimilarResources(seeds);
+}
+
+void MainWindow::showSimilarResources(const QVector<int> &seedDocs)
+{
+    _similarList->clear();
+    bool available = _embeddingIndex && _embeddingIndex->size() > 0;
+    _similarTitleLabel->setVisible(available);
+    _similarList->setVisible(available);
+    if (!available || seedDocs.isEmpty()) {
+        return;
+    }
+
+    QVector<int> seedItems;
+    QSet<int> exclude;
+    for (int doc : seedDocs) {
+        int item = _embeddingIndex->findItem(_resourceIndex->resource(doc).id);
+        if (item >= 0) {
+            seedItems.append(item);
+            exclude.insert(item);
+        }
+    }
+    if (seedItems.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const int count = 20;
+    const QVector<float> profile = _embeddingIndex->centroid(seedItems);
+    const QVector<EmbeddingIndex::Match> matches = _embeddingIndex->topK(profile, count * 4, exclude);
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    // 同一近似重复簇（包括检索结果所在的簇）只展示一条
+    QSet<int> seenClusters;
+    for (int doc : seedDocs) {
+        seenClusters.insert(_resourceIndex->cluster(doc));
+    }
+
+    for (const EmbeddingIndex::Match &match : matches) {
+        if (_similarList->count() >= count) break;
+        int doc = _resourceIndex->findById(_embeddingIndex->itemId(match.item));
+        if (doc < 0 || seenClusters.contains(_resourceIndex->cluster(doc))) continue;
+        seenClusters.insert(_resourceIndex->cluster(doc));
+        const ResourceIndex::Resource &res = _resourceIndex->resource(doc);
+        QListWidgetItem *item = new QListWidgetItem(
+            QString("%1  (相似度 %2)").arg(res.title).arg(match.score, 0, 'f', 2), _similarList);
+        item->setData(Qt::UserRole, res.url);
+        item->setToolTip(res.url);
+    }
+
+    _similarTitleLabel->setText(QString("与你的学习画像相似的资源（%1 个向量，%2 ms）")
+                                    .arg(_embeddingIndex->size())
+                                    .arg(elapsedMs, 0, 'f', 2));
+}
+
+void MainWindow::loadRecommender()
+{
+    QString modelPath = DataFiles::locate(CF_MODEL_FILE);
+    QString exportPath = DataFiles::locate(CF_INTERACTIONS_FILE);
+
+    // 优先使用缓存的模型；导出数据比模型新时重新训练（训练使用全部 CPU 核心）
+    _recommenderWatcher.setFuture(QtConcurrent::run([modelPath, exportPath]() {
+        QSharedPointer<CfRecommender> recommender(new CfRecommender());
+        QFileInfo modelInfo(modelPath);
+        QFileInfo exportInfo(exportPath);
+        bool modelFresh = modelInfo.exists()
+                          && (!exportInfo.exists() || modelInfo.lastModified() >= exportInfo.lastModified());
+
+        QString error;
+        if (modelFresh && recommender->load(modelPath, &error)) {
+            return recommender;
+        }
+        if (!exportInfo.exists()) {
+            return QSharedPointer<CfRecommender>();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        if (!recommender->trainFromExport(exportPath, &error)) {
+            LOG_WARNING() << error;
+            return QSharedPointer<CfRecommender>();
+        }
+        LOG_DEBUG() << "协同过滤模型训练完成，耗时" << timer.elapsed() << "ms";
+
+        if (!recommender->save(modelPath, &error)) {
+            LOG_WARNING() << error;
+        }
+        return recommender;
+    }));
+
+    connect(&_recommenderWatcher, &QFutureWatcher<QSharedPointer<CfRecommender>>::finished,
+            this, [this]() {
+                _recommender = _recommenderWatcher.result();
+                updateSuggestions();
+            });
+}
+
+void MainWindow::loadTaxonomy()
+{
+    QString taxonomyPath = DataFiles::locate(KNOWLEDGE_TAXONOMY_FILE);
+
+    _taxonomyWatcher.setFuture(QtConcurrent::run([taxonomyPath]() {
+        QSharedPointer<KnowledgeTaxonomy> taxonomy(new KnowledgeTaxonomy());
+        QString error;
+        if (!taxonomy->load(taxonomyPath, &error)) {
+            LOG_WARNING() << error;
+            return QSharedPointer<KnowledgeTaxonomy>();
+        }
+        return taxonomy;
+    }));
+
+    connect(&_taxonomyWatcher, &QFutureWatcher<QSharedPointer<KnowledgeTaxonomy>>::finished,
+            this, [this]() {
+                _taxonomy = _taxonomyWatcher.result();
+                updateKnowledgeRollup();
+                updatePathRollup();
+            });
+}
+
+void MainWindow::updateKnowledgeRollup()
+{
+    TRACE_SCOPE("MainWindow::updateKnowledgeRollup");
+    _knowledgeTreeWidget->clear();
+    if (!_taxonomy || _taxonomy->size() == 0) {
+        return;
+    }
+
+    // 一次前缀和之后，每个分类的汇总都是区间查询
+    const KnowledgeTaxonomy::Mastery mastery(*_taxonomy, _knowledgeIds);
+    auto addNode = [&](QTreeWidgetItem *item, int node) {
+        item->setText(0, _taxonomy->name(node));
+        item->setText(1, QString("%1/%2").arg(mastery.mastered(node)).arg(mastery.total(node)));
+        item->setToolTip(0, _taxonomy->path(node));
+    };
+
+    // 只展示前两层分类，掌握了内容的顶层分类默认展开
+    for (int root : _taxonomy->roots()) {
+        QTreeWidgetItem *rootItem = new QTreeWidgetItem(_knowledgeTreeWidget);
+        addNode(rootItem, root);
+        for (int child = _taxonomy->firstChild(root); child >= 0; child = _taxonomy->nextSibling(child)) {
+            if (_taxonomy->hasChildren(child)) {
+                addNode(new QTreeWidgetItem(rootItem), child);
+            }
+        }
+        rootItem->setExpanded(mastery.any(root));
+    }
+
+    if (mastery.unclassified() > 0) {
+        QTreeWidgetItem *other = new QTreeWidgetItem(_knowledgeTreeWidget);
+        other->setText(0, "其他（未分类）");
+        other->setText(1, QString::number(mastery.unclassified()));
+    }
+}
+
+void MainWindow::updatePathRollup()
+{
+    TRACE_SCOPE("MainWindow::updatePathRollup");
+    if (!_taxonomy || _pathGaps.isEmpty()) {
+        _pathRollupLabel->hide();
+        return;
+    }
+
+    // 待学知识点按顶层分类计数，保持分类在分类树中的顺序
+    QMap<int, int> counts;
+    int unclassified = 0;
+    for (const QString &gap : _pathGaps) {
+        const int node = _taxonomy->find(gap);
+        if (node >= 0) {
+            counts[_taxonomy->category(node)]++;
         } else {
-            qDebug() << "刷新知识库页面：响应解析失败";
+            unclassified++;
+        }
+    }
+
+    QStringList parts;
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        parts.append(QString("%1 %2 个").arg(_taxonomy->name(it.key())).arg(it.value()));
+    }
+    if (unclassified > 0) {
+        parts.append(QString("其他 %1 个").arg(unclassified));
+    }
+    _pathRollupLabel->setText("待学习：" + parts.join("、"));
+    _pathRollupLabel->show();
+}
+
+void MainWindow::loadGoalMatcher()
+{
+    QString goalsPath = DataFiles::locate(LEARNING_GOALS_FILE);
+
+    _goalMatcherWatcher.setFuture(QtConcurrent::run([goalsPath]() {
+        QSharedPointer<GoalMatcher> matcher(new GoalMatcher());
+        QString error;
+        if (!matcher->load(goalsPath, &error)) {
+            LOG_WARNING() << error;
+            return QSharedPointer<GoalMatcher>();
+        }
+        return matcher;
+    }));
+
+    connect(&_goalMatcherWatcher, &QFutureWatcher<QSharedPointer<GoalMatcher>>::finished,
+            this, [this]() {
+                _goalMatcher = _goalMatcherWatcher.result();
+                updateGoalMatches();
+            });
+}
+
+void MainWindow::updateGoalMatches()
+{
+    TRACE_SCOPE("MainWindow::updateGoalMatches");
+    if (!_goalMatcher) {
+        _homeGoalLabel->hide();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<GoalMatcher::Match> matches = _goalMatcher->rank(_knowledgeIds, 3);
+    LOG_DEBUG() << "学习目标匹配：" << _goalMatcher->goalCount() << "个目标，耗时" << timer.nsecsElapsed() / 1000 << "us";
+
+    if (matches.isEmpty()) {
+        _homeGoalLabel->hide();
+        return;
+    }
+
+    QStringList links;
+    for (const GoalMatcher::Match &match : matches) {
+        const GoalMatcher::Goal &goal = _goalMatcher->goal(match.goal);
+        links.append(QString("<a href=\"%1\" style=\"color: #3498db;\">%2</a>（%3 %4/%5，还差 %6 个）")
+                         .arg(match.goal)
+                         .arg(goal.name.toHtmlEscaped(), goal.category.toHtmlEscaped())
+                         .arg(match.covered).arg(match.total).arg(match.gap()));
+    }
+    _homeGoalLabel->setText("与你最匹配的学习目标：" + links.join("；"));
+    _homeGoalLabel->show();
+}
+
+void MainWindow::onGoalClicked(const QString &link)
+{
+    bool ok = false;
+    const int goal = link.toInt(&ok);
+    if (!_goalMatcher || !ok || goal < 0 || goal >= _goalMatcher->goalCount()) {
+        return;
+    }
+
+    const QStringList missing = _goalMatcher->missing(goal, _knowledgeIds);
+    QString text = missing.isEmpty()
+                       ? QString("你已掌握「%1」要求的全部知识点。").arg(_goalMatcher->goal(goal).name)
+                       : QString("距离「%1」还需要学习：\n%2").arg(_goalMatcher->goal(goal).name, missing.join("、"));
+    QMessageBox::information(this, "学习目标", text);
+}
+
+bool MainWindow::sendReviewRequest(const QJsonObject &request, QJsonObject *reply)
+{
+    TRACE_SCOPE("MainWindow::sendReviewRequest");
+    if (deferWhileStreaming(DeferReviews)) {
+        return false;                   // 不计为失败，回答结束后重新同步
+    }
+    // 服务器不支持或暂时不可用时，每次刷新知识库页都要等超时；失败后暂停一段时间，连续失败时加倍
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now < _reviewSyncRetryAt) {
+        return false;
+    }
+    auto failed = [this, now]() {
+        _reviewSyncRetryAt = now + _reviewSyncBackoffMs;
+        LOG_INFO() << "复习记录同步暂停" << _reviewSyncBackoffMs / 1000 << "秒";
+        _reviewSyncBackoffMs = qMin(_reviewSyncBackoffMs * 2, REVIEW_SYNC_BACKOFF_MAX_MS);
+        return false;
+    };
+
+    ConnectManager &manager = ConnectManager::getInstance();
+    QTcpSocket *client = manager.getSocket();
+
+    if (client->state() != QAbstractSocket::ConnectedState) {
+        client->abort();
+        client->connectToHost("127.0.0.1", 8080);
+        if (!client->waitForConnected(3000)) {
+            LOG_WARNING() << "同步复习记录：连接失败";
+            return failed();
         }
+    }
+
+    disconnect(client, &QTcpSocket::readyRead, nullptr, nullptr);
+
+    Metrics::RoundTrip roundTrip(request["type"].toString());
+    {
+        TRACE_SCOPE("json.encode");
+        const QByteArray frame = QJsonDocument(request).toJson(QJsonDocument::Compact);
+        Capture::sent(frame);
+        roundTrip.sent(client->write(frame));
+    }
+    client->flush();
+
+    // 一批记录可能分多次到达，等到 JSON 完整再解析
+    QByteArray responseData;
+    QJsonDocument responseDoc;
+    while (true) {
+        {
+            TRACE_SCOPE("net.wait");
+            if (!client->waitForReadyRead(3000)) {
+                break;
+            }
+        }
+        TRACE_SCOPE("json.parse");
+        const QByteArray chunk = client->readAll();
+        Capture::received(chunk);
+        roundTrip.received(chunk.size());
+        responseData += chunk;
+        responseDoc = QJsonDocument::fromJson(responseData);
+        if (!responseDoc.isNull()) {
+            break;
+        }
+    }
+
+    if (!responseDoc.isObject() || responseDoc.object()["status"].toString() != "success") {
+        LOG_WARNING() << "同步复习记录失败:" << responseDoc.object()["message"].toString();
+        return failed();
+    }
+    _reviewSyncBackoffMs = REVIEW_SYNC_BACKOFF_MS;
+    *reply = responseDoc.object();
+    return true;
+}
+
+void MainWindow::syncReviews()
+{
+    // 每次登录只拉取一次，之后以本地为准，只上传修改过和删除的卡片
+    if (!_reviewsLoaded) {
+        int offset = 0;
+        for (;;) {
+            QJsonObject request;
+            request["type"] = GetReviewsType;
+            request["username"] = _username;
+            request["offset"] = offset;
+            request["limit"] = REVIEW_SYNC_BATCH;
+
+            QJsonObject reply;
+            if (!sendReviewRequest(request, &reply)) {
+                break;
+            }
+            const QJsonArray cards = reply["cards"].toArray();
+            _reviews.applyBatch(cards);
+            offset += cards.size();
+            if (cards.isEmpty() || offset >= reply["total"].toInt()) {
+                _reviewsLoaded = true;
+                break;
+            }
+        }
+    }
+
+    // 新掌握的知识点第二天开始复习；从知识库删除的知识点不再复习
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (const QString &id : _knowledgeIds) {
+        _reviews.addCard(id, now + 24 * 3600);
+    }
+    QStringList removed;
+    for (int i = 0; i < _reviews.count(); ++i) {
+        if (!_knowledgeIds.contains(_reviews.card(i).id)) {
+            removed.append(_reviews.card(i).id);
+        }
+    }
+    for (const QString &id : removed) {
+        _reviews.removeCard(id);
+    }
+
+    pushReviews();
+    refreshReviewList();
+}
+
+void MainWindow::pushReviews()
+{
+    // 没有修改时不访问服务器
+    while (_reviews.hasDirty()) {
+        const QJsonArray batch = _reviews.dirtyBatch(REVIEW_SYNC_BATCH);
+        const QStringList removed = _reviews.removedBatch(REVIEW_SYNC_BATCH);
+
+        QJsonObject request;
+        request["type"] = SaveReviewsType;
+        request["username"] = _username;
+        request["cards"] = batch;
+        request["removed"] = QJsonArray::fromStringList(removed);
+
+        QJsonObject reply;
+        if (!sendReviewRequest(request, &reply)) {
+            break;                      // 保持待同步，下次刷新时重试
+        }
+        _reviews.markSynced(batch, removed);
+    }
+}
+
+bool MainWindow::deferWhileStreaming(int refresh)
+{
+    if (!_aiChatPage->isStreaming()) {
+        return false;
+    }
+    LOG_DEBUG() << "AI 助手回答中，推迟刷新" << refresh;
+    _deferredRefreshes |= refresh;
+    return true;
+}
+
+void MainWindow::runDeferredRefreshes()
+{
+    const int refreshes = _deferredRefreshes;
+    _deferredRefreshes = 0;
+    if (refreshes & DeferKnowledge) {
+        refreshKnowledgePage();         // 其中已包括复习同步
+    } else if (refreshes & DeferReviews) {
+        syncReviews();
+    }
+    if (refreshes & DeferPath) {
+        refreshPathPage();
+    }
+}
+
+void MainWindow::refreshReviewList()
+{
+    TRACE_SCOPE("MainWindow::refreshReviewList");
+    QHash<QString, QString> names;
+    for (const QString &point : _knowledgePoints) {
+        names.insert(KnowledgeCanon::canonicalId(point), point);
+    }
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const int dueCount = _reviews.dueCount(now);
+    _reviewListWidget->clear();
+    for (int index : _reviews.dueCards(now, 50)) {
+        const ReviewScheduler::Card &card = _reviews.card(index);
+        QListWidgetItem *item = new QListWidgetItem(names.value(card.id, card.id), _reviewListWidget);
+        item->setData(Qt::UserRole, card.id);
+        if (card.lapses > 0) {
+            item->setToolTip(QString("已遗忘 %1 次").arg(card.lapses));
+        }
+    }
+
+    if (dueCount > 0) {
+        _reviewStatusLabel->setText(QString("今日复习（%1 个待复习）").arg(dueCount));
+    } else if (_reviews.count() > 0) {
+        const int next = _reviews.nextDue();
+        _reviewStatusLabel->setText(QString("今日复习（已完成，下次复习：%1）")
+                                        .arg(QDateTime::fromSecsSinceEpoch(_reviews.card(next).due)
+                                                 .toString("MM-dd hh:mm")));
     } else {
-        qDebug() << "刷新知识库页面：等待响应超时";
+        _reviewStatusLabel->setText("今日复习");
+    }
+}
+
+void MainWindow::onReviewItemActivated(QListWidgetItem *item)
+{
+    const int index = _reviews.find(item->data(Qt::UserRole).toString());
+    if (index < 0) {
+        return;
+    }
+
+    const QStringList grades = {"忘记了", "很吃力", "想起来了", "很轻松"};
+    bool ok = false;
+    const QString choice = QInputDialog::getItem(this, "复习", QString("「%1」还记得吗？").arg(item->text()),
+                                                 grades, 2, false, &ok);
+    if (!ok) {
+        return;
+    }
+
+    const ReviewScheduler::Grade gradeValues[] = {ReviewScheduler::Forgot, ReviewScheduler::Hard,
+                                                  ReviewScheduler::Good, ReviewScheduler::Easy};
+    _reviews.review(index, gradeValues[grades.indexOf(choice)], QDateTime::currentSecsSinceEpoch());
+    pushReviews();
+    refreshReviewList();
+}
+
+void MainWindow::updateSuggestions()
+{
+    TRACE_SCOPE("MainWindow::updateSuggestions");
+    QStringList topics;
+    if (_recommender) {
+        topics = _recommender->suggest(_knowledgePoints, 6);
+    }
+
+    if (topics.isEmpty()) {
+        _homeSuggestLabel->hide();
+        _resourceSuggestLabel->hide();
+        return;
+    }
+
+    QStringList links;
+    for (const QString &topic : topics) {
+        links.append(QString("<a href=\"%1\" style=\"color: #3498db;\">%1</a>").arg(topic.toHtmlEscaped()));
     }
+    QString html = "学了这些的同学接下来学了：" + links.join("、");
 
-    qDebug() << "=== refreshKnowledgePage 结束 ===";
+    _homeSuggestLabel->setText(html);
+    _homeSuggestLabel->show();
+    _resourceSuggestLabel->setText(html);
+    _resourceSuggestLabel->show();
+}
+
+void MainWindow::onSuggestionClicked(const QString &topic)
+{
+    _resourceSearchEdit->setText(topic);
+    if (_stackedWidget->currentWidget() != _resourcePage) {
+        _menuList->setCurrentRow(4);    // 切换到资源页，会触发检索
+    } else {
+        refreshResourcePage();
+    }
 }
@@ -6,8 +6,26 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QListWidget>
+#include <QTreeWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QLineEdit>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QSet>
+#include <QTimer>
+#include <QJsonObject>
+
+#include "reviewscheduler.h"
+#include "messages.h"
+
+class PathGraphView;
+class ChatPage;
+class ResourceIndex;
+class EmbeddingIndex;
+class CfRecommender;
+class KnowledgeTaxonomy;
+class GoalMatcher;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -20,13 +38,16 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(const QString &username = "", QWidget *parent = nullptr);
+    // knowledge 非空时是登录时取到的知识库（fields 为其中出现的字段），直接显示，不再查询
+    MainWindow(const QString &username = "", const Messages::KnowledgeResponse *knowledge = nullptr,
+               quint32 knowledgeFields = 0, QWidget *parent = nullptr);
     ~MainWindow();
 
 private slots:
     void onMenuClicked(int index);      // 菜单点击事件
     void onLogoutClicked();             // 退出登录
     void onKnowledgeClicked();          // 打开知识库填写
+    void onResourceIndexLoaded();       // 资源索引建立完成
 
 private:
     Ui::MainWindow *ui;
@@ -37,19 +58,83 @@ private:
     QStackedWidget *_stackedWidget;     // 内容区域堆栈窗口
     QLabel *_usernameLabel;             // 用户名标签
     QLabel *_welcomeLabel;              // 欢迎标签（首页）
+    QLabel *_homeSuggestLabel;          // 首页“同学们接下来学了”
+    QLabel *_homeGoalLabel;             // 首页最匹配的学习目标
     QPushButton *_logoutBtn;            // 退出按钮
     QPushButton *_editKnowledgeBtn;     // 修改知识库按钮
 
     // 知识库页面控件
     QListWidget *_knowledgeListWidget;  // 知识点列表
     QLabel *_learningGoalLabel;         // 学习目标标签
+    QTreeWidget *_knowledgeTreeWidget;  // 按分类汇总的掌握情况
+    QLabel *_reviewStatusLabel;         // 今日待复习数量
+    QListWidget *_reviewListWidget;     // 到期的复习卡片
+
+    // 学习路径页面控件
+    PathGraphView *_pathView;           // 路径图视图
+    QLabel *_pathStatusLabel;           // 路径状态标签
+    QLabel *_pathRollupLabel;           // 按分类汇总的待学知识点
+
+    // 学习资源页面控件
+    QLineEdit *_resourceSearchEdit;     // 资源搜索框
+    QListWidget *_resourceList;         // 检索结果列表
+    QLabel *_resourceStatusLabel;       // 检索状态标签
+    QLabel *_similarTitleLabel;         // 相似推荐标题
+    QListWidget *_similarList;          // 按向量相似度推荐的资源
+    QLabel *_resourceSuggestLabel;      // 资源页“同学们接下来学了”
+    QSharedPointer<ResourceIndex> _resourceIndex;                   // 本地资源索引
+    QFutureWatcher<QSharedPointer<ResourceIndex>> _resourceIndexWatcher;  // 后台建索引
+    QSharedPointer<EmbeddingIndex> _embeddingIndex;                 // 资源向量
+    QFutureWatcher<QSharedPointer<EmbeddingIndex>> _embeddingWatcher;     // 后台加载资源向量
+
+    // 协同过滤推荐
+    QSharedPointer<CfRecommender> _recommender;
+    QFutureWatcher<QSharedPointer<CfRecommender>> _recommenderWatcher;
+
+    // 知识点分类树
+    QSharedPointer<KnowledgeTaxonomy> _taxonomy;
+    QFutureWatcher<QSharedPointer<KnowledgeTaxonomy>> _taxonomyWatcher;
+
+    // 学习目标匹配
+    QSharedPointer<GoalMatcher> _goalMatcher;
+    QFutureWatcher<QSharedPointer<GoalMatcher>> _goalMatcherWatcher;
+
+    // 间隔复习
+    ReviewScheduler _reviews;
+    bool _reviewsLoaded;                // 是否已从服务器取回复习记录
+    qint64 _reviewSyncRetryAt;          // 同步失败后，在此时间（毫秒）之前不再访问服务器
+    int _reviewSyncBackoffMs;           // 下次失败后暂停的时间
+
+    // AI 回答流式返回期间 socket 由对话页独占，这期间的刷新推迟到回答结束
+    enum DeferredRefresh {
+        DeferKnowledge = 1,
+        DeferPath = 2,
+        DeferReviews = 4
+    };
+    int _deferredRefreshes;             // DeferredRefresh 的组合
+
+    // 用户数据（刷新页面时更新）
+    bool _knowledgeLoaded;              // 是否已从服务器取回知识库
+    QString _learningGoal;              // 学习目标
+    QStringList _knowledgePoints;       // 已掌握的知识点（规范名称）
+    QSet<QString> _knowledgeIds;        // 已掌握知识点的规范 id
+    QStringList _pathGaps;              // 学习路径中尚未掌握的知识点
 
     // 页面
     QWidget *_homePage;                 // 首页
     QWidget *_knowledgePage;            // 知识库页面
-    QWidget *_aiChatPage;               // AI对话页面
+    ChatPage *_aiChatPage;              // AI对话页面
     QWidget *_pathPage;                 // 学习路径页面
     QWidget *_resourcePage;             // 学习资源页面
+    QWidget *_settingsPage;             // 设置页面
+
+    // 设置页面控件
+    QLabel *_connectionLabel;           // 连接状态与重连次数
+    QTreeWidget *_netMetricsTree;       // 按消息类型的请求数、流量和往返时间
+    QLabel *_rttHistogramLabel;         // 往返时间分布
+    QLabel *_runtimeMetricsLabel;       // 在途请求、缓存命中率、界面卡顿
+    QTreeWidget *_stallTree;            // 卡顿报告中累计时长最多的操作
+    QTimer _metricsTimer;               // 设置页可见时定时刷新
 
     void setupUI();                     // 设置UI布局
     void createHomePage();              // 创建首页
@@ -57,7 +142,33 @@ private:
     void createAIChatPage();            // 创建AI对话页面
     void createPathPage();              // 创建学习路径页面
     void createResourcePage();          // 创建学习资源页面
-    void refreshKnowledgePage();        // 刷新知识库页面显示
+    void createSettingsPage();          // 创建设置页面（运行指标）
+    void refreshMetrics();              // 刷新设置页的运行指标
+    void refreshKnowledgePage();        // 刷新知识库页面显示，并同步复习记录
+    bool fetchKnowledge();              // 从服务器取知识库并显示
+    void applyKnowledge(const Messages::KnowledgeResponse &reply, quint32 fields);  // 显示知识库并更新依赖它的页面
+    void refreshPathPage();             // 从服务器获取学习路径并重新布局
+    void refreshResourcePage();         // 按知识缺口检索推荐资源
+    void loadResourceIndex();           // 后台加载资源目录并建立索引
+    void searchResources(const QString &query);  // 检索并显示资源
+    void showSimilarResources(const QVector<int> &seedDocs);  // 以检索结果为画像推荐相似资源
+    QString knowledgeGapQuery() const;  // 由学习目标和未掌握知识点生成查询
+    void loadRecommender();             // 后台加载或训练协同过滤模型
+    void updateSuggestions();           // 刷新“同学们接下来学了”
+    void onSuggestionClicked(const QString &topic);  // 点击推荐主题，跳转资源检索
+    void loadTaxonomy();                // 后台加载知识点分类树
+    void updateKnowledgeRollup();       // 按分类汇总已掌握的知识点
+    void updatePathRollup();            // 按分类汇总学习路径中的待学知识点
+    void loadGoalMatcher();             // 后台加载学习目标
+    void updateGoalMatches();           // 刷新首页最匹配的学习目标
+    void onGoalClicked(const QString &link);  // 点击学习目标，显示尚缺的知识点
+    bool sendReviewRequest(const QJsonObject &request, QJsonObject *reply);  // 发送复习同步请求并等待完整响应
+    void syncReviews();                 // 拉取复习记录、按知识库增删卡片并上传修改
+    void pushReviews();                 // 分批上传待同步的卡片
+    void refreshReviewList();           // 刷新到期的复习卡片
+    bool deferWhileStreaming(int refresh);  // AI 回答期间推迟需要 socket 的刷新，返回是否已推迟
+    void runDeferredRefreshes();        // 回答结束后补做推迟的刷新
+    void onReviewItemActivated(QListWidgetItem *item);  // 复习一个知识点
 
     QWidget* createFeatureCard(const QString &icon, const QString &title, const QString &desc);  // 创建功能卡片
 };
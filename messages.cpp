@@ -0,0 +1,554 @@
+#include "messages.h"
+#include "logger.h"
+
+namespace {
+
+const char HexDigits[] = "0123456789abcdef";
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(QByteArray *out, uint code)
+{
+    if (code < 0x80) {
+        out->append(char(code));
+    } else if (code < 0x800) {
+        out->append(char(0xC0 | (code >> 6)));
+        out->append(char(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out->append(char(0xE0 | (code >> 12)));
+        out->append(char(0x80 | ((code >> 6) & 0x3F)));
+        out->append(char(0x80 | (code & 0x3F)));
+    } else {
+        out->append(char(0xF0 | (code >> 18)));
+        out->append(char(0x80 | ((code >> 12) & 0x3F)));
+        out->append(char(0x80 | ((code >> 6) & 0x3F)));
+        out->append(char(0x80 | (code & 0x3F)));
+    }
+}
+
+}
+
+// ---- Writer ----
+
+Messages::detail::Writer::Writer(int reserve)
+{
+    _out.resize(qMax(reserve, 64));
+    _p = _out.data();
+    _end = _p + _out.size();
+}
+
+void Messages::detail::Writer::grow(int bytes)
+{
+    const int used = int(_p - _out.data());
+    _out.resize(qMax(_out.size() * 2, used + bytes));
+    _p = _out.data() + used;
+    _end = _out.data() + _out.size();
+}
+
+void Messages::detail::Writer::beginObject(const char *type)
+{
+    const int length = nameLength(type);
+    ensure(length + 10);
+    std::memcpy(_p, "{\"type\":\"", 9);
+    _p += 9;
+    std::memcpy(_p, type, std::size_t(length));
+    _p += length;
+    *_p++ = '"';
+}
+
+void Messages::detail::Writer::key(const char *name, int length)
+{
+    ensure(length + 4);
+    *_p++ = ',';
+    *_p++ = '"';
+    std::memcpy(_p, name, std::size_t(length));
+    _p += length;
+    *_p++ = '"';
+    *_p++ = ':';
+}
+
+void Messages::detail::Writer::value(const QString &text)
+{
+    string(text);
+}
+
+void Messages::detail::Writer::value(const QStringList &list)
+{
+    ensure(2);
+    *_p++ = '[';
+    for (int i = 0; i < list.size(); ++i) {
+        if (i > 0) {
+            ensure(1);
+            *_p++ = ',';
+        }
+        string(list[i]);
+    }
+    ensure(1);
+    *_p++ = ']';
+}
+
+void Messages::detail::Writer::value(int number)
+{
+    ensure(11);
+    // 从低位往高位写，再整体移到 _p
+    char digits[11];
+    int n = 0;
+    unsigned int magnitude = number < 0 ? 0u - unsigned(number) : unsigned(number);
+    do {
+        digits[n++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (number < 0) {
+        *_p++ = '-';
+    }
+    while (n > 0) {
+        *_p++ = digits[--n];
+    }
+}
+
+void Messages::detail::Writer::value(bool flag)
+{
+    ensure(5);
+    std::memcpy(_p, flag ? "true" : "false", flag ? 4 : 5);
+    _p += flag ? 4 : 5;
+}
+
+// UTF-16 直接转成 UTF-8 并转义；每个 UTF-16 单元最多写 6 字节（\u00XX）
+void Messages::detail::Writer::string(const QString &text)
+{
+    const int length = text.size();
+    ensure(length * 6 + 2);
+    const ushort *s = reinterpret_cast<const ushort *>(text.constData());
+    *_p++ = '"';
+    for (int i = 0; i < length; ++i) {
+        uint c = s[i];
+        if (c < 0x80) {
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                *_p++ = char(c);
+                continue;
+            }
+            *_p++ = '\\';
+            switch (c) {
+            case '"': *_p++ = '"'; break;
+            case '\\': *_p++ = '\\'; break;
+            case '\n': *_p++ = 'n'; break;
+            case '\r': *_p++ = 'r'; break;
+            case '\t': *_p++ = 't'; break;
+            case '\b': *_p++ = 'b'; break;
+            case '\f': *_p++ = 'f'; break;
+            default:
+                *_p++ = 'u';
+                *_p++ = '0';
+                *_p++ = '0';
+                *_p++ = HexDigits[c >> 4];
+                *_p++ = HexDigits[c & 0xF];
+                break;
+            }
+        } else if (c < 0x800) {
+            *_p++ = char(0xC0 | (c >> 6));
+            *_p++ = char(0x80 | (c & 0x3F));
+        } else if (QChar::isHighSurrogate(c) && i + 1 < length && QChar::isLowSurrogate(s[i + 1])) {
+            c = QChar::surrogateToUcs4(ushort(c), s[++i]);
+            *_p++ = char(0xF0 | (c >> 18));
+            *_p++ = char(0x80 | ((c >> 12) & 0x3F));
+            *_p++ = char(0x80 | ((c >> 6) & 0x3F));
+            *_p++ = char(0x80 | (c & 0x3F));
+        } else {
+            if (QChar::isSurrogate(c)) {
+                c = QChar::ReplacementCharacter;    // 不成对的代理项
+            }
+            *_p++ = char(0xE0 | (c >> 12));
+            *_p++ = char(0x80 | ((c >> 6) & 0x3F));
+            *_p++ = char(0x80 | (c & 0x3F));
+        }
+    }
+    *_p++ = '"';
+}
+
+QByteArray Messages::detail::Writer::finish()
+{
+    ensure(1);
+    *_p++ = '}';
+    _out.resize(int(_p - _out.data()));
+    return _out;
+}
+
+int Messages::detail::estimate(const QStringList &list)
+{
+    int total = 2;
+    for (const QString &text : list) {
+        total += estimate(text) + 1;
+    }
+    return total;
+}
+
+// ---- Reader ----
+
+void Messages::detail::Reader::skipSpace()
+{
+    while (_p < _end && (*_p == ' ' || *_p == '\n' || *_p == '\r' || *_p == '\t')) {
+        ++_p;
+    }
+}
+
+bool Messages::detail::Reader::consume(char c)
+{
+    skipSpace();
+    if (_p < _end && *_p == c) {
+        ++_p;
+        return true;
+    }
+    return false;
+}
+
+bool Messages::detail::Reader::atEnd()
+{
+    skipSpace();
+    return _p == _end;
+}
+
+// 找到字符串的结束引号；escaped 表示其中有转义，需要逐字符解码
+bool Messages::detail::Reader::rawString(const char **begin, const char **end, bool *escaped)
+{
+    if (!consume('"')) {
+        return false;
+    }
+    *begin = _p;
+    *escaped = false;
+    while (_p < _end) {
+        const char c = *_p;
+        if (c == '"') {
+            *end = _p++;
+            return true;
+        }
+        if (c == '\\') {
+            *escaped = true;
+            _p += 2;
+        } else {
+            ++_p;
+        }
+    }
+    return false;
+}
+
+bool Messages::detail::Reader::key(const char **name, int *length)
+{
+    const char *begin;
+    const char *end;
+    bool escaped;
+    if (!rawString(&begin, &end, &escaped) || !consume(':')) {
+        return false;
+    }
+    // 字段名都是 ASCII，带转义的名称不会与字段表匹配，读取后按未知字段跳过
+    *name = begin;
+    *length = escaped ? -1 : int(end - begin);
+    return true;
+}
+
+bool Messages::detail::Reader::read(QString *text)
+{
+    skipSpace();
+    if (_p < _end && *_p != '"') {
+        text->clear();
+        return skip();
+    }
+    const char *begin;
+    const char *end;
+    bool escaped;
+    if (!rawString(&begin, &end, &escaped)) {
+        return false;
+    }
+    if (!escaped) {
+        *text = QString::fromUtf8(begin, int(end - begin));
+        return true;
+    }
+
+    // 有转义时先还原成 UTF-8，\uXXXX（含代理对）转成对应的 UTF-8 字节
+    QByteArray utf8;
+    utf8.reserve(int(end - begin));
+    for (const char *p = begin; p < end; ++p) {
+        if (*p != '\\') {
+            utf8.append(*p);
+            continue;
+        }
+        if (++p >= end) {
+            return false;
+        }
+        switch (*p) {
+        case '"': utf8.append('"'); break;
+        case '\\': utf8.append('\\'); break;
+        case '/': utf8.append('/'); break;
+        case 'n': utf8.append('\n'); break;
+        case 'r': utf8.append('\r'); break;
+        case 't': utf8.append('\t'); break;
+        case 'b': utf8.append('\b'); break;
+        case 'f': utf8.append('\f'); break;
+        case 'u': {
+            auto hex4 = [end](const char *q, uint *code) {
+                if (end - q < 4) return false;
+                *code = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const int v = hexValue(q[i]);
+                    if (v < 0) return false;
+                    *code = (*code << 4) | uint(v);
+                }
+                return true;
+            };
+            uint code;
+            if (!hex4(p + 1, &code)) {
+                return false;
+            }
+            p += 4;
+            uint low;
+            if (QChar::isHighSurrogate(code) && end - p > 6 && p[1] == '\\' && p[2] == 'u'
+                && hex4(p + 3, &low) && QChar::isLowSurrogate(low)) {
+                code = QChar::surrogateToUcs4(ushort(code), ushort(low));
+                p += 6;
+            } else if (QChar::isSurrogate(code)) {
+                code = QChar::ReplacementCharacter;
+            }
+            appendUtf8(&utf8, code);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    *text = QString::fromUtf8(utf8);
+    return true;
+}
+
+bool Messages::detail::Reader::read(QStringList *list)
+{
+    list->clear();
+    if (!consume('[')) {
+        return skip();
+    }
+    if (consume(']')) {
+        return true;
+    }
+    do {
+        QString text;
+        if (!read(&text)) {
+            return false;
+        }
+        list->append(text);
+    } while (consume(','));
+    return consume(']');
+}
+
+bool Messages::detail::Reader::read(int *number)
+{
+    skipSpace();
+    if (_p < _end && *_p != '-' && (*_p < '0' || *_p > '9')) {
+        *number = 0;
+        return skip();
+    }
+    const char *begin = _p;
+    while (_p < _end && ((*_p != '\0' && std::strchr("+-.eE", *_p)) || (*_p >= '0' && *_p <= '9'))) {
+        ++_p;
+    }
+    if (_p == begin) {
+        return false;
+    }
+    // 整数直接取；带小数或指数的按 double 转换，不是整数或超出 int 范围时取 0（与 QJsonValue::toInt 一致）
+    bool ok = false;
+    const QByteArray digits = QByteArray::fromRawData(begin, int(_p - begin));
+    *number = digits.toInt(&ok);
+    if (!ok) {
+        const double value = digits.toDouble(&ok);
+        const bool integral = value >= -2147483648.0 && value <= 2147483647.0 && double(int(value)) == value;
+        *number = ok && integral ? int(value) : 0;
+    }
+    return ok;
+}
+
+bool Messages::detail::Reader::read(bool *flag)
+{
+    skipSpace();
+    if (_end - _p >= 4 && std::memcmp(_p, "true", 4) == 0) {
+        *flag = true;
+        _p += 4;
+        return true;
+    }
+    if (_end - _p >= 5 && std::memcmp(_p, "false", 5) == 0) {
+        *flag = false;
+        _p += 5;
+        return true;
+    }
+    *flag = false;
+    return skip();
+}
+
+bool Messages::detail::Reader::skip()
+{
+    skipSpace();
+    if (_p >= _end) {
+        return false;
+    }
+    if (*_p == '"') {
+        const char *begin;
+        const char *end;
+        bool escaped;
+        return rawString(&begin, &end, &escaped);
+    }
+    if (*_p == '{' || *_p == '[') {
+        // 按括号深度跳过，字符串里的括号不计
+        int depth = 0;
+        while (_p < _end) {
+            const char c = *_p;
+            if (c == '"') {
+                const char *begin;
+                const char *end;
+                bool escaped;
+                if (!rawString(&begin, &end, &escaped)) return false;
+                continue;
+            }
+            ++_p;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) return true;
+            }
+        }
+        return false;
+    }
+    // 数字、true/false/null
+    const char *begin = _p;
+    while (_p < _end && *_p != ',' && *_p != '}' && *_p != ']' && *_p != ' ' && *_p != '\n'
+           && *_p != '\r' && *_p != '\t') {
+        ++_p;
+    }
+    return _p > begin;
+}
+
+bool Messages::detail::Reader::raw(const char **begin, const char **end)
+{
+    skipSpace();
+    *begin = _p;
+    if (!skip()) {
+        return false;
+    }
+    *end = _p;
+    return true;
+}
+
+void Messages::detail::malformed(const char *type, const QByteArray &data)
+{
+    if (typeOf(data) == QLatin1String(type)) {
+        LOG_WARNING() << "无法解析的" << type << ":" << Logger::preview(data);
+    }
+}
+
+QString Messages::typeOf(const QByteArray &data)
+{
+    detail::Reader reader(data.constData(), data.constData() + data.size());
+    if (!reader.consume('{') || reader.consume('}')) {
+        return QString();
+    }
+    do {
+        const char *name;
+        int length;
+        if (!reader.key(&name, &length)) {
+            return QString();
+        }
+        if (reader.sameKey(name, length, "type", 4)) {
+            QString type;
+            return reader.read(&type) ? type : QString();
+        }
+        if (!reader.skip()) {
+            return QString();
+        }
+    } while (reader.consume(','));
+    return QString();
+}
+
+// ---- Batch ----
+
+QByteArray Messages::Batch::encode() const
+{
+    static const char Head[] = "{\"type\":\"" BatchType "\",\"ops\":[";
+    int size = int(sizeof(Head)) + 2;
+    for (const QByteArray &op : _ops) {
+        size += op.size() + 1;
+    }
+
+    QByteArray out;
+    out.reserve(size);
+    out.append(Head);
+    for (int i = 0; i < _ops.size(); ++i) {
+        if (i > 0) out.append(',');
+        out.append(_ops[i]);
+    }
+    out.append("]}");
+    return out;
+}
+
+bool Messages::decodeBatch(const QByteArray &data, QList<QByteArray> *results)
+{
+    detail::Reader reader(data.constData(), data.constData() + data.size());
+    bool typeMatched = false;
+    bool sawResults = false;
+    results->clear();
+    if (!reader.consume('{')) {
+        return false;
+    }
+    if (!reader.consume('}')) {
+        do {
+            const char *name;
+            int length;
+            if (!reader.key(&name, &length)) {
+                return false;
+            }
+            bool ok = true;
+            if (reader.sameKey(name, length, "type", 4)) {
+                QString type;
+                ok = reader.read(&type);
+                typeMatched = type == QLatin1String("BatchResponse");
+            } else if (reader.sameKey(name, length, "results", 7)) {
+                sawResults = true;
+                if (!reader.consume('[')) {
+                    return false;
+                }
+                if (!reader.consume(']')) {
+                    do {
+                        const char *begin;
+                        const char *end;
+                        if (!reader.raw(&begin, &end)) {
+                            return false;
+                        }
+                        if (*begin == '"') {
+                            // 裸文本回复以 JSON 字符串返回，解码后还原
+                            detail::Reader text(begin, end);
+                            QString reply;
+                            if (!text.read(&reply)) {
+                                return false;
+                            }
+                            results->append(reply.toUtf8());
+                        } else {
+                            results->append(QByteArray(begin, int(end - begin)));
+                        }
+                    } while (reader.consume(','));
+                    if (!reader.consume(']')) {
+                        return false;
+                    }
+                }
+            } else {
+                ok = reader.skip();
+            }
+            if (!ok) {
+                return false;
+            }
+        } while (reader.consume(','));
+        if (!reader.consume('}')) {
+            return false;
+        }
+    }
+    return typeMatched && sawResults && reader.atEnd();
+}
@@ -0,0 +1,360 @@
+#ifndef MESSAGES_H
+#define MESSAGES_H
+
+#include "config.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+// 与服务器往来的消息
+// 每种消息是一个结构体：Type 为 "type" 字段的值，fields() 返回编译期的字段表（JSON 名称 + 成员指针）。
+// encode/decode 按字段表直接生成 JSON 文本或从 JSON 文本读出，不经过 QJsonObject；
+// encode 先按字段长度估算并预留缓冲区，decode 对不认识的字段跳过，不要求字段顺序；
+// 字段值为 null 或类型不符时取默认值（空字符串、0、false），与 QJsonValue::toString/toInt 一致。
+// 支持的字段类型：QString、QStringList、int、bool。
+namespace Messages {
+
+template <typename Message, typename T>
+struct Field {
+    const char *name;
+    T Message::*member;
+};
+
+template <typename Message, typename T>
+constexpr Field<Message, T> field(const char *name, T Message::*member)
+{
+    return {name, member};
+}
+
+// ---- 请求 ----
+
+struct LoginRequest {
+    static constexpr const char *Type = LoginType;
+    QString user;
+    QString password;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(field("user", &LoginRequest::user),
+                               field("password", &LoginRequest::password));
+    }
+};
+
+struct RegisterRequest {
+    static constexpr const char *Type = RegisterType;
+    QString username;
+    QString password;
+    QString email;
+    QString phone;
+    QString grade;
+    QString major;
+    QString role;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(field("username", &RegisterRequest::username),
+                               field("password", &RegisterRequest::password),
+                               field("email", &RegisterRequest::email),
+                               field("phone", &RegisterRequest::phone),
+                               field("grade", &RegisterRequest::grade),
+                               field("major", &RegisterRequest::major),
+                               field("role", &RegisterRequest::role));
+    }
+};
+
+struct SaveKnowledgeRequest {
+    static constexpr const char *Type = SaveKnowledgeType;
+    QString username;
+    QString learningGoal;
+    QStringList knowledgePoints;
+    QStringList knowledgeIds;           // 与 knowledgePoints 一一对应的规范 id
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(field("username", &SaveKnowledgeRequest::username),
+                               field("learning_goal", &SaveKnowledgeRequest::learningGoal),
+                               field("knowledge_points", &SaveKnowledgeRequest::knowledgePoints),
+                               field("knowledge_ids", &SaveKnowledgeRequest::knowledgeIds));
+    }
+};
+
+struct GetKnowledgeRequest {
+    static constexpr const char *Type = GetKnowledgeType;
+    QString username;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(field("username", &GetKnowledgeRequest::username));
+    }
+};
+
+// ---- 响应 ----
+
+struct RegisterResponse {
+    static constexpr const char *Type = "RegisterResponse";
+    QString status;
+    int code = 0;
+    QString message;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(field("status", &RegisterResponse::status),
+                               field("code", &RegisterResponse::code),
+                               field("message", &RegisterResponse::message));
+    }
+};
+
+// 保存和获取知识库共用的响应；保存时只有 status 和 message
+struct KnowledgeResponse {
+    static constexpr const char *Type = "KnowledgeResponse";
+    QString status;
+    QString message;
+    QString learningGoal;
+    QStringList knowledgePoints;
+    QStringList knowledgeIds;
+
+    static constexpr auto fields()
+    {
+        return std::make_tuple(field("status", &KnowledgeResponse::status),
+                               field("message", &KnowledgeResponse::message),
+                               field("learning_goal", &KnowledgeResponse::learningGoal),
+                               field("knowledge_points", &KnowledgeResponse::knowledgePoints),
+                               field("knowledge_ids", &KnowledgeResponse::knowledgeIds));
+    }
+};
+
+// ---- 实现 ----
+
+namespace detail {
+
+constexpr bool sameName(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+constexpr int nameLength(const char *name)
+{
+    int n = 0;
+    while (name[n]) ++n;
+    return n;
+}
+
+// 直接写入预留好的缓冲区，空间不够时按倍数扩大
+class Writer
+{
+public:
+    explicit Writer(int reserve);
+
+    void beginObject(const char *type);
+    void key(const char *name, int length);
+    void value(const QString &text);
+    void value(const QStringList &list);
+    void value(int number);
+    void value(bool flag);
+    QByteArray finish();
+
+private:
+    QByteArray _out;
+    char *_p;
+    char *_end;
+
+    void ensure(int bytes)
+    {
+        if (_end - _p < bytes) grow(bytes);
+    }
+    void grow(int bytes);
+    void string(const QString &text);
+};
+
+// 估算编码后的长度：按每个字符 3 字节（汉字的 UTF-8 长度）
+inline int estimate(const QString &text) { return text.size() * 3 + 2; }
+inline int estimate(int) { return 11; }
+inline int estimate(bool) { return 5; }
+int estimate(const QStringList &list);
+
+// 在 JSON 文本上顺序读取
+class Reader
+{
+public:
+    Reader(const char *begin, const char *end) : _p(begin), _end(end) {}
+
+    bool consume(char c);               // 跳过空白后读到 c 则前进并返回 true
+    bool atEnd();                       // 跳过空白后是否已到末尾
+    bool key(const char **name, int *length);   // 读出字段名（原始字节，不含引号）和冒号
+    bool sameKey(const char *name, int length, const char *expected, int expectedLength) const
+    {
+        return length == expectedLength && std::memcmp(name, expected, std::size_t(length)) == 0;
+    }
+
+    // 值的类型不符（包括 null）时跳过并取默认值；只有 JSON 本身不合法时返回 false
+    bool read(QString *text);
+    bool read(QStringList *list);
+    bool read(int *number);
+    bool read(bool *flag);
+    bool skip();                        // 跳过任意一个值
+    bool raw(const char **begin, const char **end);     // 读过任意一个值，返回它的原始文本
+
+private:
+    const char *_p;
+    const char *_end;
+
+    void skipSpace();
+    bool rawString(const char **begin, const char **end, bool *escaped);
+};
+
+template <typename Message, std::size_t... I>
+int estimateFields(const Message &message, std::index_sequence<I...>)
+{
+    constexpr auto fields = Message::fields();
+    return (0 + ... + (nameLength(std::get<I>(fields).name) + 4 + estimate(message.*(std::get<I>(fields).member))));
+}
+
+template <typename Message, std::size_t... I>
+void writeFields(Writer &writer, const Message &message, std::index_sequence<I...>)
+{
+    constexpr auto fields = Message::fields();
+    ((writer.key(std::get<I>(fields).name, nameLength(std::get<I>(fields).name)),
+      writer.value(message.*(std::get<I>(fields).member))), ...);
+}
+
+// 按字段名找到对应成员并读取；返回 false 表示字段不在表中
+template <typename Message, std::size_t... I>
+bool readField(Reader &reader, const char *name, int length, Message *message, quint32 *present, bool *ok,
+               std::index_sequence<I...>)
+{
+    constexpr auto fields = Message::fields();
+    return ((reader.sameKey(name, length, std::get<I>(fields).name, nameLength(std::get<I>(fields).name))
+             && ((*ok = reader.read(&(message->*(std::get<I>(fields).member)))), *present |= 1u << I, true))
+            || ...);
+}
+
+template <typename Message, std::size_t... I>
+constexpr quint32 findBit(const char *name, std::index_sequence<I...>)
+{
+    constexpr auto fields = Message::fields();
+    quint32 bit = 0;
+    ((bit |= sameName(std::get<I>(fields).name, name) ? 1u << I : 0u), ...);
+    return bit;
+}
+
+template <typename Message>
+constexpr std::size_t fieldCount()
+{
+    return std::tuple_size<decltype(Message::fields())>::value;
+}
+
+template <typename Message>
+bool readObject(Reader &reader, Message *message, quint32 *seen, bool *typeMatched)
+{
+    if (!reader.consume('{')) {
+        return false;
+    }
+    if (reader.consume('}')) {
+        return true;
+    }
+    do {
+        const char *name;
+        int length;
+        if (!reader.key(&name, &length)) {
+            return false;
+        }
+        bool ok = true;
+        if (reader.sameKey(name, length, "type", 4)) {
+            QString type;
+            ok = reader.read(&type);
+            *typeMatched = type == QLatin1String(Message::Type);
+        } else if (!readField(reader, name, length, message, seen, &ok,
+                              std::make_index_sequence<fieldCount<Message>()>())) {
+            ok = reader.skip();
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (reader.consume(','));
+    return reader.consume('}');
+}
+
+// "type" 是 type 的回复却无法解析时记录警告
+void malformed(const char *type, const QByteArray &data);
+
+}
+
+// 读出顶层的 "type" 字段；不是 JSON 对象或没有该字段时返回空字符串
+QString typeOf(const QByteArray &data);
+
+// 编码为紧凑的 JSON，"type" 在最前
+template <typename Message>
+QByteArray encode(const Message &message)
+{
+    constexpr std::size_t count = detail::fieldCount<Message>();
+    detail::Writer writer(detail::nameLength(Message::Type) + 12
+                          + detail::estimateFields(message, std::make_index_sequence<count>()));
+    writer.beginObject(Message::Type);
+    detail::writeFields(writer, message, std::make_index_sequence<count>());
+    return writer.finish();
+}
+
+// 字段在字段表中的位：decode 的 present 中对应位为 1 表示响应里有该字段
+template <typename Message>
+constexpr quint32 fieldBit(const char *name)
+{
+    return detail::findBit<Message>(name, std::make_index_sequence<detail::fieldCount<Message>()>());
+}
+
+// 从 JSON 文本解码；不是合法的 JSON 对象或 "type" 不是 Message::Type 时返回 false
+template <typename Message>
+bool decode(const QByteArray &data, Message *message, quint32 *present = nullptr)
+{
+    constexpr std::size_t count = detail::fieldCount<Message>();
+    static_assert(count <= 32, "字段表最多 32 个字段");
+
+    detail::Reader reader(data.constData(), data.constData() + data.size());
+    quint32 seen = 0;
+    bool typeMatched = false;
+    if (!detail::readObject(reader, message, &seen, &typeMatched) || !reader.atEnd()) {
+        detail::malformed(Message::Type, data);
+        return false;
+    }
+    if (present) {
+        *present = seen;
+    }
+    return typeMatched;
+}
+
+// ---- 批量请求 ----
+// 多条请求合成一帧 {"type":"BatchType","ops":[请求, ...]}，一次往返完成。
+// 服务器按顺序执行，某条失败（登录回复 "no"，或 status 不是 success）后不再执行后面的；
+// 回复 {"type":"BatchResponse","results":[...]}，results 比 ops 短表示后面的请求被跳过。
+class Batch
+{
+public:
+    template <typename Message>
+    void add(const Message &message)
+    {
+        _ops.append(Messages::encode(message));
+    }
+
+    int size() const { return _ops.size(); }
+    QByteArray encode() const;
+
+private:
+    QList<QByteArray> _ops;
+};
+
+// 拆开 BatchResponse：每个结果还原成该请求单独发送时的回复报文（"yes"/"no" 还原为裸文本），可继续交给 decode
+bool decodeBatch(const QByteArray &data, QList<QByteArray> *results);
+
+}
+
+#endif // MESSAGES_H
@@ -0,0 +1,178 @@
+#include "metrics.h"
+
+#include <QMutex>
+#include <QtAlgorithms>
+#include <QMutexLocker>
+
+#include <map>
+#include <memory>
+
+namespace {
+
+// 注册表只在第一次使用某个名称时加锁插入，对象地址此后不变
+template <typename T>
+struct Registry {
+    QMutex mutex;
+    std::map<QString, std::unique_ptr<T>> items;
+
+    T &get(const QString &name)
+    {
+        QMutexLocker locker(&mutex);
+        std::unique_ptr<T> &item = items[name];
+        if (!item) {
+            item.reset(new T);
+        }
+        return *item;
+    }
+
+    QStringList names()
+    {
+        QMutexLocker locker(&mutex);
+        QStringList result;
+        for (const auto &item : items) {
+            result.append(item.first);
+        }
+        return result;
+    }
+};
+
+Registry<Metrics::Counter> &counters()
+{
+    static Registry<Metrics::Counter> registry;
+    return registry;
+}
+
+Registry<Metrics::Gauge> &gauges()
+{
+    static Registry<Metrics::Gauge> registry;
+    return registry;
+}
+
+Registry<Metrics::Histogram> &histograms()
+{
+    static Registry<Metrics::Histogram> registry;
+    return registry;
+}
+
+Metrics::Gauge &inFlight()
+{
+    static Metrics::Gauge &gauge = Metrics::gauge("net.in_flight");
+    return gauge;
+}
+
+}
+
+void Metrics::Gauge::add(qint64 delta)
+{
+    const qint64 value = _value.fetch_add(delta, std::memory_order_relaxed) + delta;
+    qint64 max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::Histogram::record(qint64 micros)
+{
+    micros = qMax<qint64>(0, micros);
+    const int bucket = micros == 0 ? 0 : qMin(63 - int(qCountLeadingZeroBits(quint64(micros))), Buckets - 1);
+    _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(quint64(micros), std::memory_order_relaxed);
+}
+
+qint64 Metrics::Histogram::percentile(double p) const
+{
+    const quint64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+    const quint64 rank = qMax<quint64>(1, quint64(p / 100.0 * double(total) + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        seen += bucket(i);
+        if (seen >= rank) {
+            return bucketUpper(i);
+        }
+    }
+    return bucketUpper(Buckets - 1);
+}
+
+Metrics::Counter &Metrics::counter(const QString &name)
+{
+    return counters().get(name);
+}
+
+Metrics::Gauge &Metrics::gauge(const QString &name)
+{
+    return gauges().get(name);
+}
+
+Metrics::Histogram &Metrics::histogram(const QString &name)
+{
+    return histograms().get(name);
+}
+
+const Metrics::NetMetrics &Metrics::net(const QString &type)
+{
+    static QMutex mutex;
+    static std::map<QString, NetMetrics> items;
+
+    QMutexLocker locker(&mutex);
+    auto it = items.find(type);
+    if (it == items.end()) {
+        const QString prefix = "net." + type;
+        const NetMetrics metrics = {
+            &counter(prefix + ".requests"),
+            &counter(prefix + ".timeouts"),
+            &counter(prefix + ".bytes_out"),
+            &counter(prefix + ".bytes_in"),
+            &histogram(prefix + ".rtt"),
+        };
+        it = items.emplace(type, metrics).first;
+    }
+    return it->second;
+}
+
+QStringList Metrics::counterNames()
+{
+    return counters().names();
+}
+
+QStringList Metrics::histogramNames()
+{
+    return histograms().names();
+}
+
+Metrics::RoundTrip::RoundTrip(const QString &type)
+    : _net(net(type))
+    , _received(false)
+{
+    _net.requests->add();
+    inFlight().add(1);
+    _timer.start();
+}
+
+Metrics::RoundTrip::~RoundTrip()
+{
+    if (!_received) {
+        _net.timeouts->add();
+    }
+    inFlight().add(-1);
+}
+
+void Metrics::RoundTrip::sent(qint64 bytes)
+{
+    if (bytes > 0) {
+        _net.bytesOut->add(quint64(bytes));
+    }
+}
+
+void Metrics::RoundTrip::received(qint64 bytes)
+{
+    if (!_received) {
+        _received = true;
+        _net.rtt->record(_timer.nsecsElapsed() / 1000);
+    }
+    if (bytes > 0) {
+        _net.bytesIn->add(quint64(bytes));
+    }
+}
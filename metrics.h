@@ -0,0 +1,102 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+#include <atomic>
+
+// 客户端运行指标
+// 按名称注册的计数器、仪表和直方图。更新只是几次原子操作，但按名称查找要加锁查表，
+// 热路径上应把返回的引用保存在静态变量里（对象注册后地址不变）。RoundTrip 构造时按类型查一次表，之后的更新不再查表。
+// 网络指标按消息类型命名："net.<类型>.requests/timeouts/bytes_out/bytes_in"，往返时间 "net.<类型>.rtt"。
+namespace Metrics {
+
+class Counter
+{
+public:
+    void add(quint64 n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> _value{0};
+};
+
+// 可增可减的当前值，同时记录出现过的最大值
+class Gauge
+{
+public:
+    void add(qint64 delta);
+    qint64 value() const { return _value.load(std::memory_order_relaxed); }
+    qint64 max() const { return _max.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> _value{0};
+    std::atomic<qint64> _max{0};
+};
+
+// 微秒值的直方图：第 i 个桶记录 [2^i, 2^(i+1)) 微秒，第 0 个桶包括 0
+class Histogram
+{
+public:
+    static const int Buckets = 28;      // 最大约 2^28 us ≈ 4.5 分钟
+
+    void record(qint64 micros);
+    quint64 count() const { return _count.load(std::memory_order_relaxed); }
+    quint64 sum() const { return _sum.load(std::memory_order_relaxed); }
+    quint64 bucket(int i) const { return _buckets[i].load(std::memory_order_relaxed); }
+    static qint64 bucketUpper(int i) { return qint64(1) << (i + 1); }
+
+    // 估计分位数（取所在桶的上界），p 为百分数（50 表示中位数），没有样本时返回 0
+    qint64 percentile(double p) const;
+
+private:
+    std::atomic<quint64> _buckets[Buckets] = {};
+    std::atomic<quint64> _count{0};
+    std::atomic<quint64> _sum{0};
+};
+
+Counter &counter(const QString &name);
+Gauge &gauge(const QString &name);
+Histogram &histogram(const QString &name);
+
+// 已注册的名称（升序），设置页据此列出
+QStringList counterNames();
+QStringList histogramNames();
+
+// 一种消息类型的网络指标
+struct NetMetrics {
+    Counter *requests;
+    Counter *timeouts;
+    Counter *bytesOut;
+    Counter *bytesIn;
+    Histogram *rtt;
+};
+
+// 第一次使用某个类型时注册它的全部网络指标，之后只查一次表，不再拼接名称
+const NetMetrics &net(const QString &type);
+
+// 一次请求-响应：按消息类型统计请求数、收发字节和往返时间，期间计入在途请求数 "net.in_flight"
+// 析构时仍未收到响应的计为超时
+class RoundTrip
+{
+public:
+    explicit RoundTrip(const QString &type);
+    ~RoundTrip();
+
+    void sent(qint64 bytes);
+    void received(qint64 bytes);        // 第一次调用时记录往返时间
+
+private:
+    Q_DISABLE_COPY(RoundTrip)
+
+    const NetMetrics &_net;
+    QElapsedTimer _timer;
+    bool _received;
+};
+
+}
+
+#endif // METRICS_H
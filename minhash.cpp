@@ -0,0 +1,111 @@
+#include "minhash.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+int findRoot(std::vector<int> &parent, int x)
+{
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];  // 路径减半
+        x = parent[x];
+    }
+    return x;
+}
+
+}
+
+MinHash::Hasher::Hasher(const Params &params)
+{
+    const int length = params.signatureLength();
+    _a.resize(length);
+    _b.resize(length);
+    std::uint64_t state = params.seed;
+    for (int i = 0; i < length; ++i) {
+        state = splitmix64(state);
+        _a[i] = state | 1;
+        state = splitmix64(state);
+        _b[i] = state;
+    }
+}
+
+void MinHash::Hasher::signature(const std::uint64_t *shingles, int count, std::uint32_t *out) const
+{
+    const int length = int(_a.size());
+    std::fill(out, out + length, std::numeric_limits<std::uint32_t>::max());
+    for (int s = 0; s < count; ++s) {
+        const std::uint64_t x = splitmix64(shingles[s]);
+        for (int i = 0; i < length; ++i) {
+            const std::uint32_t h = std::uint32_t((_a[i] * x + _b[i]) >> 32);
+            out[i] = std::min(out[i], h);
+        }
+    }
+}
+
+double MinHash::estimateSimilarity(const std::uint32_t *a, const std::uint32_t *b, int length)
+{
+    if (length <= 0) return 0.0;
+    int equal = 0;
+    for (int i = 0; i < length; ++i) {
+        equal += a[i] == b[i];
+    }
+    return double(equal) / length;
+}
+
+std::vector<int> MinHash::cluster(const std::vector<std::uint32_t> &signatures, int count, const Params &params)
+{
+    const int length = params.signatureLength();
+    std::vector<int> parent(count);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // 空签名（没有 shingle 的条目）不参与聚类
+    const std::uint32_t empty = std::numeric_limits<std::uint32_t>::max();
+
+    std::unordered_map<std::uint64_t, int> buckets;
+    buckets.reserve(size_t(count));
+    for (int band = 0; band < params.bands; ++band) {
+        buckets.clear();
+        for (int item = 0; item < count; ++item) {
+            const std::uint32_t *sig = signatures.data() + size_t(item) * length;
+            if (sig[0] == empty) continue;
+
+            // band 内 rows 个值合成一个桶键
+            std::uint64_t key = std::uint64_t(band) * 0x9E3779B97F4A7C15ULL;
+            const std::uint32_t *rows = sig + band * params.rows;
+            for (int r = 0; r < params.rows; ++r) {
+                key = splitmix64(key ^ rows[r]);
+            }
+
+            auto inserted = buckets.emplace(key, item);
+            if (inserted.second) continue;
+
+            // 与桶中第一个条目比较，签名估计相似度足够高才合并
+            const int other = inserted.first->second;
+            const std::uint32_t *otherSig = signatures.data() + size_t(other) * length;
+            if (estimateSimilarity(sig, otherSig, length) < params.threshold) continue;
+
+            int ra = findRoot(parent, item);
+            int rb = findRoot(parent, other);
+            if (ra != rb) {
+                parent[std::max(ra, rb)] = std::min(ra, rb);    // 以下标最小的条目为代表
+            }
+        }
+    }
+
+    std::vector<int> representative(count);
+    for (int item = 0; item < count; ++item) {
+        representative[item] = findRoot(parent, item);
+    }
+    return representative;
+}
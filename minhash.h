@@ -0,0 +1,44 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <cstdint>
+#include <vector>
+
+// MinHash 签名 + LSH 分桶的近似重复检测
+// 每个条目先转换为 shingle 哈希集合，签名长度 = bands * rows；
+// 只有至少一个 band 完全相同的条目才会被比较，整体复杂度接近线性
+namespace MinHash {
+
+struct Params {
+    int bands = 8;
+    int rows = 8;                       // 8 x 8 时相似度约 0.77 处为 50% 命中概率
+    double threshold = 0.7;             // 候选对签名估计相似度达到此值才合并
+    std::uint64_t seed = 0x5EED5EEDULL;
+
+    int signatureLength() const { return bands * rows; }
+};
+
+// 签名生成器：预先生成 bands * rows 个哈希函数，可在多个线程中同时使用
+class Hasher
+{
+public:
+    explicit Hasher(const Params &params);
+
+    // 计算一个条目的签名，out 长度为 params.signatureLength()
+    void signature(const std::uint64_t *shingles, int count, std::uint32_t *out) const;
+
+private:
+    std::vector<std::uint64_t> _a;      // h_i(x) = 高 32 位 (a_i * x + b_i)，a_i 为奇数
+    std::vector<std::uint64_t> _b;
+};
+
+// 对 count 个条目的签名（连续存放）聚类，返回每个条目所属簇的代表条目下标
+// 没有近似重复的条目代表自己
+std::vector<int> cluster(const std::vector<std::uint32_t> &signatures, int count, const Params &params);
+
+// 用签名估计两个条目的 Jaccard 相似度
+double estimateSimilarity(const std::uint32_t *a, const std::uint32_t *b, int length);
+
+}
+
+#endif // MINHASH_H
@@ -0,0 +1,41 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// 动态分块的并行循环：每个线程从共享计数器领取 chunk 个下标，调用 fn(begin, end)
+// threads <= 1 时在调用线程中直接执行
+template <typename Fn>
+void parallelFor(int count, int threads, Fn fn, int chunk = 64)
+{
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (;;) {
+            int begin = next.fetch_add(chunk);
+            if (begin >= count) break;
+            fn(begin, std::min(count, begin + chunk));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &th : pool) {
+        th.join();
+    }
+}
+
+// 0 或负数表示使用全部硬件线程
+inline int resolveThreads(int requested)
+{
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? int(hw) : 1;
+}
+
+#endif // PARALLELFOR_H
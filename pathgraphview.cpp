@@ -0,0 +1,257 @@
+#include "pathgraphview.h"
+
+#include <QGraphicsItem>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QHash>
+#include <QtConcurrent>
+#include <QtMath>
+
+namespace {
+
+// 空间分块大小：每块约 32 列 x 8 层节点
+const qreal TileWidth = PathLayout::HorizontalSpacing * 32;
+const qreal TileHeight = PathLayout::VerticalSpacing * 8;
+
+// LOD 阈值（1.0 表示 1:1 显示）
+const qreal LabelLod = 0.6;             // 大于此值才绘制文字
+const qreal OutlineLod = 0.2;           // 大于此值才绘制圆角边框
+const qreal EdgeLod = 0.05;             // 小于此值不绘制边
+
+const qreal MinScale = 0.005;
+const qreal MaxScale = 4.0;
+
+const QColor MasteredColor("#2ecc71");
+const QColor PendingColor("#3498db");
+const QColor EdgeColor("#bdc3c7");
+
+// 一个分块内的全部节点，作为单个图元绘制
+class NodeTileItem : public QGraphicsItem
+{
+public:
+    struct Node {
+        QRectF rect;
+        QString label;
+        bool mastered;
+    };
+
+    explicit NodeTileItem(const QVector<Node> &nodes)
+        : _nodes(nodes)
+    {
+        for (const Node &node : _nodes) {
+            _bounds |= node.rect;
+            (node.mastered ? _masteredRects : _pendingRects).append(node.rect);
+        }
+        _bounds.adjust(-1, -1, 1, 1);
+        setFlag(ItemUsesExtendedStyleOption);
+        setCacheMode(DeviceCoordinateCache);
+    }
+
+    QRectF boundingRect() const override { return _bounds; }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) override
+    {
+        const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+
+        // 远景：只画色块，批量提交
+        if (lod < OutlineLod) {
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(MasteredColor);
+            painter->drawRects(_masteredRects);
+            painter->setBrush(PendingColor);
+            painter->drawRects(_pendingRects);
+            return;
+        }
+
+        const QRectF exposed = option->exposedRect;
+        painter->setRenderHint(QPainter::Antialiasing, lod >= LabelLod);
+        for (const Node &node : _nodes) {
+            if (!exposed.intersects(node.rect)) continue;
+
+            painter->setPen(QPen(node.mastered ? MasteredColor.darker(120) : PendingColor.darker(120), 0));
+            painter->setBrush(node.mastered ? MasteredColor : PendingColor);
+            painter->drawRoundedRect(node.rect, 6, 6);
+
+            if (lod >= LabelLod) {
+                painter->setPen(Qt::white);
+                QRectF textRect = node.rect.adjusted(6, 0, -6, 0);
+                QString text = painter->fontMetrics().elidedText(node.label, Qt::ElideRight,
+                                                                 int(textRect.width()));
+                painter->drawText(textRect, Qt::AlignCenter, text);
+            }
+        }
+    }
+
+private:
+    QVector<Node> _nodes;
+    QVector<QRectF> _masteredRects;
+    QVector<QRectF> _pendingRects;
+    QRectF _bounds;
+};
+
+// 一个分块内的全部边，作为单个图元绘制
+class EdgeTileItem : public QGraphicsItem
+{
+public:
+    explicit EdgeTileItem(const QVector<QLineF> &lines)
+        : _lines(lines)
+    {
+        for (const QLineF &line : _lines) {
+            _bounds |= QRectF(line.p1(), line.p2()).normalized();
+        }
+        _bounds.adjust(-1, -1, 1, 1);
+        setCacheMode(DeviceCoordinateCache);
+    }
+
+    QRectF boundingRect() const override { return _bounds; }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) override
+    {
+        const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+        if (lod < EdgeLod) {
+            return;
+        }
+        painter->setPen(QPen(EdgeColor, 0));   // 0 宽度为 cosmetic pen，缩放时不变粗
+        painter->drawLines(_lines);
+    }
+
+private:
+    QVector<QLineF> _lines;
+    QRectF _bounds;
+};
+
+quint64 tileKey(const QPointF &p)
+{
+    qint32 tx = qFloor(p.x() / TileWidth);
+    qint32 ty = qFloor(p.y() / TileHeight);
+    return (quint64(quint32(tx)) << 32) | quint32(ty);
+}
+
+}
+
+PathGraphView::PathGraphView(QWidget *parent)
+    : QGraphicsView(parent)
+    , _scene(new QGraphicsScene(this))
+    , _hasPending(false)
+{
+    // 场景是静态的，BSP 索引只在重建时更新
+    _scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+    setScene(_scene);
+
+    setDragMode(QGraphicsView::ScrollHandDrag);
+    setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+    setOptimizationFlags(QGraphicsView::DontSavePainterState
+                         | QGraphicsView::DontAdjustForAntialiasing);
+    setCacheMode(QGraphicsView::CacheBackground);
+    setBackgroundBrush(Qt::white);
+
+    connect(&_watcher, &QFutureWatcher<PathLayoutResult>::finished,
+            this, &PathGraphView::onLayoutFinished);
+}
+
+PathGraphView::~PathGraphView()
+{
+    _watcher.waitForFinished();
+}
+
+void PathGraphView::setGraph(const PathGraph &graph)
+{
+    if (_watcher.isRunning()) {
+        // 正在布局，记下最新的图，完成后再算一次
+        _pendingGraph = graph;
+        _hasPending = true;
+        return;
+    }
+    _graph = graph;
+    startLayout();
+}
+
+void PathGraphView::startLayout()
+{
+    _layoutTimer.start();
+    _watcher.setFuture(QtConcurrent::run(PathLayout::compute, _graph));
+}
+
+void PathGraphView::onLayoutFinished()
+{
+    if (_hasPending) {
+        // 期间图已更新，丢弃旧结果
+        _graph = _pendingGraph;
+        _pendingGraph = PathGraph();
+        _hasPending = false;
+        startLayout();
+        return;
+    }
+
+    PathLayoutResult layout = _watcher.result();
+    buildScene(layout);
+    emit layoutFinished(_graph.names.size(), layout.layerCount, _layoutTimer.elapsed());
+}
+
+void PathGraphView::buildScene(const PathLayoutResult &layout)
+{
+    _scene->clear();
+
+    const qreal halfW = PathLayout::NodeWidth / 2;
+    const qreal halfH = PathLayout::NodeHeight / 2;
+
+    // 节点按所在分块归组
+    QHash<quint64, QVector<NodeTileItem::Node>> nodeTiles;
+    for (int i = 0; i < layout.positions.size(); ++i) {
+        const QPointF &p = layout.positions[i];
+        NodeTileItem::Node node;
+        node.rect = QRectF(p.x() - halfW, p.y() - halfH, PathLayout::NodeWidth, PathLayout::NodeHeight);
+        node.label = _graph.names.value(i);
+        node.mastered = _graph.mastered.value(i, false);
+        nodeTiles[tileKey(p)].append(node);
+    }
+
+    // 边按起点所在分块归组：从起点底部连到终点顶部
+    QHash<quint64, QVector<QLineF>> edgeTiles;
+    for (const QPair<int, int> &e : layout.edges) {
+        const QPointF &from = layout.positions[e.first];
+        const QPointF &to = layout.positions[e.second];
+        edgeTiles[tileKey(from)].append(QLineF(from.x(), from.y() + halfH, to.x(), to.y() - halfH));
+    }
+
+    for (auto it = edgeTiles.cbegin(); it != edgeTiles.cend(); ++it) {
+        EdgeTileItem *item = new EdgeTileItem(it.value());
+        item->setZValue(0);
+        _scene->addItem(item);
+    }
+    for (auto it = nodeTiles.cbegin(); it != nodeTiles.cend(); ++it) {
+        NodeTileItem *item = new NodeTileItem(it.value());
+        item->setZValue(1);
+        _scene->addItem(item);
+    }
+
+    QRectF sceneRect = layout.bounds.adjusted(-PathLayout::HorizontalSpacing, -PathLayout::VerticalSpacing,
+                                              PathLayout::HorizontalSpacing, PathLayout::VerticalSpacing);
+    _scene->setSceneRect(sceneRect);
+
+    resetTransform();
+    if (!layout.bounds.isEmpty()) {
+        fitInView(sceneRect, Qt::KeepAspectRatio);
+        // 小图不放大超过 1:1
+        if (transform().m11() > 1.0) {
+            resetTransform();
+            centerOn(sceneRect.center());
+        }
+    }
+}
+
+void PathGraphView::wheelEvent(QWheelEvent *event)
+{
+    qreal steps = event->angleDelta().y() / 120.0;
+    if (steps == 0) {
+        QGraphicsView::wheelEvent(event);
+        return;
+    }
+
+    qreal current = transform().m11();
+    qreal target = qBound(MinScale, current * qPow(1.15, steps), MaxScale);
+    scale(target / current, target / current);
+    event->accept();
+}
@@ -0,0 +1,45 @@
+#ifndef PATHGRAPHVIEW_H
+#define PATHGRAPHVIEW_H
+
+#include "pathlayout.h"
+
+#include <QGraphicsView>
+#include <QGraphicsScene>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+
+// 学习路径图视图
+// 布局在工作线程计算；节点和边按空间分块成少量图元，由 BSP 索引裁剪，
+// 绘制时根据缩放级别（LOD）省略文字和边，并使用设备坐标缓存加速平移
+class PathGraphView : public QGraphicsView
+{
+    Q_OBJECT
+
+public:
+    explicit PathGraphView(QWidget *parent = nullptr);
+    ~PathGraphView();
+
+    void setGraph(const PathGraph &graph);  // 设置路径图并在后台开始布局
+
+signals:
+    void layoutFinished(int nodeCount, int layerCount, qint64 elapsedMs);
+
+protected:
+    void wheelEvent(QWheelEvent *event) override;
+
+private slots:
+    void onLayoutFinished();            // 布局完成，重建场景
+
+private:
+    QGraphicsScene *_scene;
+    QFutureWatcher<PathLayoutResult> _watcher;
+    PathGraph _graph;                   // 当前正在显示的图
+    PathGraph _pendingGraph;            // 布局期间收到的新图
+    bool _hasPending;
+    QElapsedTimer _layoutTimer;         // 布局耗时计时
+
+    void startLayout();
+    void buildScene(const PathLayoutResult &layout);
+};
+
+#endif // PATHGRAPHVIEW_H
@@ -0,0 +1,203 @@
+#include "pathlayout.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// 压缩邻接表：offsets[v] .. offsets[v+1] 为节点 v 的邻居
+struct Adjacency
+{
+    QVector<int> offsets;
+    QVector<int> targets;
+    QVector<int> edgeIndex;             // 对应原边数组中的下标
+};
+
+Adjacency buildAdjacency(int n, const QVector<QPair<int, int>> &edges,
+                         const QVector<char> &keep, bool reverse)
+{
+    Adjacency adj;
+    adj.offsets.fill(0, n + 1);
+    for (int i = 0; i < edges.size(); ++i) {
+        if (!keep[i]) continue;
+        int from = reverse ? edges[i].second : edges[i].first;
+        adj.offsets[from + 1]++;
+    }
+    for (int v = 0; v < n; ++v) {
+        adj.offsets[v + 1] += adj.offsets[v];
+    }
+
+    adj.targets.resize(adj.offsets[n]);
+    adj.edgeIndex.resize(adj.offsets[n]);
+    QVector<int> cursor = adj.offsets;
+    for (int i = 0; i < edges.size(); ++i) {
+        if (!keep[i]) continue;
+        int from = reverse ? edges[i].second : edges[i].first;
+        int to = reverse ? edges[i].first : edges[i].second;
+        int slot = cursor[from]++;
+        adj.targets[slot] = to;
+        adj.edgeIndex[slot] = i;
+    }
+    return adj;
+}
+
+// 迭代 DFS 标记回边，避免 5 万节点时递归爆栈
+void removeCycles(int n, const QVector<QPair<int, int>> &edges, QVector<char> &keep)
+{
+    Adjacency out = buildAdjacency(n, edges, keep, false);
+    QVector<char> state(n, 0);          // 0 未访问，1 在栈中，2 已完成
+    QVector<QPair<int, int>> stack;     // (节点, 下一条待访问的边)
+
+    for (int root = 0; root < n; ++root) {
+        if (state[root] != 0) continue;
+        state[root] = 1;
+        stack.append(qMakePair(root, out.offsets[root]));
+
+        while (!stack.isEmpty()) {
+            QPair<int, int> &top = stack.last();
+            int v = top.first;
+            if (top.second < out.offsets[v + 1]) {
+                int slot = top.second++;
+                int w = out.targets[slot];
+                if (state[w] == 1) {
+                    keep[out.edgeIndex[slot]] = 0;  // 回边，删除以打破环
+                } else if (state[w] == 0) {
+                    state[w] = 1;
+                    stack.append(qMakePair(w, out.offsets[w]));
+                }
+            } else {
+                state[v] = 2;
+                stack.removeLast();
+            }
+        }
+    }
+}
+
+// 按相邻层邻居的平均位置（重心）重排一层
+void sortLayerByBarycenter(QVector<int> &layerNodes, const Adjacency &neighbours,
+                           QVector<int> &order)
+{
+    QVector<QPair<double, int>> keyed;
+    keyed.reserve(layerNodes.size());
+    for (int v : layerNodes) {
+        int begin = neighbours.offsets[v];
+        int end = neighbours.offsets[v + 1];
+        double key = order[v];
+        if (end > begin) {
+            double sum = 0;
+            for (int i = begin; i < end; ++i) {
+                sum += order[neighbours.targets[i]];
+            }
+            key = sum / (end - begin);
+        }
+        keyed.append(qMakePair(key, v));
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(),
+                     [](const QPair<double, int> &a, const QPair<double, int> &b) {
+                         return a.first < b.first;
+                     });
+
+    for (int i = 0; i < keyed.size(); ++i) {
+        layerNodes[i] = keyed[i].second;
+        order[keyed[i].second] = i;
+    }
+}
+
+}
+
+PathLayoutResult PathLayout::compute(const PathGraph &graph)
+{
+    PathLayoutResult result;
+    const int n = graph.names.size();
+    if (n == 0) {
+        return result;
+    }
+
+    // 过滤越界边和自环
+    QVector<QPair<int, int>> edges;
+    edges.reserve(graph.edges.size());
+    for (const QPair<int, int> &e : graph.edges) {
+        if (e.first >= 0 && e.first < n && e.second >= 0 && e.second < n && e.first != e.second) {
+            edges.append(e);
+        }
+    }
+
+    // 1. 去环
+    QVector<char> keep(edges.size(), 1);
+    removeCycles(n, edges, keep);
+
+    Adjacency successors = buildAdjacency(n, edges, keep, false);
+    Adjacency predecessors = buildAdjacency(n, edges, keep, true);
+
+    // 2. 最长路径分层（Kahn 拓扑序）
+    QVector<int> indegree(n, 0);
+    for (int v = 0; v < n; ++v) {
+        indegree[v] = predecessors.offsets[v + 1] - predecessors.offsets[v];
+    }
+
+    QVector<int> topo;
+    topo.reserve(n);
+    for (int v = 0; v < n; ++v) {
+        if (indegree[v] == 0) topo.append(v);
+    }
+
+    result.layers.fill(0, n);
+    for (int head = 0; head < topo.size(); ++head) {
+        int v = topo[head];
+        for (int i = successors.offsets[v]; i < successors.offsets[v + 1]; ++i) {
+            int w = successors.targets[i];
+            result.layers[w] = qMax(result.layers[w], result.layers[v] + 1);
+            if (--indegree[w] == 0) topo.append(w);
+        }
+    }
+
+    int layerCount = 0;
+    for (int v = 0; v < n; ++v) {
+        layerCount = qMax(layerCount, result.layers[v] + 1);
+    }
+    result.layerCount = layerCount;
+
+    // 3. 层内排序：初始按拓扑序，再做几轮上下扫描的重心排序以减少交叉
+    QVector<QVector<int>> layerNodes(layerCount);
+    QVector<int> order(n, 0);
+    for (int v : topo) {
+        QVector<int> &nodes = layerNodes[result.layers[v]];
+        order[v] = nodes.size();
+        nodes.append(v);
+    }
+
+    const int sweeps = 4;
+    for (int iter = 0; iter < sweeps; ++iter) {
+        for (int l = 1; l < layerCount; ++l) {
+            sortLayerByBarycenter(layerNodes[l], predecessors, order);
+        }
+        for (int l = layerCount - 2; l >= 0; --l) {
+            sortLayerByBarycenter(layerNodes[l], successors, order);
+        }
+    }
+
+    // 4. 坐标分配：每层水平居中，层间等距
+    result.positions.resize(n);
+    for (int l = 0; l < layerCount; ++l) {
+        const QVector<int> &nodes = layerNodes[l];
+        qreal offset = (nodes.size() - 1) / 2.0;
+        for (int i = 0; i < nodes.size(); ++i) {
+            result.positions[nodes[i]] = QPointF((i - offset) * HorizontalSpacing,
+                                                 l * VerticalSpacing);
+        }
+    }
+
+    qreal halfW = NodeWidth / 2;
+    qreal halfH = NodeHeight / 2;
+    for (const QPointF &p : result.positions) {
+        result.bounds |= QRectF(p.x() - halfW, p.y() - halfH, NodeWidth, NodeHeight);
+    }
+
+    result.edges.reserve(edges.size());
+    for (int i = 0; i < edges.size(); ++i) {
+        if (keep[i]) result.edges.append(edges[i]);
+    }
+
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef PATHLAYOUT_H
+#define PATHLAYOUT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+#include <QPointF>
+#include <QRectF>
+
+// 学习路径图（服务器返回的节点和有向边）
+struct PathGraph
+{
+    QStringList names;                  // 节点名称
+    QVector<bool> mastered;             // 是否已掌握
+    QVector<QPair<int, int>> edges;     // 有向边 (前置 -> 后续)
+};
+
+// 分层布局结果
+struct PathLayoutResult
+{
+    QVector<QPointF> positions;         // 每个节点的中心坐标
+    QVector<int> layers;                // 每个节点所在的层
+    QVector<QPair<int, int>> edges;     // 去环后的边
+    QRectF bounds;                      // 所有节点的包围盒
+    int layerCount = 0;
+};
+
+namespace PathLayout {
+
+// 节点尺寸与间距（场景坐标）
+constexpr qreal NodeWidth = 120;
+constexpr qreal NodeHeight = 36;
+constexpr qreal HorizontalSpacing = 160;
+constexpr qreal VerticalSpacing = 120;
+
+// 计算分层 DAG 布局（去环 -> 最长路径分层 -> 重心法排序 -> 坐标分配）
+// 纯函数，不访问任何 GUI 对象，可以在工作线程中调用
+PathLayoutResult compute(const PathGraph &graph);
+
+}
+
+#endif // PATHLAYOUT_H
@@ -0,0 +1,184 @@
+#include "quizdialog.h"
+#include "config.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+QuizDialog::QuizDialog(QSharedPointer<const ItemBank> bank, const QStringList &knowledgePoints, QWidget *parent)
+    : QDialog(parent)
+    , _bank(bank)
+    , _quiz(*bank, knowledgePoints, QUIZ_MAX_QUESTIONS)
+    , _item(-1)
+    , _answered(false)
+{
+    setWindowTitle("知识点自测");
+    setMinimumSize(520, 420);
+
+    setupUI();
+
+    setStyleSheet(R"(
+        QuizDialog {
+            background-color: #f5f5f5;
+        }
+        QLabel {
+            color: #333;
+            font-size: 14px;
+        }
+        QLabel#stem_label {
+            font-size: 16px;
+            font-weight: bold;
+            color: #2c3e50;
+        }
+        QRadioButton {
+            font-size: 14px;
+            padding: 6px;
+        }
+        QPushButton#submit_btn {
+            padding: 10px 20px;
+            border: none;
+            border-radius: 6px;
+            font-size: 14px;
+            font-weight: bold;
+            background-color: #2196F3;
+            color: white;
+        }
+        QPushButton#submit_btn:hover {
+            background-color: #1976D2;
+        }
+        QPushButton#submit_btn:disabled {
+            background-color: #cccccc;
+            color: #666666;
+        }
+    )");
+
+    showNextItem();
+}
+
+void QuizDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(30, 30, 30, 30);
+    mainLayout->setSpacing(15);
+
+    _progress_label = new QLabel(this);
+    _progress_label->setStyleSheet("color: #7f8c8d;");
+    mainLayout->addWidget(_progress_label);
+
+    _stem_label = new QLabel(this);
+    _stem_label->setObjectName("stem_label");
+    _stem_label->setWordWrap(true);
+    mainLayout->addWidget(_stem_label);
+
+    _option_group = new QButtonGroup(this);
+    for (int i = 0; i < ItemBank::MaxOptions; ++i) {
+        QRadioButton *button = new QRadioButton(this);
+        _option_group->addButton(button, i);
+        _option_buttons.append(button);
+        mainLayout->addWidget(button);
+    }
+
+    _feedback_label = new QLabel(this);
+    _feedback_label->setWordWrap(true);
+    mainLayout->addWidget(_feedback_label);
+
+    mainLayout->addStretch();
+
+    QHBoxLayout *btnLayout = new QHBoxLayout();
+    btnLayout->addStretch();
+    _submit_btn = new QPushButton("提交", this);
+    _submit_btn->setObjectName("submit_btn");
+    _submit_btn->setMinimumWidth(120);
+    btnLayout->addWidget(_submit_btn);
+    mainLayout->addLayout(btnLayout);
+
+    connect(_submit_btn, &QPushButton::clicked, this, &QuizDialog::onSubmit);
+}
+
+void QuizDialog::showNextItem()
+{
+    _item = _quiz.nextItem();
+    if (_item < 0) {
+        showResults();
+        return;
+    }
+
+    _answered = false;
+    _progress_label->setText(QString("第 %1 题（最多 %2 题）").arg(_quiz.asked() + 1).arg(_quiz.maxQuestions()));
+    _stem_label->setText(_bank->stem(_item));
+
+    const QStringList options = _bank->options(_item);
+    _option_group->setExclusive(false);     // 取消上一题的选中状态
+    for (int i = 0; i < _option_buttons.size(); ++i) {
+        _option_buttons[i]->setChecked(false);
+        _option_buttons[i]->setEnabled(true);
+        _option_buttons[i]->setVisible(i < options.size());
+        _option_buttons[i]->setText(QString("%1. %2").arg(QChar('A' + i)).arg(options.value(i)));
+    }
+    _option_group->setExclusive(true);
+
+    _feedback_label->clear();
+    _submit_btn->setText("提交");
+}
+
+void QuizDialog::onSubmit()
+{
+    if (_item < 0) {
+        accept();
+        return;
+    }
+    if (_answered) {
+        showNextItem();
+        return;
+    }
+
+    const int choice = _option_group->checkedId();
+    if (choice < 0) {
+        _feedback_label->setText("请先选择一个答案");
+        _feedback_label->setStyleSheet("color: #e67e22;");
+        return;
+    }
+
+    const int answer = _bank->answer(_item);
+    const bool correct = choice == answer;
+    _quiz.answer(_item, correct);
+    _answered = true;
+
+    for (QRadioButton *button : _option_buttons) {
+        button->setEnabled(false);
+    }
+    if (correct) {
+        _feedback_label->setText("回答正确");
+        _feedback_label->setStyleSheet("color: #27ae60;");
+    } else {
+        _feedback_label->setText(QString("回答错误，正确答案是 %1").arg(QChar('A' + answer)));
+        _feedback_label->setStyleSheet("color: #e74c3c;");
+    }
+    _submit_btn->setText(_quiz.finished() ? "查看结果" : "下一题");
+}
+
+void QuizDialog::showResults()
+{
+    QStringList lines;
+    _weak_points.clear();
+    for (const AdaptiveQuiz::PointResult &result : _quiz.results()) {
+        if (result.asked == 0) continue;
+        lines.append(QString("%1：%2/%3").arg(result.name).arg(result.correct).arg(result.asked));
+        if (result.correct * 2 < result.asked) {
+            _weak_points.append(result.name);
+        }
+    }
+    if (!_quiz.untestable().isEmpty()) {
+        lines.append(QString("题库中暂无题目：%1").arg(_quiz.untestable().join("、")));
+    }
+
+    _progress_label->setText(QString("测验结束，共 %1 题").arg(_quiz.asked()));
+    _stem_label->setText(QString("能力估计 %1（标准误 %2）")
+                             .arg(_quiz.theta(), 0, 'f', 2)
+                             .arg(_quiz.standardError(), 0, 'f', 2));
+    for (QRadioButton *button : _option_buttons) {
+        button->hide();
+    }
+    _feedback_label->setStyleSheet("color: #34495e;");
+    _feedback_label->setText(lines.join("\n"));
+    _submit_btn->setText("完成");
+}
@@ -0,0 +1,47 @@
+#ifndef QUIZDIALOG_H
+#define QUIZDIALOG_H
+
+#include <QDialog>
+#include <QLabel>
+#include <QPushButton>
+#include <QRadioButton>
+#include <QButtonGroup>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "adaptivequiz.h"
+
+// 知识点自测对话框：对声称掌握的知识点自适应出题，结束后列出答错较多的知识点
+class QuizDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    QuizDialog(QSharedPointer<const ItemBank> bank, const QStringList &knowledgePoints, QWidget *parent = nullptr);
+
+    QStringList weakPoints() const { return _weak_points; }    // 测验中答对不到一半的知识点
+
+private slots:
+    void onSubmit();                    // 提交答案 / 下一题 / 完成
+
+private:
+    QSharedPointer<const ItemBank> _bank;
+    AdaptiveQuiz _quiz;
+    int _item;                          // 当前题目，-1 表示已结束
+    bool _answered;                     // 当前题目是否已提交
+    QStringList _weak_points;
+
+    // UI 组件
+    QLabel *_progress_label;            // 进度
+    QLabel *_stem_label;                // 题干
+    QButtonGroup *_option_group;        // 选项
+    QVector<QRadioButton *> _option_buttons;
+    QLabel *_feedback_label;            // 判题结果
+    QPushButton *_submit_btn;           // 提交按钮
+
+    void setupUI();
+    void showNextItem();
+    void showResults();
+};
+
+#endif // QUIZDIALOG_H
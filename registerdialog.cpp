@@ -2,6 +2,9 @@
 #include "ui_registerdialog.h"
 #include "connectmanager.h"
 #include "config.h"
+#include "logger.h"
+#include "capture.h"
+#include "messages.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -11,8 +14,6 @@
 #include <QPushButton>
 #include <QComboBox>
 #include <QMessageBox>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QRegularExpression>
 #include <QGroupBox>
 #include <QAbstractSocket>
@@ -259,28 +260,37 @@ void RegisterDialog::setupUI()
 
 // ========== 验证方法 ==========
 
-bool RegisterDialog::validateUsername(const QString &username)
+bool RegisterDialog::checkUsername(const QString &username, QString *problem)
 {
-    if (username.isEmpty()) {
-        _username_tip->setText("");
-        return false;
-    }
-
     // 长度检查
     if (username.length() < 4 || username.length() > 20) {
-        _username_tip->setText("⚠️ 用户名长度必须在4-20个字符之间");
-        _username_tip->setStyleSheet("color: red; font-size: 12px;");
+        if (problem) *problem = "用户名长度必须在4-20个字符之间";
         return false;
     }
 
     // 格式检查：字母开头，只允许字母、数字、下划线
-    QRegularExpression regex("^[a-zA-Z][a-zA-Z0-9_]*$");
-    if (regex.match(username).hasMatch()) {
+    static const QRegularExpression regex("^[a-zA-Z][a-zA-Z0-9_]*$");
+    if (!regex.match(username).hasMatch()) {
+        if (problem) *problem = "用户名只能包含字母、数字、下划线，且必须以字母开头";
+        return false;
+    }
+    return true;
+}
+
+bool RegisterDialog::validateUsername(const QString &username)
+{
+    if (username.isEmpty()) {
+        _username_tip->setText("");
+        return false;
+    }
+
+    QString problem;
+    if (checkUsername(username, &problem)) {
         _username_tip->setText("✅ 用户名格式正确");
         _username_tip->setStyleSheet("color: green; font-size: 12px;");
         return true;
     } else {
-        _username_tip->setText("⚠️ 用户名只能包含字母、数字、下划线，且必须以字母开头");
+        _username_tip->setText("⚠️ " + problem);
         _username_tip->setStyleSheet("color: red; font-size: 12px;");
         return false;
     }
@@ -313,7 +323,7 @@ bool RegisterDialog::validateEmail(const QString &email)
 {
     if (email.isEmpty()) return true;  // 可选字段，空则通过
 
-    QRegularExpression regex("^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\\.[a-zA-Z]{2,}$");
+    static const QRegularExpression regex("^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\\.[a-zA-Z]{2,}$");
     return regex.match(email).hasMatch();
 }
 
@@ -321,7 +331,7 @@ bool RegisterDialog::validatePhone(const QString &phone)
 {
     if (phone.isEmpty()) return true;  // 可选字段，空则通过
 
-    QRegularExpression regex("^1[3-9]\\d{9}$");
+    static const QRegularExpression regex("^1[3-9]\\d{9}$");
     return regex.match(phone).hasMatch();
 }
 
@@ -467,7 +477,7 @@ void RegisterDialog::onConfirmRegister()
 {
     // 1. 检查socket连接状态
     if (_client->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "Socket未连接，当前状态:" << _client->state();
+        LOG_DEBUG() << "Socket未连接，当前状态:" << _client->state();
         _client->abort();
         _client->connectToHost("127.0.0.1", 8080);
         if (!_client->waitForConnected(3000)) {
@@ -476,7 +486,7 @@ void RegisterDialog::onConfirmRegister()
             _confirm_btn->setText("确认注册");
             return;
         }
-        qDebug() << "Socket重新连接成功";
+        LOG_DEBUG() << "Socket重新连接成功";
     }
 
     // 2. 本地验证
@@ -489,45 +499,45 @@ void RegisterDialog::onConfirmRegister()
     _confirm_btn->setText("注册中...");
 
     // 4. 构造JSON请求
-    QJsonObject json;
-    json["type"] = RegisterType;
-    json["username"] = _username_edit->text();
-    json["password"] = _password_edit->text();
-    json["email"] = _email_edit->text().isEmpty() ? "" : _email_edit->text();
-    json["phone"] = _phone_edit->text().isEmpty() ? "" : _phone_edit->text();
-    json["grade"] = _grade_combo->currentText() == "请选择" ? "" : _grade_combo->currentText();
-    json["major"] = _major_edit->text();
-    json["role"] = "student";  // 默认为学生
-
-    QJsonDocument doc(json);
+    Messages::RegisterRequest request;
+    request.username = _username_edit->text();
+    request.password = _password_edit->text();
+    request.email = _email_edit->text();
+    request.phone = _phone_edit->text();
+    request.grade = _grade_combo->currentText() == "请选择" ? QString() : _grade_combo->currentText();
+    request.major = _major_edit->text();
+    request.role = "student";  // 默认为学生
 
     // 5. 发送请求
-    qint64 bytesWritten = _client->write(doc.toJson());
+    const QByteArray data = Messages::encode(request);
+    Capture::sent(data);
+    qint64 bytesWritten = _client->write(data);
     _client->flush();
 
-    qDebug() << "发送注册请求:" << _username_edit->text() << "字节数:" << bytesWritten;
-    qDebug() << "请求数据:" << doc.toJson();
+    LOG_DEBUG() << "发送注册请求:" << _username_edit->text() << "字节数:" << bytesWritten;
+    LOG_DEBUG() << "请求数据:" << Logger::preview(data);
 }
 
 void RegisterDialog::SlotReadFromServer()
 {
     QByteArray data = _client->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    QJsonObject json = doc.object();
+    Capture::received(data);
 
-    QString type = json["type"].toString();
-    if (type != "RegisterResponse") {
-        return;  // 不是注册响应，忽略
+    Messages::RegisterResponse reply;
+    if (!Messages::decode(data, &reply)) {
+        if (Messages::typeOf(data) != Messages::RegisterResponse::Type) {
+            return;  // 不是注册响应，忽略
+        }
+        // 注册响应但格式错误：按失败处理，恢复按钮
+        reply.status = "error";
+        reply.message = "服务器回复无法解析";
     }
 
-    QString status = json["status"].toString();
-    QString message = json["message"].toString();
-
-    if (status == "success") {
-        QMessageBox::information(this, "注册成功", message);
+    if (reply.status == "success") {
+        QMessageBox::information(this, "注册成功", reply.message);
         accept();  // 关闭对话框，返回登录界面
     } else {
-        QMessageBox::warning(this, "注册失败", message);
+        QMessageBox::warning(this, "注册失败", reply.message);
         _confirm_btn->setEnabled(true);  // 重新启用按钮
         _confirm_btn->setText("确认注册");
     }
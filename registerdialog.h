@@ -20,6 +20,12 @@ public:
     explicit RegisterDialog(QWidget *parent = nullptr);
     ~RegisterDialog();
 
+    // ========== 格式检查（不依赖界面） ==========
+    static bool checkUsername(const QString &username, QString *problem = nullptr);  // problem 返回不合法的原因
+    static bool validatePassword(const QString &password);  // 验证密码
+    static bool validateEmail(const QString &email);        // 验证邮箱
+    static bool validatePhone(const QString &phone);        // 验证手机号
+
 private slots:
     void onConfirmRegister();        // 确认注册按钮点击
     void onBackToLogin();            // 返回登录按钮点击
@@ -47,10 +53,7 @@ private:
 
     // ========== 验证方法 ==========
     bool validateInput();            // 验证所有输入
-    bool validateUsername(const QString &username);  // 验证用户名
-    bool validatePassword(const QString &password);  // 验证密码
-    bool validateEmail(const QString &email);        // 验证邮箱
-    bool validatePhone(const QString &phone);        // 验证手机号
+    bool validateUsername(const QString &username);  // 验证用户名并更新提示
 
     // ========== UI更新方法 ==========
     void updatePasswordStrength(const QString &password);  // 更新密码强度提示
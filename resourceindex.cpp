@@ -0,0 +1,337 @@
+#include "resourceindex.h"
+#include "minhash.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSet>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// BM25 参数
+const float K1 = 1.2f;
+const float B = 0.75f;
+
+// 字段权重：标题 > 标签 > 描述
+const int TitleWeight = 3;
+const int TagWeight = 2;
+const int DescriptionWeight = 1;
+
+bool isCjk(QChar ch)
+{
+    ushort u = ch.unicode();
+    return (u >= 0x4E00 && u <= 0x9FFF) || (u >= 0x3400 && u <= 0x4DBF);
+}
+
+void appendVarint(QByteArray &out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+inline quint32 readVarint(const uchar *&p)
+{
+    quint32 value = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        value |= quint32(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= quint32(*p++) << shift;
+    return value;
+}
+
+// 建索引期间每个词的倒排表，文档号递增写入，直接压缩
+struct PostingBuilder {
+    QByteArray bytes;
+    int lastDoc = 0;
+    int docFreq = 0;
+};
+
+}
+
+ResourceIndex::ResourceIndex()
+    : _clusterCount(0)
+{
+}
+
+QStringList ResourceIndex::tokenize(const QString &text)
+{
+    QStringList tokens;
+    const QString folded = text.toCaseFolded();
+    QString word;
+    QString cjkRun;
+
+    auto flushWord = [&]() {
+        if (!word.isEmpty()) {
+            tokens.append(word);
+            word.clear();
+        }
+    };
+    auto flushCjk = [&]() {
+        if (cjkRun.size() == 1) {
+            tokens.append(cjkRun);
+        } else {
+            for (int i = 0; i + 1 < cjkRun.size(); ++i) {
+                tokens.append(cjkRun.mid(i, 2));
+            }
+        }
+        cjkRun.clear();
+    };
+
+    for (QChar ch : folded) {
+        if (isCjk(ch)) {
+            flushWord();
+            cjkRun.append(ch);
+        } else if (ch.isLetterOrNumber()
+                   || ((ch == QLatin1Char('+') || ch == QLatin1Char('#')) && !word.isEmpty())) {
+            flushCjk();
+            word.append(ch);
+        } else {
+            flushWord();
+            flushCjk();
+        }
+    }
+    flushWord();
+    flushCjk();
+
+    return tokens;
+}
+
+bool ResourceIndex::loadCatalog(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开资源目录 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    QVector<Resource> resources;
+    QStringList descriptions;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) continue;
+
+        QJsonObject obj = doc.object();
+        Resource res;
+        res.id = obj["id"].toString();
+        res.title = obj["title"].toString();
+        res.url = obj["url"].toString();
+        const QJsonArray tags = obj["tags"].toArray();
+        for (const QJsonValue &tag : tags) {
+            res.tags.append(tag.toString());
+        }
+        resources.append(res);
+        descriptions.append(obj["description"].toString());
+    }
+
+    build(resources, descriptions);
+    return true;
+}
+
+void ResourceIndex::addDocument(QVector<QPair<int, int>> &docTerms, const QString &text, int weight)
+{
+    const QStringList tokens = tokenize(text);
+    for (const QString &token : tokens) {
+        auto it = _termIds.constFind(token);
+        int termId;
+        if (it == _termIds.constEnd()) {
+            termId = _terms.size();
+            _termIds.insert(token, termId);
+            _terms.append(TermInfo{0, 0, 0});
+        } else {
+            termId = it.value();
+        }
+        docTerms.append(qMakePair(termId, weight));
+    }
+}
+
+void ResourceIndex::build(const QVector<Resource> &resources, const QStringList &descriptions)
+{
+    _resources = resources;
+    _idToDoc.clear();
+    _idToDoc.reserve(_resources.size());
+    for (int doc = 0; doc < _resources.size(); ++doc) {
+        _idToDoc.insert(_resources[doc].id, doc);
+    }
+    _termIds.clear();
+    _terms.clear();
+    _postings.clear();
+    _lengthNorm.clear();
+
+    const int n = _resources.size();
+    std::vector<PostingBuilder> builders;
+    QVector<int> docLength(n, 0);
+    QVector<QPair<int, int>> docTerms;
+    qint64 totalLength = 0;
+
+    for (int doc = 0; doc < n; ++doc) {
+        const Resource &res = _resources[doc];
+        docTerms.clear();
+        addDocument(docTerms, res.title, TitleWeight);
+        addDocument(docTerms, res.tags.join(' '), TagWeight);
+        addDocument(docTerms, descriptions.value(doc), DescriptionWeight);
+        builders.resize(_terms.size());
+
+        // 同一词在多个字段出现时按权重合并为一个加权词频
+        std::sort(docTerms.begin(), docTerms.end());
+        int length = 0;
+        for (int i = 0; i < docTerms.size();) {
+            int termId = docTerms[i].first;
+            int tf = 0;
+            for (; i < docTerms.size() && docTerms[i].first == termId; ++i) {
+                tf += docTerms[i].second;
+            }
+            PostingBuilder &pb = builders[termId];
+            appendVarint(pb.bytes, quint32(doc - pb.lastDoc));
+            appendVarint(pb.bytes, quint32(tf));
+            pb.lastDoc = doc;
+            pb.docFreq++;
+            length += tf;
+        }
+        docLength[doc] = length;
+        totalLength += length;
+    }
+
+    // 合并为一块连续内存
+    qint64 totalBytes = 0;
+    for (const PostingBuilder &pb : builders) totalBytes += pb.bytes.size();
+    _postings.reserve(int(totalBytes));
+    for (int t = 0; t < _terms.size(); ++t) {
+        PostingBuilder &pb = builders[t];
+        _terms[t] = TermInfo{int(_postings.size()), int(pb.bytes.size()), pb.docFreq};
+        _postings.append(pb.bytes);
+        pb.bytes = QByteArray();
+    }
+
+    const float avgLength = n > 0 ? float(totalLength) / n : 1.0f;
+    _lengthNorm.resize(n);
+    for (int doc = 0; doc < n; ++doc) {
+        _lengthNorm[doc] = K1 * (1.0f - B + B * docLength[doc] / qMax(avgLength, 1.0f));
+    }
+
+    _scores.fill(0.0f, n);
+    _touched.clear();
+
+    buildDuplicateClusters(descriptions);
+}
+
+void ResourceIndex::buildDuplicateClusters(const QStringList &descriptions)
+{
+    const int n = _resources.size();
+    const MinHash::Params params;
+    const MinHash::Hasher hasher(params);
+    const int length = params.signatureLength();
+
+    // 标题 + 描述去掉空白和标点后取相邻 3 个字符作为 shingle
+    std::vector<std::uint32_t> signatures(size_t(n) * length);
+    std::vector<std::uint64_t> shingles;
+    QVector<ushort> chars;
+    for (int doc = 0; doc < n; ++doc) {
+        const QString text = (_resources[doc].title + ' ' + descriptions.value(doc)).toCaseFolded();
+        chars.clear();
+        for (QChar ch : text) {
+            if (ch.isLetterOrNumber()) chars.append(ch.unicode());
+        }
+        shingles.clear();
+        for (int i = 0; i + 2 < chars.size(); ++i) {
+            shingles.push_back((std::uint64_t(chars[i]) << 32) | (std::uint64_t(chars[i + 1]) << 16) | chars[i + 2]);
+        }
+        hasher.signature(shingles.data(), int(shingles.size()), signatures.data() + size_t(doc) * length);
+    }
+
+    const std::vector<int> representative = MinHash::cluster(signatures, n, params);
+    _cluster.resize(n);
+    _clusterCount = 0;
+    for (int doc = 0; doc < n; ++doc) {
+        _cluster[doc] = representative[size_t(doc)];
+        if (_cluster[doc] == doc) _clusterCount++;
+    }
+}
+
+QVector<ResourceIndex::Hit> ResourceIndex::search(const QString &query, int k, bool collapseDuplicates) const
+{
+    QVector<Hit> hits;
+    const int n = _resources.size();
+    if (k <= 0 || n == 0) {
+        return hits;
+    }
+
+    QStringList tokens = tokenize(query);
+    tokens.removeDuplicates();
+
+    float *scores = _scores.data();
+    const uchar *base = reinterpret_cast<const uchar *>(_postings.constData());
+
+    // 逐词累加（term-at-a-time），解压时直接打分
+    for (const QString &token : tokens) {
+        auto it = _termIds.constFind(token);
+        if (it == _termIds.constEnd()) continue;
+
+        const TermInfo &term = _terms[it.value()];
+        const float idf = std::log(1.0f + (n - term.docFreq + 0.5f) / (term.docFreq + 0.5f));
+        const uchar *p = base + term.offset;
+        const uchar *end = p + term.length;
+        int doc = 0;
+        while (p < end) {
+            doc += int(readVarint(p));
+            const float tf = float(readVarint(p));
+            float &score = scores[doc];
+            if (score == 0.0f) {
+                _touched.append(doc);
+            }
+            score += idf * tf * (K1 + 1.0f) / (tf + _lengthNorm[doc]);
+        }
+    }
+
+    // 小顶堆保留得分最高的候选；去重时多取一些，以免同簇资源占满结果
+    const int candidates = collapseDuplicates ? k * 4 : k;
+    auto greater = [](const Hit &a, const Hit &b) { return a.score > b.score; };
+    std::priority_queue<Hit, std::vector<Hit>, decltype(greater)> heap(greater);
+    for (int doc : std::as_const(_touched)) {
+        float score = scores[doc];
+        scores[doc] = 0.0f;
+        if (int(heap.size()) < candidates) {
+            heap.push(Hit{doc, score});
+        } else if (score > heap.top().score) {
+            heap.pop();
+            heap.push(Hit{doc, score});
+        }
+    }
+    _touched.clear();
+
+    hits.resize(int(heap.size()));
+    for (int i = hits.size() - 1; i >= 0; --i) {
+        hits[i] = heap.top();
+        heap.pop();
+    }
+
+    if (collapseDuplicates) {
+        QSet<int> seenClusters;
+        QVector<Hit> unique;
+        for (const Hit &hit : std::as_const(hits)) {
+            if (unique.size() >= k) break;
+            if (!seenClusters.contains(_cluster[hit.doc])) {
+                seenClusters.insert(_cluster[hit.doc]);
+                unique.append(hit);
+            }
+        }
+        return unique;
+    }
+    hits.resize(qMin(k, hits.size()));
+    return hits;
+}
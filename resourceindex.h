@@ -0,0 +1,74 @@
+#ifndef RESOURCEINDEX_H
+#define RESOURCEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
+
+// 学习资源本地全文检索
+// 对资源目录（标题、标签、描述）建立倒排索引，倒排表按 (文档号差值, 词频) 做变长整数压缩，
+// 查询使用 BM25 打分并用小顶堆取 top-k
+// 建索引时用 MinHash/LSH 把镜像、重复上传等近似重复资源归为一簇，检索结果每簇只保留一条
+class ResourceIndex
+{
+public:
+    struct Resource {
+        QString id;
+        QString title;
+        QStringList tags;
+        QString url;
+    };
+
+    struct Hit {
+        int doc;                        // 资源下标
+        float score;                    // BM25 得分
+    };
+
+    ResourceIndex();
+
+    // 从 JSON Lines 文件加载资源目录并建立索引，每行一个
+    // {"id": ..., "title": ..., "tags": [...], "description": ..., "url": ...}
+    bool loadCatalog(const QString &path, QString *error = nullptr);
+
+    // 直接从内存中的资源建立索引（description 只参与索引，不保存）
+    void build(const QVector<Resource> &resources, const QStringList &descriptions);
+
+    // 检索得分最高的 k 个资源，按得分降序；collapseDuplicates 为 true 时每个近似重复簇只返回一条
+    // 内部复用累加缓冲区，同一个索引对象不能在多个线程中同时查询
+    QVector<Hit> search(const QString &query, int k, bool collapseDuplicates = true) const;
+
+    int size() const { return _resources.size(); }
+    const Resource &resource(int doc) const { return _resources[doc]; }
+    int findById(const QString &id) const { return _idToDoc.value(id, -1); }
+    int cluster(int doc) const { return _cluster[doc]; }  // 近似重复簇的代表资源下标
+    int clusterCount() const { return _clusterCount; }
+
+    // 分词：拉丁字母/数字按连续串切分（保留 + 和 #，如 c++、c#），中文按相邻二字切分
+    static QStringList tokenize(const QString &text);
+
+private:
+    struct TermInfo {
+        int offset;                     // 在 _postings 中的起始位置
+        int length;                     // 压缩后的字节数
+        int docFreq;                    // 包含该词的文档数
+    };
+
+    QVector<Resource> _resources;
+    QHash<QString, int> _idToDoc;
+    QHash<QString, int> _termIds;
+    QVector<TermInfo> _terms;
+    QByteArray _postings;               // 所有词的压缩倒排表
+    QVector<float> _lengthNorm;         // 每个文档预计算的 k1 * (1 - b + b * dl / avgdl)
+    QVector<int> _cluster;              // 每个文档所属近似重复簇
+    int _clusterCount;
+
+    mutable QVector<float> _scores;     // 查询时的得分累加器，按文档下标
+    mutable QVector<int> _touched;      // 本次查询命中的文档，用于快速清零
+
+    void addDocument(QVector<QPair<int, int>> &docTerms, const QString &text, int weight);
+    void buildDuplicateClusters(const QStringList &descriptions);
+};
+
+#endif // RESOURCEINDEX_H
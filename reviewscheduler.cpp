@@ -0,0 +1,271 @@
+#include "reviewscheduler.h"
+
+#include <QJsonValue>
+
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+const qint64 SecondsPerDay = 24 * 3600;
+const int InitialEaseX100 = 250;
+const int MinEaseX100 = 130;
+
+}
+
+ReviewScheduler::ReviewScheduler()
+{
+}
+
+bool ReviewScheduler::earlier(int a, int b) const
+{
+    const Card &ca = _cards[size_t(a)];
+    const Card &cb = _cards[size_t(b)];
+    return ca.due != cb.due ? ca.due < cb.due : a < b;
+}
+
+void ReviewScheduler::place(int pos, int card)
+{
+    _heap[size_t(pos)] = card;
+    _heapPos[size_t(card)] = pos;
+}
+
+void ReviewScheduler::siftUp(int pos)
+{
+    const int card = _heap[size_t(pos)];
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+        if (!earlier(card, _heap[size_t(parent)])) break;
+        place(pos, _heap[size_t(parent)]);
+        pos = parent;
+    }
+    place(pos, card);
+}
+
+void ReviewScheduler::siftDown(int pos)
+{
+    const int size = int(_heap.size());
+    const int card = _heap[size_t(pos)];
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && earlier(_heap[size_t(child + 1)], _heap[size_t(child)])) {
+            ++child;
+        }
+        if (!earlier(_heap[size_t(child)], card)) break;
+        place(pos, _heap[size_t(child)]);
+        pos = child;
+    }
+    place(pos, card);
+}
+
+void ReviewScheduler::reschedule(int card)
+{
+    const int pos = _heapPos[size_t(card)];
+    siftUp(pos);
+    siftDown(_heapPos[size_t(card)]);
+}
+
+void ReviewScheduler::markDirty(int card)
+{
+    if (!_dirty[size_t(card)]) {
+        _dirty[size_t(card)] = 1;
+        _dirtyList.push_back(card);
+    }
+}
+
+int ReviewScheduler::addCard(const QString &id, qint64 due)
+{
+    auto it = _index.constFind(id);
+    if (it != _index.constEnd()) {
+        return it.value();
+    }
+
+    _removed.removeAll(id);             // 删除后又加回来的，以新卡片覆盖服务器的记录
+    const int index = int(_cards.size());
+    _cards.push_back({id, due, 0, 0, InitialEaseX100, 0, 0});
+    _index.insert(id, index);
+    _heapPos.push_back(int(_heap.size()));
+    _heap.push_back(index);
+    _dirty.push_back(0);
+    siftUp(int(_heap.size()) - 1);
+    markDirty(index);
+    return index;
+}
+
+void ReviewScheduler::removeCard(const QString &id)
+{
+    const int index = find(id);
+    if (index < 0) {
+        return;
+    }
+    _index.remove(id);
+    _removed.append(id);
+
+    // 先把堆中最后一个元素移到被删位置
+    const int pos = _heapPos[size_t(index)];
+    const int lastCard = _heap.back();
+    _heap.pop_back();
+    if (lastCard != index) {
+        place(pos, lastCard);
+        reschedule(lastCard);
+    }
+
+    _dirtyList.erase(std::remove(_dirtyList.begin(), _dirtyList.end(), index), _dirtyList.end());
+
+    // 再把最后一张卡片移到被删卡片的下标上，修正各处引用
+    const int moved = int(_cards.size()) - 1;
+    if (moved != index) {
+        _cards[size_t(index)] = _cards[size_t(moved)];
+        _index[_cards[size_t(index)].id] = index;
+        _heapPos[size_t(index)] = _heapPos[size_t(moved)];
+        _heap[size_t(_heapPos[size_t(index)])] = index;
+        _dirty[size_t(index)] = _dirty[size_t(moved)];
+        std::replace(_dirtyList.begin(), _dirtyList.end(), moved, index);
+    }
+    _cards.pop_back();
+    _heapPos.pop_back();
+    _dirty.pop_back();
+}
+
+void ReviewScheduler::review(int index, int grade, qint64 now)
+{
+    Card &c = _cards[size_t(index)];
+    grade = qBound(0, grade, 5);
+
+    if (grade < 3) {
+        // 没想起来：从头开始，明天再复习
+        c.repetitions = 0;
+        c.interval = 1;
+        c.lapses++;
+    } else {
+        if (c.repetitions == 0) {
+            c.interval = 1;
+        } else if (c.repetitions == 1) {
+            c.interval = 6;
+        } else {
+            c.interval = int((qint64(c.interval) * c.easeX100 + 50) / 100);
+        }
+        c.repetitions++;
+    }
+
+    // EF' = EF + 0.1 - (5 - q) * (0.08 + (5 - q) * 0.02)，以 ×100 的整数计算
+    const int miss = 5 - grade;
+    c.easeX100 = qMax(MinEaseX100, c.easeX100 + 10 - miss * (8 + miss * 2));
+    c.lastReview = now;
+    c.due = now + qint64(c.interval) * SecondsPerDay;
+
+    reschedule(index);
+    markDirty(index);
+}
+
+int ReviewScheduler::dueCount(qint64 now) const
+{
+    // 只访问到期的节点及其直接子节点
+    int result = 0;
+    std::vector<int> stack;
+    if (!_heap.empty()) stack.push_back(0);
+    while (!stack.empty()) {
+        const int pos = stack.back();
+        stack.pop_back();
+        if (_cards[size_t(_heap[size_t(pos)])].due > now) continue;
+        ++result;
+        for (int child = 2 * pos + 1; child <= 2 * pos + 2 && child < int(_heap.size()); ++child) {
+            stack.push_back(child);
+        }
+    }
+    return result;
+}
+
+std::vector<int> ReviewScheduler::dueCards(qint64 now, int max) const
+{
+    // 在堆上做最优优先遍历：候选集合只包含已输出节点的子节点
+    std::vector<int> result;
+    auto later = [this](int a, int b) { return earlier(_heap[size_t(b)], _heap[size_t(a)]); };
+    std::priority_queue<int, std::vector<int>, decltype(later)> frontier(later);
+    if (!_heap.empty()) frontier.push(0);
+    while (!frontier.empty() && int(result.size()) < max) {
+        const int pos = frontier.top();
+        frontier.pop();
+        const int card = _heap[size_t(pos)];
+        if (_cards[size_t(card)].due > now) break;
+        result.push_back(card);
+        for (int child = 2 * pos + 1; child <= 2 * pos + 2 && child < int(_heap.size()); ++child) {
+            frontier.push(child);
+        }
+    }
+    return result;
+}
+
+QJsonArray ReviewScheduler::dirtyBatch(int max) const
+{
+    QJsonArray batch;
+    for (size_t i = 0; i < _dirtyList.size() && batch.size() < max; ++i) {
+        const Card &c = _cards[size_t(_dirtyList[i])];
+        QJsonArray row;
+        row.append(c.id);
+        row.append(double(c.due));
+        row.append(double(c.lastReview));
+        row.append(c.interval);
+        row.append(c.easeX100);
+        row.append(c.repetitions);
+        row.append(c.lapses);
+        batch.append(row);
+    }
+    return batch;
+}
+
+void ReviewScheduler::markSynced(const QJsonArray &batch, const QStringList &removed)
+{
+    for (const QString &id : removed) {
+        _removed.removeAll(id);
+    }
+    for (const QJsonValue &value : batch) {
+        const QJsonArray row = value.toArray();
+        const int index = find(row.at(0).toString());
+        // 上传期间又复习过的卡片保持待同步
+        if (index >= 0 && qint64(row.at(2).toDouble()) == _cards[size_t(index)].lastReview
+            && qint64(row.at(1).toDouble()) == _cards[size_t(index)].due) {
+            _dirty[size_t(index)] = 0;
+        }
+    }
+    _dirtyList.erase(std::remove_if(_dirtyList.begin(), _dirtyList.end(),
+                                    [this](int card) { return !_dirty[size_t(card)]; }),
+                     _dirtyList.end());
+}
+
+int ReviewScheduler::applyBatch(const QJsonArray &batch)
+{
+    int updated = 0;
+    for (const QJsonValue &value : batch) {
+        const QJsonArray row = value.toArray();
+        const QString id = row.at(0).toString();
+        if (id.isEmpty() || row.size() < 7 || _removed.contains(id)) {
+            continue;
+        }
+        const qint64 lastReview = qint64(row.at(2).toDouble());
+        int index = find(id);
+        if (index >= 0 && _cards[size_t(index)].lastReview >= lastReview) {
+            continue;
+        }
+        if (index < 0) {
+            index = addCard(id, 0);
+        }
+
+        Card &c = _cards[size_t(index)];
+        c.due = qint64(row.at(1).toDouble());
+        c.lastReview = lastReview;
+        c.interval = row.at(3).toInt();
+        c.easeX100 = qMax(MinEaseX100, row.at(4).toInt(InitialEaseX100));
+        c.repetitions = row.at(5).toInt();
+        c.lapses = row.at(6).toInt();
+        reschedule(index);
+        // 与服务器一致，不需要再上传
+        _dirty[size_t(index)] = 0;
+        updated++;
+    }
+    _dirtyList.erase(std::remove_if(_dirtyList.begin(), _dirtyList.end(),
+                                    [this](int card) { return !_dirty[size_t(card)]; }),
+                     _dirtyList.end());
+    return updated;
+}
@@ -0,0 +1,82 @@
+#ifndef REVIEWSCHEDULER_H
+#define REVIEWSCHEDULER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonArray>
+
+#include <vector>
+
+// 知识点间隔复习（SM-2）
+// 每个知识点是一张卡片，记录间隔、难度系数和下次复习时间；
+// 卡片按下次复习时间放在带位置索引的二叉最小堆中，
+// 取最早到期的卡片 O(1)，复习、新增、删除后调整堆 O(log n)，列出 k 张到期卡片 O(k log k)。
+// 修改过的卡片记为待同步，按批次以紧凑数组 [id, due, last, interval, ease×100, reps, lapses] 上传；
+// 删除的卡片记下 id 随同一批上传，服务器删除之前不会被下发的旧记录重新加回来。
+// 时间均为 Unix 秒。
+class ReviewScheduler
+{
+public:
+    // 复习评分（SM-2 的 0~5 分）
+    enum Grade {
+        Forgot = 1,                     // 忘记了
+        Hard = 3,                       // 很吃力
+        Good = 4,                       // 想起来了
+        Easy = 5                        // 很轻松
+    };
+
+    struct Card {
+        QString id;                     // 知识点规范 id
+        qint64 due;                     // 下次复习时间
+        qint64 lastReview;              // 上次复习时间，0 表示还没复习过
+        int interval;                   // 当前间隔（天）
+        int easeX100;                   // 难度系数 ×100，初始 250，最低 130
+        int repetitions;                // 连续答对次数
+        int lapses;                     // 遗忘次数
+    };
+
+    ReviewScheduler();
+
+    int count() const { return int(_cards.size()); }
+    int find(const QString &id) const { return _index.value(id, -1); }
+    const Card &card(int index) const { return _cards[size_t(index)]; }
+
+    // 新增卡片（已存在时直接返回其下标），第一次复习安排在 due
+    int addCard(const QString &id, qint64 due);
+    void removeCard(const QString &id);
+
+    // 按评分更新间隔和难度系数，并重新安排复习时间
+    void review(int index, int grade, qint64 now);
+
+    int nextDue() const { return _heap.empty() ? -1 : _heap.front(); }   // 最早到期的卡片，没有卡片时返回 -1
+    int dueCount(qint64 now) const;
+    std::vector<int> dueCards(qint64 now, int max) const;              // 按到期时间升序
+
+    // 同步：取出最多 max 张待上传的卡片和最多 max 个待删除的 id；上传成功后调用 markSynced
+    QJsonArray dirtyBatch(int max) const;
+    QStringList removedBatch(int max) const { return _removed.mid(0, max); }
+    void markSynced(const QJsonArray &batch, const QStringList &removed = QStringList());
+    bool hasDirty() const { return !_dirtyList.empty() || !_removed.isEmpty(); }
+
+    // 合并服务器下发的卡片，以上次复习时间较新的一方为准，待删除的卡片不合并；返回更新的卡片数
+    int applyBatch(const QJsonArray &batch);
+
+private:
+    std::vector<Card> _cards;
+    QHash<QString, int> _index;         // id -> 卡片下标
+    std::vector<int> _heap;             // 卡片下标，按 due 组成最小堆
+    std::vector<int> _heapPos;          // 卡片下标 -> 在 _heap 中的位置
+    std::vector<char> _dirty;
+    std::vector<int> _dirtyList;
+    QStringList _removed;               // 已删除、尚未通知服务器的卡片 id
+
+    bool earlier(int a, int b) const;
+    void place(int pos, int card);
+    void siftUp(int pos);
+    void siftDown(int pos);
+    void reschedule(int card);
+    void markDirty(int card);
+};
+
+#endif // REVIEWSCHEDULER_H
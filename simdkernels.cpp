@@ -0,0 +1,436 @@
+#include "simdkernels.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMDKERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要按函数打开 AVX2 指令（i386 上 SSE2 也是），MSVC 可以直接使用
+#if defined(SIMDKERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMDKERNELS_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMDKERNELS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMDKERNELS_TARGET_POPCNT __attribute__((target("popcnt")))
+#else
+#define SIMDKERNELS_TARGET_SSE2
+#define SIMDKERNELS_TARGET_AVX2
+#define SIMDKERNELS_TARGET_POPCNT
+#endif
+
+namespace {
+
+using DotF32Fn = float (*)(const float *, const float *, int);
+using DotI8Fn = std::int32_t (*)(const std::int8_t *, const std::int8_t *, int);
+using AndPopcountFn = int (*)(const std::uint64_t *, const std::uint64_t *, int);
+using ArgmaxInformationFn = int (*)(const float *, const float *, const float *, const float *, float, int, float *);
+
+// 3PL 模型的 Fisher 信息量：P = c + (1 - c) / (1 + e)，其中 e = exp(-a(theta - b))，
+// I = a^2 (P - c)^2 (1 - P) / ((1 - c)^2 P)，化简为 a^2 (1 - c) e / ((1 + e)^2 (1 + c e))，只需一次除法
+inline float information3pl(float a, float b, float c, float theta)
+{
+    const float e = std::exp(std::fmin(std::fmax(-a * (theta - b), -80.0f), 80.0f));
+    const float onePlusE = 1.0f + e;
+    return a * a * (1.0f - c) * e / (onePlusE * onePlusE * (1.0f + c * e));
+}
+
+// 不依赖 POPCNT 指令的 64 位计数（SWAR）
+inline int popcount64(std::uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return int((x * 0x0101010101010101ULL) >> 56);
+}
+
+#ifdef SIMDKERNELS_X86
+
+SIMDKERNELS_TARGET_SSE2
+float dotF32Sse(const float *a, const float *b, int dim)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc0);
+    float sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < dim; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+SIMDKERNELS_TARGET_SSE2
+std::int32_t dotI8Sse(const std::int8_t *a, const std::int8_t *b, int dim)
+{
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        // SSE2 没有符号扩展指令：把字节放到高 8 位再算术右移
+        __m128i aLo = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i aHi = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i bLo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i bHi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(aLo, bLo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(aHi, bHi));
+    }
+    alignas(16) std::int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    std::int32_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < dim; ++i) {
+        sum += std::int32_t(a[i]) * b[i];
+    }
+    return sum;
+}
+
+SIMDKERNELS_TARGET_AVX2
+float dotF32Avx2(const float *a, const float *b, int dim)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum4);
+    float sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < dim; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+SIMDKERNELS_TARGET_AVX2
+std::int32_t dotI8Avx2(const std::int8_t *a, const std::int8_t *b, int dim)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    alignas(16) std::int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), sum4);
+    std::int32_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < dim; ++i) {
+        sum += std::int32_t(a[i]) * b[i];
+    }
+    return sum;
+}
+
+SIMDKERNELS_TARGET_POPCNT
+inline std::uint64_t popcnt64(std::uint64_t x)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return std::uint64_t(_mm_popcnt_u64(x));
+#else
+    return std::uint64_t(_mm_popcnt_u32(std::uint32_t(x)) + _mm_popcnt_u32(std::uint32_t(x >> 32)));
+#endif
+}
+
+SIMDKERNELS_TARGET_POPCNT
+int andPopcountPopcnt(const std::uint64_t *a, const std::uint64_t *b, int words)
+{
+    // 四路累加，打断 popcnt 之间的依赖链
+    std::uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    int i = 0;
+    for (; i + 4 <= words; i += 4) {
+        c0 += popcnt64(a[i] & b[i]);
+        c1 += popcnt64(a[i + 1] & b[i + 1]);
+        c2 += popcnt64(a[i + 2] & b[i + 2]);
+        c3 += popcnt64(a[i + 3] & b[i + 3]);
+    }
+    for (; i < words; ++i) {
+        c0 += popcnt64(a[i] & b[i]);
+    }
+    return int(c0 + c1 + c2 + c3);
+}
+
+// Mula 的半字节查表法：vpshufb 查 4 位计数，vpsadbw 把字节计数横向累加成 64 位
+SIMDKERNELS_TARGET_AVX2
+int andPopcountAvx2(const std::uint64_t *a, const std::uint64_t *b, int words)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowMask));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    std::uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < words; ++i) {
+        sum += std::uint64_t(popcount64(a[i] & b[i]));
+    }
+    return int(sum);
+}
+
+// e^x 的 AVX2 近似：x = n ln2 + r，|r| <= ln2 / 2，e^r 用 6 阶多项式，相对误差约 1e-7
+SIMDKERNELS_TARGET_AVX2
+inline __m256 exp256(__m256 x)
+{
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-80.0f)), _mm256_set1_ps(80.0f));
+    const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693145752f), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(1.42860677e-6f), r);
+
+    __m256 p = _mm256_set1_ps(1.0f / 720.0f);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 120.0f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 24.0f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 6.0f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(0.5f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+
+    const __m256i exponent = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(exponent));
+}
+
+SIMDKERNELS_TARGET_AVX2
+int argmaxInformation3plAvx2(const float *a, const float *b, const float *c, const float *weight,
+                             float theta, int n, float *best)
+{
+    const __m256 vTheta = _mm256_set1_ps(theta);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 bestValue = _mm256_setzero_ps();
+    __m256i bestIndex = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 va = _mm256_loadu_ps(a + i);
+        const __m256 vc = _mm256_loadu_ps(c + i);
+        const __m256 e = exp256(_mm256_mul_ps(va, _mm256_sub_ps(_mm256_loadu_ps(b + i), vTheta)));
+        const __m256 onePlusE = _mm256_add_ps(one, e);
+        const __m256 num = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(va, va), _mm256_sub_ps(one, vc)),
+                                         _mm256_mul_ps(e, _mm256_loadu_ps(weight + i)));
+        const __m256 den = _mm256_mul_ps(_mm256_mul_ps(onePlusE, onePlusE), _mm256_fmadd_ps(vc, e, one));
+        const __m256 info = _mm256_div_ps(num, den);
+
+        // 每个通道各自记录最大值，严格大于才替换，保证并列时取下标小的
+        const __m256 greater = _mm256_cmp_ps(info, bestValue, _CMP_GT_OQ);
+        bestValue = _mm256_blendv_ps(bestValue, info, greater);
+        bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex),
+                                                         _mm256_castsi256_ps(index), greater));
+        index = _mm256_add_epi32(index, step);
+    }
+
+    alignas(32) float values[8];
+    alignas(32) int indices[8];
+    _mm256_store_ps(values, bestValue);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(indices), bestIndex);
+    float bestInfo = 0.0f;
+    int result = -1;
+    for (int lane = 0; lane < 8; ++lane) {
+        if (indices[lane] >= 0 && (values[lane] > bestInfo || (values[lane] == bestInfo && indices[lane] < result))) {
+            bestInfo = values[lane];
+            result = indices[lane];
+        }
+    }
+    for (; i < n; ++i) {
+        const float info = information3pl(a[i], b[i], c[i], theta) * weight[i];
+        if (info > bestInfo) {
+            bestInfo = info;
+            result = i;
+        }
+    }
+    if (best) *best = bestInfo;
+    return result;
+}
+
+bool cpuHasAvx2()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || !fma) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;    // 操作系统需保存 YMM 寄存器
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+// x86_64 一定支持 SSE2，i386 上可能没有
+bool cpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasPopcnt()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("popcnt");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 23)) != 0;
+#else
+    return false;
+#endif
+}
+
+#endif // SIMDKERNELS_X86
+
+struct Dispatch {
+    DotF32Fn dotF32;
+    DotI8Fn dotI8;
+    AndPopcountFn andPopcount;
+    ArgmaxInformationFn argmaxInformation;
+    const char *isa;
+
+    Dispatch()
+    {
+#ifdef SIMDKERNELS_X86
+        if (cpuHasAvx2()) {
+            dotF32 = dotF32Avx2;
+            dotI8 = dotI8Avx2;
+            andPopcount = andPopcountAvx2;
+            argmaxInformation = argmaxInformation3plAvx2;
+            isa = "avx2";
+        } else if (cpuHasSse2()) {
+            dotF32 = dotF32Sse;
+            dotI8 = dotI8Sse;
+            andPopcount = cpuHasPopcnt() ? andPopcountPopcnt : SimdKernels::andPopcountScalar;
+            argmaxInformation = SimdKernels::argmaxInformation3plScalar;  // SSE2 没有 FMA 和舍入指令，不值得单独实现
+            isa = "sse2";
+        } else {
+            dotF32 = SimdKernels::dotF32Scalar;
+            dotI8 = SimdKernels::dotI8Scalar;
+            andPopcount = cpuHasPopcnt() ? andPopcountPopcnt : SimdKernels::andPopcountScalar;
+            argmaxInformation = SimdKernels::argmaxInformation3plScalar;
+            isa = "scalar";
+        }
+#else
+        dotF32 = SimdKernels::dotF32Scalar;
+        dotI8 = SimdKernels::dotI8Scalar;
+        andPopcount = SimdKernels::andPopcountScalar;
+        argmaxInformation = SimdKernels::argmaxInformation3plScalar;
+        isa = "scalar";
+#endif
+    }
+};
+
+const Dispatch &dispatch()
+{
+    static const Dispatch d;            // C++11 起局部静态变量初始化是线程安全的
+    return d;
+}
+
+}
+
+float SimdKernels::dotF32Scalar(const float *a, const float *b, int dim)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < dim; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+std::int32_t SimdKernels::dotI8Scalar(const std::int8_t *a, const std::int8_t *b, int dim)
+{
+    std::int32_t sum = 0;
+    for (int i = 0; i < dim; ++i) {
+        sum += std::int32_t(a[i]) * b[i];
+    }
+    return sum;
+}
+
+int SimdKernels::andPopcountScalar(const std::uint64_t *a, const std::uint64_t *b, int words)
+{
+    int sum = 0;
+    for (int i = 0; i < words; ++i) {
+        sum += popcount64(a[i] & b[i]);
+    }
+    return sum;
+}
+
+int SimdKernels::argmaxInformation3plScalar(const float *a, const float *b, const float *c, const float *weight,
+                                            float theta, int n, float *best)
+{
+    float bestInfo = 0.0f;
+    int result = -1;
+    for (int i = 0; i < n; ++i) {
+        const float info = information3pl(a[i], b[i], c[i], theta) * weight[i];
+        if (info > bestInfo) {
+            bestInfo = info;
+            result = i;
+        }
+    }
+    if (best) *best = bestInfo;
+    return result;
+}
+
+float SimdKernels::dotF32(const float *a, const float *b, int dim)
+{
+    return dispatch().dotF32(a, b, dim);
+}
+
+std::int32_t SimdKernels::dotI8(const std::int8_t *a, const std::int8_t *b, int dim)
+{
+    return dispatch().dotI8(a, b, dim);
+}
+
+int SimdKernels::andPopcount(const std::uint64_t *a, const std::uint64_t *b, int words)
+{
+    return dispatch().andPopcount(a, b, words);
+}
+
+int SimdKernels::argmaxInformation3pl(const float *a, const float *b, const float *c, const float *weight,
+                                      float theta, int n, float *best)
+{
+    return dispatch().argmaxInformation(a, b, c, weight, theta, n, best);
+}
+
+const char *SimdKernels::activeIsa()
+{
+    return dispatch().isa;
+}
@@ -0,0 +1,33 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstdint>
+
+// 向量点积、位集计数与 IRT 信息量内核
+// 首次调用时按 CPU 支持情况选择 AVX2+FMA / SSE2 / 标量实现，之后直接走函数指针
+namespace SimdKernels {
+
+float dotF32(const float *a, const float *b, int dim);
+std::int32_t dotI8(const std::int8_t *a, const std::int8_t *b, int dim);
+
+// a & b 中置位的个数，a、b 各 words 个 64 位字
+int andPopcount(const std::uint64_t *a, const std::uint64_t *b, int words);
+
+// 三参数 IRT 模型下能力为 theta 时各题的 Fisher 信息量乘以 weight，返回最大者的下标（weight 全为 0 时返回 -1）
+// a、b、c 为区分度、难度、猜测参数，均为 n 个元素的数组；best 非空时写入最大信息量
+int argmaxInformation3pl(const float *a, const float *b, const float *c, const float *weight,
+                         float theta, int n, float *best = nullptr);
+
+// 标量实现，供不支持 SIMD 的平台和结果校验使用
+float dotF32Scalar(const float *a, const float *b, int dim);
+std::int32_t dotI8Scalar(const std::int8_t *a, const std::int8_t *b, int dim);
+int andPopcountScalar(const std::uint64_t *a, const std::uint64_t *b, int words);
+int argmaxInformation3plScalar(const float *a, const float *b, const float *c, const float *weight,
+                               float theta, int n, float *best = nullptr);
+
+// 当前使用的指令集名称："avx2"、"sse2" 或 "scalar"
+const char *activeIsa();
+
+}
+
+#endif // SIMDKERNELS_H
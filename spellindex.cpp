@@ -0,0 +1,170 @@
+#include "spellindex.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+std::uint64_t hashUnits(const char16_t *units, std::size_t length)
+{
+    std::uint64_t h = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < length; ++i) {
+        h ^= std::uint64_t(units[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// 递归删除字符，depth 为已删除的个数；start 之前的位置不再删除，避免重复生成同一变体
+void deletes(std::u16string &word, std::size_t start, int depth, int maxDistance, std::vector<std::uint64_t> *out)
+{
+    out->push_back(hashUnits(word.data(), word.size()));
+    if (depth == maxDistance || word.empty()) {
+        return;
+    }
+    for (std::size_t i = start; i < word.size(); ++i) {
+        const char16_t removed = word[i];
+        word.erase(i, 1);
+        deletes(word, i, depth + 1, maxDistance, out);
+        word.insert(word.begin() + std::ptrdiff_t(i), removed);
+    }
+}
+
+}
+
+SpellIndex::SpellIndex()
+    : _maxDistance(2)
+{
+}
+
+int SpellIndex::maxDistanceFor(std::size_t length)
+{
+    if (length <= 2) return 0;
+    if (length <= 5) return 1;
+    return 2;
+}
+
+void SpellIndex::variants(const std::u16string &word, int maxDistance, std::vector<std::uint64_t> *out)
+{
+    std::u16string prefix = word.substr(0, PrefixLength);
+    const std::size_t begin = out->size();
+    deletes(prefix, 0, 0, maxDistance, out);
+    // 同一个词删除不同位置可能得到相同变体（如 "aab"），去重
+    std::sort(out->begin() + std::ptrdiff_t(begin), out->end());
+    out->erase(std::unique(out->begin() + std::ptrdiff_t(begin), out->end()), out->end());
+}
+
+void SpellIndex::build(const std::vector<std::u16string> &terms, const std::vector<std::uint32_t> &weights,
+                       int maxDistance)
+{
+    _terms = terms;
+    _weights = weights;
+    _weights.resize(_terms.size(), 0);
+    _maxDistance = maxDistance;
+
+    // 收集 (变体哈希, 词条) 对后排序，压成 CSR
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> pairs;
+    std::vector<std::uint64_t> hashes;
+    for (std::size_t t = 0; t < _terms.size(); ++t) {
+        hashes.clear();
+        variants(_terms[t], maxDistance, &hashes);
+        for (std::uint64_t h : hashes) {
+            pairs.emplace_back(h, std::uint32_t(t));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    _hashes.clear();
+    _offsets.clear();
+    _postings.clear();
+    _postings.reserve(pairs.size());
+    for (const auto &p : pairs) {
+        if (_hashes.empty() || _hashes.back() != p.first) {
+            _hashes.push_back(p.first);
+            _offsets.push_back(std::uint32_t(_postings.size()));
+        }
+        _postings.push_back(p.second);
+    }
+    _offsets.push_back(std::uint32_t(_postings.size()));
+}
+
+std::vector<SpellIndex::Suggestion> SpellIndex::lookup(const std::u16string &input, int maxDistance,
+                                                       int maxResults) const
+{
+    std::vector<Suggestion> result;
+    maxDistance = std::min(maxDistance, _maxDistance);
+    if (input.empty() || maxDistance < 0) {
+        return result;
+    }
+
+    std::vector<std::uint64_t> hashes;
+    variants(input, maxDistance, &hashes);
+
+    std::vector<std::uint32_t> candidates;
+    for (std::uint64_t h : hashes) {
+        auto it = std::lower_bound(_hashes.begin(), _hashes.end(), h);
+        if (it == _hashes.end() || *it != h) {
+            continue;
+        }
+        const std::size_t slot = std::size_t(it - _hashes.begin());
+        candidates.insert(candidates.end(), _postings.begin() + _offsets[slot], _postings.begin() + _offsets[slot + 1]);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // 变体只覆盖前缀，且哈希可能冲突，最终以完整字符串的编辑距离为准
+    for (std::uint32_t term : candidates) {
+        const std::u16string &word = _terms[term];
+        const std::size_t diff = word.size() > input.size() ? word.size() - input.size() : input.size() - word.size();
+        if (diff > std::size_t(maxDistance)) {
+            continue;
+        }
+        const int distance = osaDistance(input, word, maxDistance);
+        if (distance <= maxDistance) {
+            result.push_back({int(term), distance});
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [this](const Suggestion &a, const Suggestion &b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return _weights[a.term] > _weights[b.term];
+    });
+    if (int(result.size()) > maxResults) {
+        result.resize(std::size_t(std::max(0, maxResults)));
+    }
+    return result;
+}
+
+int osaDistance(const std::u16string &a, const std::u16string &b, int bound)
+{
+    const int n = int(a.size());
+    const int m = int(b.size());
+    if (std::abs(n - m) > bound) {
+        return bound + 1;
+    }
+
+    // 三行滚动数组：上上行用于相邻交换
+    std::vector<int> prev2(std::size_t(m) + 1), prev(std::size_t(m) + 1), cur(std::size_t(m) + 1);
+    for (int j = 0; j <= m; ++j) prev[std::size_t(j)] = j;
+
+    for (int i = 1; i <= n; ++i) {
+        cur[0] = i;
+        int rowMin = cur[0];
+        for (int j = 1; j <= m; ++j) {
+            const int cost = a[std::size_t(i - 1)] == b[std::size_t(j - 1)] ? 0 : 1;
+            int d = std::min({prev[std::size_t(j)] + 1, cur[std::size_t(j - 1)] + 1, prev[std::size_t(j - 1)] + cost});
+            if (i > 1 && j > 1 && a[std::size_t(i - 1)] == b[std::size_t(j - 2)] && a[std::size_t(i - 2)] == b[std::size_t(j - 1)]) {
+                d = std::min(d, prev2[std::size_t(j - 2)] + 1);
+            }
+            cur[std::size_t(j)] = d;
+            rowMin = std::min(rowMin, d);
+        }
+        if (rowMin > bound) {
+            return bound + 1;
+        }
+        std::swap(prev2, prev);
+        std::swap(prev, cur);
+    }
+    return std::min(prev[std::size_t(m)], bound + 1);
+}
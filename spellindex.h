@@ -0,0 +1,53 @@
+#ifndef SPELLINDEX_H
+#define SPELLINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 对称删除（SymSpell）拼写纠错索引
+// 建索引时为每个词条生成删除最多 maxDistance 个字符后的所有变体；查询时对输入做同样的删除，
+// 只有变体相同的词条才计算真实编辑距离（OSA，相邻交换算一次编辑）。
+// 变体只取词条前 PrefixLength 个字符生成，内存与词条数成正比。
+// 字符串按 UTF-16 编码单元处理，调用方负责先做归一化。
+class SpellIndex
+{
+public:
+    static const int PrefixLength = 7;
+
+    struct Suggestion {
+        int term;                       // build 时的词条下标
+        int distance;
+    };
+
+    SpellIndex();
+
+    void build(const std::vector<std::u16string> &terms, const std::vector<std::uint32_t> &weights,
+               int maxDistance = 2);
+
+    // 返回编辑距离不超过 maxDistance 的词条，按距离升序、权重降序，最多 maxResults 个
+    std::vector<Suggestion> lookup(const std::u16string &input, int maxDistance, int maxResults) const;
+
+    // 按输入长度给出合理的最大编辑距离：太短的词允许 2 处错误会匹配到无关词条
+    static int maxDistanceFor(std::size_t length);
+
+    int termCount() const { return int(_terms.size()); }
+    std::size_t variantCount() const { return _hashes.size(); }
+
+private:
+    std::vector<std::u16string> _terms;
+    std::vector<std::uint32_t> _weights;
+    int _maxDistance;
+
+    // 变体哈希（升序、去重）-> _postings 中 [_offsets[i], _offsets[i + 1]) 的词条下标
+    std::vector<std::uint64_t> _hashes;
+    std::vector<std::uint32_t> _offsets;
+    std::vector<std::uint32_t> _postings;
+
+    static void variants(const std::u16string &word, int maxDistance, std::vector<std::uint64_t> *out);
+};
+
+// 受限的 Damerau-Levenshtein（OSA）距离，超过 bound 时返回 bound + 1
+int osaDistance(const std::u16string &a, const std::u16string &b, int bound);
+
+#endif // SPELLINDEX_H
@@ -0,0 +1,194 @@
+#include "stallwatchdog.h"
+#include "tracer.h"
+#include "metrics.h"
+#include "logger.h"
+#include "config.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+const int HeartbeatMs = 50;
+const char *const UnknownOperation = "（未标注的操作）";
+
+}
+
+StallWatchdog::StallWatchdog(QObject *parent)
+    : QObject(parent)
+    , _stack(Tracer::watchCurrentThread())
+    , _lastBeat(Tracer::now())
+    , _thresholdNs(std::int64_t(thresholdMs()) * 1000000)
+    , _intervalNs(std::int64_t(qMin(HeartbeatMs, thresholdMs())) * 1000000)
+    , _path(reportPath())
+    , _stop(false)
+{
+    _heartbeat.setTimerType(Qt::PreciseTimer);
+    _heartbeat.setInterval(int(_intervalNs / 1000000));
+    connect(&_heartbeat, &QTimer::timeout, this, &StallWatchdog::onHeartbeat);
+    _heartbeat.start();
+
+    _thread = std::thread([this]() { run(); });
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+int StallWatchdog::thresholdMs()
+{
+    bool ok = false;
+    const int ms = qEnvironmentVariableIntValue(STALL_MS_ENV, &ok);
+    return ok && ms > 0 ? ms : UI_STALL_MS;
+}
+
+QString StallWatchdog::reportPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/" + STALL_REPORT_FILE;
+}
+
+void StallWatchdog::onHeartbeat()
+{
+    static Metrics::Histogram &lag = Metrics::histogram("ui.loop_lag");
+
+    // 超出定时间隔的部分即事件循环被占用的时间
+    const std::int64_t now = Tracer::now();
+    const std::int64_t previous = _lastBeat.exchange(now, std::memory_order_release);
+    lag.record(qMax<std::int64_t>(0, now - previous - _intervalNs) / 1000);
+}
+
+void StallWatchdog::run()
+{
+    // 每个阈值周期采样 4 次，阻塞期间各作用域的采样次数近似其占用的时间
+    const auto period = std::chrono::nanoseconds(qMax<std::int64_t>(_thresholdNs / 4, 5000000));
+
+    bool stalled = false;
+    std::int64_t stalledBeat = 0;
+    QHash<QString, int> samples;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_wake.wait_for(lock, period, [this]() { return _stop; })) {
+        lock.unlock();
+        const std::int64_t beat = _lastBeat.load(std::memory_order_acquire);
+
+        if (stalled && beat != stalledBeat) {
+            // 心跳恢复：两次心跳的间隔减去定时间隔即卡顿时长
+            QString operation;
+            int count = 0;
+            for (auto it = samples.constBegin(); it != samples.constEnd(); ++it) {
+                if (it.value() > count) {
+                    operation = it.key();
+                    count = it.value();
+                }
+            }
+            const qint64 durationMs = qMax<std::int64_t>(0, beat - stalledBeat - _intervalNs) / 1000000;
+            report(durationMs, operation, count);
+            stalled = false;
+            samples.clear();
+        }
+
+        // 正常情况下两次心跳相隔一个定时间隔，超出部分达到阈值才算卡顿
+        if (Tracer::now() - beat > _intervalNs + _thresholdNs) {
+            if (!stalled) {
+                stalled = true;
+                stalledBeat = beat;
+            }
+            const QStringList stack = _stack->names();
+            samples[stack.isEmpty() ? QString(UnknownOperation) : stack.join(" > ")]++;
+        }
+        lock.lock();
+    }
+}
+
+void StallWatchdog::report(qint64 durationMs, const QString &operation, int samples)
+{
+    static Metrics::Counter &stalls = Metrics::counter("ui.stalls");
+    stalls.add();
+    LOG_WARNING() << "界面线程阻塞" << durationMs << "ms，期间主要在" << operation;
+
+    QJsonObject entry;
+    entry["time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    entry["ms"] = durationMs;
+    entry["operation"] = operation;
+    entry["samples"] = samples;
+
+    // 超过上限时保留一份旧报告，重新开始
+    QFileInfo info(_path);
+    QDir().mkpath(info.absolutePath());
+    if (info.exists() && info.size() > STALL_REPORT_MAX_BYTES) {
+        QFile::remove(_path + ".1");
+        QFile::rename(_path, _path + ".1");
+    }
+
+    QFile file(_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        LOG_WARNING() << "无法写入卡顿报告" << _path << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n');
+}
+
+QVector<StallWatchdog::Offender> StallWatchdog::offenders(const QString &path)
+{
+    // 报告最大 STALL_REPORT_MAX_BYTES，每次重新解析本身就会造成卡顿
+    static QString cachedPath;
+    static qint64 cachedSize = -1;
+    static QDateTime cachedModified;
+    static QVector<Offender> cached;
+
+    const QFileInfo info(path);
+    const qint64 size = info.exists() ? info.size() : -1;
+    const QDateTime modified = info.lastModified();
+    if (path == cachedPath && size == cachedSize && modified == cachedModified) {
+        return cached;
+    }
+    cachedPath = path;
+    cachedSize = size;
+    cachedModified = modified;
+
+    QVector<Offender> &result = cached;
+    result.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+
+    QHash<QString, int> index;
+    while (!file.atEnd()) {
+        const QJsonObject entry = QJsonDocument::fromJson(file.readLine()).object();
+        if (entry.isEmpty()) continue;
+
+        const QString operation = entry["operation"].toString();
+        const qint64 ms = qint64(entry["ms"].toDouble());
+        auto it = index.find(operation);
+        if (it == index.end()) {
+            it = index.insert(operation, result.size());
+            result.append({operation, 0, 0, 0});
+        }
+        Offender &offender = result[it.value()];
+        offender.count++;
+        offender.totalMs += ms;
+        offender.maxMs = qMax(offender.maxMs, ms);
+    }
+
+    std::sort(result.begin(), result.end(), [](const Offender &a, const Offender &b) {
+        return a.totalMs > b.totalMs;
+    });
+    return result;
+}
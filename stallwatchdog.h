@@ -0,0 +1,64 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Tracer {
+class ActiveStack;
+}
+
+// 界面线程卡顿检测
+// 界面线程上的定时器不断更新心跳时间，后台线程发现心跳超过阈值未更新时即认为事件循环被阻塞，
+// 在阻塞期间反复采样界面线程当前所在的 TRACE_SCOPE，心跳恢复后把卡顿时长和被采样最多的作用域
+// 追加到本地报告文件（每行一个 JSON），并计入 "ui.stalls" 指标。
+// 每次心跳的延迟计入 "ui.loop_lag" 直方图。必须在界面线程上创建。
+class StallWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StallWatchdog(QObject *parent = nullptr);
+    ~StallWatchdog();
+
+    // 报告中按操作汇总的一行
+    struct Offender {
+        QString operation;              // 作用域栈，由外到内以 " > " 连接
+        int count;
+        qint64 totalMs;
+        qint64 maxMs;
+    };
+
+    static int thresholdMs();           // 环境变量 STALL_MS_ENV，未设置时为 UI_STALL_MS
+    static QString reportPath();
+    // 读取报告，按累计卡顿时长降序；文件大小和修改时间不变时返回上次的结果（设置页每秒调用）。只在界面线程调用
+    static QVector<Offender> offenders(const QString &path = reportPath());
+
+private:
+    void onHeartbeat();
+    void run();
+    void report(qint64 durationMs, const QString &operation, int samples);
+
+    QTimer _heartbeat;
+    Tracer::ActiveStack *_stack;
+    std::atomic<std::int64_t> _lastBeat;    // 纳秒，Tracer::now()
+    std::int64_t _thresholdNs;
+    std::int64_t _intervalNs;
+    QString _path;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stop;
+    std::thread _thread;
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,250 @@
+// 由 tools/gen_synonyms.py 根据 data/knowledge_synonyms.txt 生成，请勿手动修改
+#ifndef SYNONYMTABLE_H
+#define SYNONYMTABLE_H
+
+namespace SynonymTable {
+
+struct Canonical {
+    const char *id;
+    const char *name;                   // UTF-8
+};
+
+struct Slot {
+    const char16_t *key;                // 归一化后的写法，空槽为 nullptr
+    int length;
+    int canonical;
+};
+
+const int CanonicalCount = 40;
+const int BucketCount = 68;
+const int SlotCount = 171;
+
+const Canonical Canonicals[CanonicalCount] = {
+    { "advanced_math", u8"\u9ad8\u7b49\u6570\u5b66" },
+    { "linear_algebra", u8"\u7ebf\u6027\u4ee3\u6570" },
+    { "probability", u8"\u6982\u7387\u8bba" },
+    { "data_structures", u8"\u6570\u636e\u7ed3\u6784" },
+    { "c", u8"C\u8bed\u8a00" },
+    { "cpp", u8"C++" },
+    { "algorithms", u8"\u7b97\u6cd5" },
+    { "stl", u8"STL" },
+    { "cpp_templates", u8"\u6a21\u677f" },
+    { "operating_systems", u8"\u64cd\u4f5c\u7cfb\u7edf" },
+    { "html", u8"HTML" },
+    { "css", u8"CSS" },
+    { "javascript", u8"JavaScript" },
+    { "typescript", u8"TypeScript" },
+    { "vue", u8"Vue" },
+    { "computer_networks", u8"\u8ba1\u7b97\u673a\u7f51\u7edc" },
+    { "java", u8"Java" },
+    { "linux", u8"Linux" },
+    { "git", u8"Git" },
+    { "qt", u8"Qt" },
+    { "computer_organization", u8"\u8ba1\u7b97\u673a\u7ec4\u6210\u539f\u7406" },
+    { "postgraduate_english", u8"\u8003\u7814\u82f1\u8bed" },
+    { "pytorch", u8"PyTorch" },
+    { "react", u8"React" },
+    { "nodejs", u8"Node.js" },
+    { "mysql", u8"MySQL" },
+    { "databases", u8"\u6570\u636e\u5e93" },
+    { "spring", u8"Spring" },
+    { "python", u8"Python" },
+    { "numpy", u8"NumPy" },
+    { "pandas", u8"Pandas" },
+    { "machine_learning", u8"\u673a\u5668\u5b66\u4e60" },
+    { "deep_learning", u8"\u6df1\u5ea6\u5b66\u4e60" },
+    { "design_patterns", u8"\u8bbe\u8ba1\u6a21\u5f0f" },
+    { "redis", u8"Redis" },
+    { "llm", u8"\u5927\u6a21\u578b" },
+    { "postgraduate_politics", u8"\u8003\u7814\u653f\u6cbb" },
+    { "csharp", u8"C#" },
+    { "go", u8"Go" },
+    { "rust", u8"Rust" },
+};
+
+const unsigned int Seeds[BucketCount] = {
+    5, 2, 3, 1, 0, 0, 2, 3, 1, 0, 1, 1,
+    0, 2, 2, 0, 0, 1, 5, 2, 1, 2, 1, 2,
+    2, 8, 2, 2, 2, 5, 2, 1, 6, 6, 1, 0,
+    0, 4, 5, 2, 3, 6, 5, 1, 1, 1, 0, 6,
+    15, 2, 1, 0, 1, 1, 11, 3, 9, 10, 5, 3,
+    0, 0, 2, 3, 3, 15, 0, 9,
+};
+
+const Slot Slots[SlotCount] = {
+    { u"\u6cdb\u578b\u7f16\u7a0b", 4, 8 },
+    { u"\u8003\u7814\u653f\u6cbb", 4, 36 },
+    { u"deeplearning", 12, 32 },
+    { u"\u6982\u7387\u7edf\u8ba1", 4, 2 },
+    { nullptr, 0, -1 },
+    { u"operatingsystem", 15, 9 },
+    { u"typescript", 10, 13 },
+    { nullptr, 0, -1 },
+    { u"\u673a\u5668\u5b66\u4e60", 4, 31 },
+    { u"stl", 3, 7 },
+    { nullptr, 0, -1 },
+    { u"\u7b97\u6cd5\u8bbe\u8ba1", 4, 6 },
+    { u"standardtemplatelibrary", 23, 7 },
+    { u"calculus", 8, 0 },
+    { u"\u8003\u7814\u82f1\u8bed\u4e00", 5, 21 },
+    { u"cplusplus", 9, 5 },
+    { u"advancedmathematics", 19, 0 },
+    { u"computerorganization", 20, 20 },
+    { u"go", 2, 38 },
+    { u"csharp", 6, 37 },
+    { u"linux", 5, 17 },
+    { u"\u6df1\u5ea6\u5b66\u4e60", 4, 32 },
+    { u"python", 6, 28 },
+    { nullptr, 0, -1 },
+    { u"numpy", 5, 29 },
+    { nullptr, 0, -1 },
+    { u"nodejs", 6, 24 },
+    { u"dl", 2, 32 },
+    { u"\u8ba1\u7b97\u673a\u7f51\u7edc", 5, 15 },
+    { u"probability", 11, 2 },
+    { u"clanguage", 9, 4 },
+    { u"cxx", 3, 5 },
+    { u"\u5927\u6a21\u578b", 3, 35 },
+    { u"c\u7a0b\u5e8f\u8bbe\u8ba1", 5, 4 },
+    { u"templates", 9, 8 },
+    { u"computernetworks", 16, 15 },
+    { u"\u9ad8\u7b49\u6570\u5b66", 4, 0 },
+    { u"\u6a21\u677f", 2, 8 },
+    { u"ds", 2, 3 },
+    { u"linearalgebra", 13, 1 },
+    { u"css3", 4, 11 },
+    { u"javascript", 10, 12 },
+    { nullptr, 0, -1 },
+    { u"\u6807\u51c6\u6a21\u677f\u5e93", 5, 7 },
+    { u"databases", 9, 26 },
+    { u"ecmascript", 10, 12 },
+    { u"java", 4, 16 },
+    { u"\u8ba1\u7b97\u673a\u7ec4\u6210", 5, 20 },
+    { u"css", 3, 11 },
+    { nullptr, 0, -1 },
+    { u"designpatterns", 14, 33 },
+    { u"clang", 5, 4 },
+    { u"jdk", 3, 16 },
+    { u"datastructures", 14, 3 },
+    { nullptr, 0, -1 },
+    { u"ubuntu", 6, 17 },
+    { u"\u7b97\u6cd5", 2, 6 },
+    { nullptr, 0, -1 },
+    { u"git", 3, 18 },
+    { u"rust", 4, 39 },
+    { nullptr, 0, -1 },
+    { u"algorithms", 10, 6 },
+    { u"react", 5, 23 },
+    { u"\u6570\u636e\u5e93\u539f\u7406", 5, 26 },
+    { u"\u8ba1\u7b97\u673a\u7ec4\u6210\u539f\u7406", 7, 20 },
+    { u"operatingsystems", 16, 9 },
+    { u"\u7248\u672c\u63a7\u5236", 4, 18 },
+    { nullptr, 0, -1 },
+    { u"pytorch", 7, 22 },
+    { nullptr, 0, -1 },
+    { u"\u6982\u7387", 2, 2 },
+    { u"c++", 3, 5 },
+    { u"sql", 3, 26 },
+    { u"\u7ebf\u4ee3", 2, 1 },
+    { u"advancedmath", 12, 0 },
+    { u"chatgpt", 7, 35 },
+    { u"\u8ba1\u7ec4", 2, 20 },
+    { u"\u6570\u636e\u7ed3\u6784\u4e0e\u7b97\u6cd5\u57fa\u7840", 9, 3 },
+    { u"\u795e\u7ecf\u7f51\u7edc", 4, 32 },
+    { u"machinelearning", 15, 31 },
+    { u"qt", 2, 19 },
+    { nullptr, 0, -1 },
+    { u"\u6982\u7387\u8bba", 3, 2 },
+    { u"html", 4, 10 },
+    { u"\u7ebf\u6027\u4ee3\u6570", 4, 1 },
+    { u"c++\u6a21\u677f", 5, 8 },
+    { nullptr, 0, -1 },
+    { u"\u8003\u7814\u82f1\u8bed", 4, 21 },
+    { nullptr, 0, -1 },
+    { u"\u8ba1\u7f51", 2, 15 },
+    { u"postgraduateenglish", 19, 21 },
+    { u"designpattern", 13, 33 },
+    { u"vuejs", 5, 14 },
+    { u"computernetwork", 15, 15 },
+    { nullptr, 0, -1 },
+    { u"algorithm", 9, 6 },
+    { u"postgraduatepolitics", 20, 36 },
+    { u"datastructure", 13, 3 },
+    { u"springboot", 10, 27 },
+    { u"\u7b97\u6cd5\u8bbe\u8ba1\u4e0e\u5206\u6790", 7, 6 },
+    { u"pandas", 6, 30 },
+    { u"\u8bbe\u8ba1\u6a21\u5f0f", 4, 33 },
+    { nullptr, 0, -1 },
+    { u"py", 2, 28 },
+    { u"\u653f\u6cbb", 2, 36 },
+    { u"\u8003\u7814\u82f1\u8bed\u4e8c", 5, 21 },
+    { u"c#", 2, 37 },
+    { nullptr, 0, -1 },
+    { u"c\u52a0\u52a0", 3, 5 },
+    { u"largelanguagemodel", 18, 35 },
+    { nullptr, 0, -1 },
+    { u"ml", 2, 31 },
+    { u"os", 2, 9 },
+    { nullptr, 0, -1 },
+    { u"\u6a21\u677f\u7f16\u7a0b", 4, 8 },
+    { u"cpp", 3, 5 },
+    { u"golang", 6, 38 },
+    { u"\u6570\u636e\u7ed3\u6784", 4, 3 },
+    { u"js", 2, 12 },
+    { u"node", 4, 24 },
+    { nullptr, 0, -1 },
+    { u"tcpip", 5, 15 },
+    { nullptr, 0, -1 },
+    { nullptr, 0, -1 },
+    { u"cpptemplates", 12, 8 },
+    { u"database", 8, 26 },
+    { u"reactjs", 7, 23 },
+    { u"networking", 10, 15 },
+    { u"llm", 3, 35 },
+    { u"\u6570\u636e\u5e93", 3, 26 },
+    { nullptr, 0, -1 },
+    { u"c\u8bed\u8a00", 3, 4 },
+    { nullptr, 0, -1 },
+    { u"\u6982\u7387\u8bba\u4e0e\u6570\u7406\u7edf\u8ba1", 8, 2 },
+    { nullptr, 0, -1 },
+    { u"\u5fae\u79ef\u5206", 3, 0 },
+    { u"\u8bbe\u8ba1\u6a21\u5f0f\u4e4b\u7985", 6, 33 },
+    { u"redis", 5, 34 },
+    { u"\u9ad8\u6570", 2, 0 },
+    { u"np", 2, 29 },
+    { u"\u6570\u636e\u5e93\u7cfb\u7edf", 5, 26 },
+    { u"vue", 3, 14 },
+    { u"qt6", 3, 19 },
+    { nullptr, 0, -1 },
+    { nullptr, 0, -1 },
+    { nullptr, 0, -1 },
+    { u"\u64cd\u4f5c\u7cfb\u7edf", 4, 9 },
+    { u"pd", 2, 30 },
+    { u"pyqt", 4, 19 },
+    { u"spring", 6, 27 },
+    { u"\u673a\u5668\u5b66\u4e60\u57fa\u7840", 6, 31 },
+    { u"c", 1, 4 },
+    { nullptr, 0, -1 },
+    { u"\u7f51\u7edc", 2, 15 },
+    { u"mysql", 5, 25 },
+    { u"qt5", 3, 19 },
+    { u"vue3", 4, 14 },
+    { u"torch", 5, 22 },
+    { nullptr, 0, -1 },
+    { nullptr, 0, -1 },
+    { u"es6", 3, 12 },
+    { nullptr, 0, -1 },
+    { nullptr, 0, -1 },
+    { u"ts", 2, 13 },
+    { u"db", 2, 26 },
+    { u"github", 6, 18 },
+    { u"python3", 7, 28 },
+    { u"gpt", 3, 35 },
+    { nullptr, 0, -1 },
+    { u"html5", 5, 10 },
+    { u"\u5927\u8bed\u8a00\u6a21\u578b", 5, 35 },
+};
+
+}
+
+#endif // SYNONYMTABLE_H
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""由 data/knowledge_taxonomy.tsv 生成 data/knowledge_trie.bin（知识点输入补全用的压缩前缀树）。
+
+用法：python3 tools/build_trie.py [--synthetic N] [输入文件] [输出文件]
+  --synthetic N  在分类之外再生成 N 个合成知识点，用于测试大规模分类下的补全性能
+
+每个知识点以 KnowledgeCanon::normalize 归一化后的名称为键；若名称在同义词表中，
+同义写法也作为键（输入 "cpp" 可以补全出 "C++"）。
+文件格式见 completiontrie.h，所有整数为小端。
+"""
+
+import os
+import random
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from gen_synonyms import ROOT, DEFAULT_INPUT as SYNONYM_FILE, normalize, read_table, utf16_units  # noqa: E402
+
+DEFAULT_INPUT = os.path.join(ROOT, "data", "knowledge_taxonomy.tsv")
+DEFAULT_OUTPUT = os.path.join(ROOT, "data", "knowledge_trie.bin")
+
+MAGIC = b"SLTRIE01"
+TOP_K = 8
+
+
+def read_taxonomy(path):
+    entries = []        # [(name, path, weight)]
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            fields = line.split("\t")
+            if len(fields) != 2:
+                sys.exit("%s:%d: 需要 路径<TAB>权重 两个字段" % (path, lineno))
+            parts = [p.strip() for p in fields[0].split("/") if p.strip()]
+            if not parts:
+                continue
+            entries.append((parts[-1], "/".join(parts[:-1]), int(fields[1])))
+    return entries
+
+
+def synthetic_entries(count):
+    rng = random.Random(count)
+    syllables = ["数", "据", "算", "法", "网", "络", "系", "统", "模", "型", "学", "习", "图", "论",
+                 "编", "译", "原", "理", "分", "布", "式", "安", "全", "测", "试"]
+    entries = []
+    for i in range(count):
+        name = "".join(rng.choice(syllables) for _ in range(rng.randint(2, 6))) + str(i)
+        entries.append((name, "合成/%d" % (i % 100), rng.randint(1, 1000)))
+    return entries
+
+
+class Node:
+    __slots__ = ("children", "entries", "top")
+
+    def __init__(self):
+        self.children = {}      # 首个编码单元 -> [label(list of units), Node]
+        self.entries = []
+        self.top = []
+
+
+def insert(root, key, entry):
+    node = root
+    while key:
+        edge = node.children.get(key[0])
+        if edge is None:
+            child = Node()
+            child.entries.append(entry)
+            node.children[key[0]] = [key, child]
+            return
+        label, child = edge
+        common = 0
+        while common < len(label) and common < len(key) and label[common] == key[common]:
+            common += 1
+        if common < len(label):
+            # 拆分边：label = label[:common] + label[common:]
+            middle = Node()
+            middle.children[label[common]] = [label[common:], child]
+            edge[0] = label[:common]
+            edge[1] = middle
+            child = middle
+        node = child
+        key = key[common:]
+    if entry not in node.entries:
+        node.entries.append(entry)
+
+
+def compute_top(node, entries):
+    # 迭代后序遍历，避免深度很大时递归溢出
+    order = []
+    stack = [node]
+    while stack:
+        n = stack.pop()
+        order.append(n)
+        stack.extend(child for _, child in n.children.values())
+    rank = lambda e: (-entries[e][2], entries[e][0])
+    for n in reversed(order):
+        candidates = set(n.entries)
+        for _, child in n.children.values():
+            candidates.update(child.top)
+        n.top = sorted(candidates, key=rank)[:TOP_K]
+
+
+def serialize(root, entries):
+    # 广度优先编号，兄弟节点相邻
+    index = {}
+    order = [root]
+    i = 0
+    while i < len(order):
+        n = order[i]
+        for key in sorted(n.children):
+            order.append(n.children[key][1])
+        i += 1
+    for i, n in enumerate(order):
+        index[id(n)] = i
+
+    node_data = bytearray()
+    edge_chars = []
+    edge_data = bytearray()
+    tops = []
+    labels = []
+    for n in order:
+        keys = sorted(n.children)
+        node_data += struct.pack("<IIHH", len(edge_chars), len(tops), len(keys), len(n.top))
+        for key in keys:
+            label, child = n.children[key]
+            edge_chars.append(key)
+            edge_data += struct.pack("<III", index[id(child)], len(labels), len(label))
+            labels.extend(label)
+        tops.extend(n.top)
+
+    strings = []
+    entry_data = bytearray()
+    for name, path, weight in entries:
+        name_units = utf16_units(name)
+        path_units = utf16_units(path)
+        entry_data += struct.pack("<IHHII", len(strings), len(name_units), len(path_units),
+                                  len(strings) + len(name_units), weight)
+        strings.extend(name_units)
+        strings.extend(path_units)
+
+    def units(values):
+        data = struct.pack("<%dH" % len(values), *values)
+        return data + b"\0" * (len(data) % 4)
+
+    header = MAGIC + struct.pack("<8I", len(order), len(edge_chars), len(tops), len(entries),
+                                 len(labels), len(strings), TOP_K, 0)
+    sections = [node_data, units(edge_chars), edge_data, struct.pack("<%dI" % len(tops), *tops),
+                entry_data, units(labels), units(strings)]
+    return header + b"".join(bytes(s) for s in sections), len(order)
+
+
+def main():
+    args = sys.argv[1:]
+    synthetic = 0
+    if len(args) >= 2 and args[0] == "--synthetic":
+        synthetic = int(args[1])
+        args = args[2:]
+    source = args[0] if len(args) > 0 else DEFAULT_INPUT
+    output = args[1] if len(args) > 1 else DEFAULT_OUTPUT
+
+    entries = read_taxonomy(source) + synthetic_entries(synthetic)
+
+    # 规范名称 -> 同义写法
+    canonicals, synonym_keys = read_table(SYNONYM_FILE)
+    aliases = {}
+    for key, canonical in synonym_keys.items():
+        aliases.setdefault(normalize(canonicals[canonical][1]), []).append(key)
+
+    root = Node()
+    key_count = 0
+    for i, (name, _, _) in enumerate(entries):
+        key = normalize(name)
+        for k in set([key] + aliases.get(key, [])):
+            if k:
+                insert(root, utf16_units(k), i)
+                key_count += 1
+
+    compute_top(root, entries)
+    data, node_count = serialize(root, entries)
+    with open(output, "wb") as f:
+        f.write(data)
+    print("%d 个知识点，%d 个键，%d 个节点，%d 字节 -> %s" % (len(entries), key_count, node_count, len(data), output))
+
+
+if __name__ == "__main__":
+    main()
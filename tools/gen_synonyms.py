@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""由 data/knowledge_synonyms.txt 生成 synonymtable.h（知识点同义词的完美哈希表）。
+
+用法：python3 tools/gen_synonyms.py [输入文件] [输出文件]
+
+归一化规则必须与 knowledgecanon.cpp 中的 KnowledgeCanon::normalize 一致：
+NFKC -> 大小写折叠 -> 去掉空白和 - _ . · /
+哈希函数必须与 knowledgecanon.cpp 中的 hashKey 一致：按 UTF-16 编码单元做 FNV-1a。
+"""
+
+import os
+import sys
+import unicodedata
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_INPUT = os.path.join(ROOT, "data", "knowledge_synonyms.txt")
+DEFAULT_OUTPUT = os.path.join(ROOT, "synonymtable.h")
+
+STRIPPED = set("-_.·/")
+LOAD_FACTOR = 0.8
+MAX_SEED = 1 << 24
+
+
+def normalize(text):
+    text = unicodedata.normalize("NFKC", text)
+    result = []
+    for ch in text:
+        folded = ch.casefold()
+        if len(folded) != 1:
+            # Qt 的 toCaseFolded 只做一对一的简单折叠，多字符折叠的写法两边结果不一致
+            raise ValueError("不支持的字符 %r（大小写折叠后不是单个字符）" % ch)
+        if folded.isspace() or folded in STRIPPED:
+            continue
+        result.append(folded)
+    return "".join(result)
+
+
+def utf16_units(text):
+    data = text.encode("utf-16-le")
+    return [data[i] | (data[i + 1] << 8) for i in range(0, len(data), 2)]
+
+
+def hash_key(units, seed):
+    h = (2166136261 ^ seed) & 0xFFFFFFFF
+    for u in units:
+        h ^= u & 0xFF
+        h = (h * 16777619) & 0xFFFFFFFF
+        h ^= u >> 8
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def read_table(path):
+    canonicals = []     # [(id, name)]
+    keys = {}           # 归一化写法 -> canonical 下标
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            fields = line.split("\t")
+            if len(fields) != 3:
+                sys.exit("%s:%d: 需要 3 个用 TAB 分隔的字段" % (path, lineno))
+            cid, name, variants = fields
+            if normalize(cid) != cid.replace("_", ""):
+                sys.exit("%s:%d: id 只能由小写字母、数字和下划线组成" % (path, lineno))
+            index = len(canonicals)
+            canonicals.append((cid, name))
+            for variant in [cid, name] + variants.split("|"):
+                key = normalize(variant)
+                if not key:
+                    continue
+                if keys.get(key, index) != index:
+                    other = canonicals[keys[key]][0]
+                    sys.exit("%s:%d: 写法 %r 同时属于 %s 和 %s" % (path, lineno, variant, other, cid))
+                keys[key] = index
+    return canonicals, keys
+
+
+def build_perfect_hash(keys):
+    """hash-and-displace：先按 seed 0 分桶，再为每个桶找一个让桶内所有键落到空槽的 seed。"""
+    items = [(utf16_units(k), k) for k in sorted(keys)]
+    bucket_count = max(1, len(items) // 2)
+    slot_count = max(1, int(len(items) / LOAD_FACTOR) + 1)
+
+    buckets = [[] for _ in range(bucket_count)]
+    for units, key in items:
+        buckets[hash_key(units, 0) % bucket_count].append((units, key))
+
+    seeds = [0] * bucket_count
+    slots = [None] * slot_count
+    for b in sorted(range(bucket_count), key=lambda i: -len(buckets[i])):
+        bucket = buckets[b]
+        if not bucket:
+            continue
+        for seed in range(1, MAX_SEED):
+            positions = [hash_key(units, seed) % slot_count for units, _ in bucket]
+            if len(set(positions)) == len(positions) and all(slots[p] is None for p in positions):
+                break
+        else:
+            sys.exit("找不到可用的 seed，请调低 LOAD_FACTOR")
+        seeds[b] = seed
+        for p, (_, key) in zip(positions, bucket):
+            slots[p] = key
+    return seeds, slots
+
+
+def cpp_string(text):
+    out = []
+    for ch in text:
+        code = ord(ch)
+        if ch in '"\\':
+            out.append("\\" + ch)
+        elif 0x20 <= code < 0x7F:
+            out.append(ch)
+        elif code <= 0xFFFF:
+            out.append("\\u%04x" % code)
+        else:
+            out.append("\\U%08x" % code)
+    return '"' + "".join(out) + '"'
+
+
+def write_header(path, source, canonicals, keys, seeds, slots):
+    lines = [
+        "// 由 tools/gen_synonyms.py 根据 %s 生成，请勿手动修改" % os.path.relpath(source, ROOT).replace(os.sep, "/"),
+        "#ifndef SYNONYMTABLE_H",
+        "#define SYNONYMTABLE_H",
+        "",
+        "namespace SynonymTable {",
+        "",
+        "struct Canonical {",
+        "    const char *id;",
+        "    const char *name;                   // UTF-8",
+        "};",
+        "",
+        "struct Slot {",
+        "    const char16_t *key;                // 归一化后的写法，空槽为 nullptr",
+        "    int length;",
+        "    int canonical;",
+        "};",
+        "",
+        "const int CanonicalCount = %d;" % len(canonicals),
+        "const int BucketCount = %d;" % len(seeds),
+        "const int SlotCount = %d;" % len(slots),
+        "",
+        "const Canonical Canonicals[CanonicalCount] = {",
+    ]
+    for cid, name in canonicals:
+        lines.append("    { %s, u8%s }," % (cpp_string(cid), cpp_string(name)))
+    lines += ["};", "", "const unsigned int Seeds[BucketCount] = {"]
+    for i in range(0, len(seeds), 12):
+        lines.append("    " + " ".join("%d," % s for s in seeds[i:i + 12]))
+    lines += ["};", "", "const Slot Slots[SlotCount] = {"]
+    for key in slots:
+        if key is None:
+            lines.append("    { nullptr, 0, -1 },")
+        else:
+            lines.append("    { u%s, %d, %d }," % (cpp_string(key), len(utf16_units(key)), keys[key]))
+    lines += ["};", "", "}", "", "#endif // SYNONYMTABLE_H", ""]
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    source = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_INPUT
+    output = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_OUTPUT
+    canonicals, keys = read_table(source)
+    seeds, slots = build_perfect_hash(keys)
+    write_header(output, source, canonicals, keys, seeds, slots)
+    print("%d 个知识点，%d 种写法，%d 个槽位 -> %s" % (len(canonicals), len(keys), len(slots), output))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,252 @@
+#include "impairmentproxy.h"
+
+#include <QDebug>
+#include <memory>
+
+namespace {
+
+struct Profile {
+    const char *name;
+    int latencyMs;
+    int jitterMs;
+    int bandwidthKbps;
+    int maxSegment;
+};
+
+const Profile Profiles[] = {
+    {"lan",            1,   0,      0,    0},
+    {"wifi",          15,   5,  20000, 1400},
+    {"congested-wifi", 80, 40,   2000, 1400},
+    {"3g",           150,  50,    750, 1200},
+};
+
+}
+
+QStringList ImpairmentProxy::profileNames()
+{
+    QStringList names;
+    for (const Profile &profile : Profiles) {
+        names << profile.name;
+    }
+    return names;
+}
+
+bool ImpairmentProxy::profile(const QString &name, Options *options)
+{
+    for (const Profile &profile : Profiles) {
+        if (name == profile.name) {
+            options->latencyMs = profile.latencyMs;
+            options->jitterMs = profile.jitterMs;
+            options->bandwidthKbps = profile.bandwidthKbps;
+            options->maxSegment = profile.maxSegment;
+            return true;
+        }
+    }
+    return false;
+}
+
+ImpairmentProxy::ImpairmentProxy(const Options &options, const QString &upstreamHost, quint16 upstreamPort,
+                                 QObject *parent)
+    : QObject(parent)
+    , _options(options)
+    , _upstreamHost(upstreamHost)
+    , _upstreamPort(upstreamPort)
+    , _server(new QTcpServer(this))
+    , _random(options.seed)
+    , _connections(0)
+{
+    connect(_server, &QTcpServer::newConnection, this, &ImpairmentProxy::onNewConnection);
+    _clock.start();
+}
+
+bool ImpairmentProxy::listen(const QHostAddress &address, quint16 port)
+{
+    return _server->listen(address, port);
+}
+
+void ImpairmentProxy::onNewConnection()
+{
+    while (QTcpSocket *client = _server->nextPendingConnection()) {
+        const int id = ++_connections;
+        QTcpSocket *upstream = new QTcpSocket(client);
+        client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        // 两个方向各一个管道；都送完并关闭后释放这对连接（管道和上游 socket 都是 client 的子对象）
+        ProxyPipe *toUpstream = new ProxyPipe(QString("#%1 客户端->服务器").arg(id), client, upstream,
+                                              _options, &_random, &_clock, client);
+        ProxyPipe *toClient = new ProxyPipe(QString("#%1 服务器->客户端").arg(id), upstream, client,
+                                            _options, &_random, &_clock, client);
+        std::shared_ptr<int> open = std::make_shared<int>(2);
+        for (ProxyPipe *pipe : {toUpstream, toClient}) {
+            connect(pipe, &ProxyPipe::drained, client, [client, open]() {
+                if (--*open == 0) client->deleteLater();
+            });
+        }
+        connect(client, &QTcpSocket::disconnected, toUpstream, &ProxyPipe::finish);
+        connect(upstream, &QTcpSocket::disconnected, toClient, &ProxyPipe::finish);
+
+        // 连不上服务器时断开客户端
+        QAbstractSocket::SocketState previous = QAbstractSocket::UnconnectedState;
+        connect(upstream, &QAbstractSocket::stateChanged, client,
+                [this, client, upstream, toClient, previous](QAbstractSocket::SocketState state) mutable {
+                    if (state == QAbstractSocket::ConnectedState) {
+                        upstream->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+                    } else if (state == QAbstractSocket::UnconnectedState
+                               && (previous == QAbstractSocket::HostLookupState
+                                   || previous == QAbstractSocket::ConnectingState)
+                               && client->state() == QAbstractSocket::ConnectedState) {
+                        qWarning().noquote() << QString("无法连接服务器 %1:%2: %3")
+                                                    .arg(_upstreamHost).arg(_upstreamPort).arg(upstream->errorString());
+                        toClient->finish();
+                    }
+                    previous = state;
+                });
+
+        qDebug().noquote() << QString("#%1 客户端已连接 %2:%3").arg(id).arg(client->peerAddress().toString()).arg(client->peerPort());
+        upstream->connectToHost(_upstreamHost, _upstreamPort);
+    }
+}
+
+ProxyPipe::ProxyPipe(const QString &name, QTcpSocket *source, QTcpSocket *destination,
+                     const ImpairmentProxy::Options &options, QRandomGenerator *random,
+                     const QElapsedTimer *clock, QObject *parent)
+    : QObject(parent)
+    , _name(name)
+    , _source(source)
+    , _destination(destination)
+    , _options(options)
+    , _random(random)
+    , _clock(clock)
+    , _pendingSince(0)
+    , _linkFreeMicros(0)
+    , _lastDueMicros(0)
+    , _finishing(false)
+    , _drained(false)
+    , _bytes(0)
+    , _reads(0)
+    , _writes(0)
+    , _maxDelayMicros(0)
+{
+    _coalesceTimer.setSingleShot(true);
+    _coalesceTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_coalesceTimer, &QTimer::timeout, this, &ProxyPipe::onCoalesceTimeout);
+
+    _deliverTimer.setSingleShot(true);
+    _deliverTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_deliverTimer, &QTimer::timeout, this, &ProxyPipe::deliver);
+
+    connect(_source, &QTcpSocket::readyRead, this, &ProxyPipe::onReadyRead);
+}
+
+void ProxyPipe::onReadyRead()
+{
+    const QByteArray data = _source->readAll();
+    if (data.isEmpty()) {
+        return;
+    }
+    _bytes += data.size();
+    _reads++;
+
+    if (_options.coalesceMs > 0) {
+        // 窗口从第一段数据到达时开始，窗口结束时一次写出
+        if (_pending.isEmpty()) {
+            _pendingSince = now();
+            _coalesceTimer.start(_options.coalesceMs);
+        }
+        _pending += data;
+    } else {
+        schedule(data, now());
+    }
+}
+
+void ProxyPipe::onCoalesceTimeout()
+{
+    if (!_pending.isEmpty()) {
+        schedule(_pending, _pendingSince);
+        _pending.clear();
+    }
+}
+
+void ProxyPipe::finish()
+{
+    if (_finishing) {
+        return;
+    }
+    _finishing = true;
+    if (_source->bytesAvailable() > 0) {
+        onReadyRead();
+    }
+    _coalesceTimer.stop();
+    onCoalesceTimeout();
+    closeIfDrained();
+}
+
+void ProxyPipe::schedule(const QByteArray &data, qint64 arrivedMicros)
+{
+    const int segment = _options.maxSegment > 0 ? _options.maxSegment : data.size();
+    for (int offset = 0; offset < data.size(); offset += segment) {
+        const QByteArray piece = data.mid(offset, segment);
+
+        // 先按带宽排队发出，再经过（带抖动的）传播延迟到达；到达顺序不能早于前一段
+        qint64 sent = now();
+        if (_options.bandwidthKbps > 0) {
+            _linkFreeMicros = qMax(_linkFreeMicros, sent) + qint64(piece.size()) * 8000 / _options.bandwidthKbps;
+            sent = _linkFreeMicros;
+        }
+        qint64 delay = qint64(_options.latencyMs) * 1000;
+        if (_options.jitterMs > 0) {
+            delay += qint64(_random->bounded(2 * _options.jitterMs * 1000 + 1)) - qint64(_options.jitterMs) * 1000;
+        }
+        qint64 due = qMax(sent + qMax<qint64>(0, delay), _lastDueMicros);
+        if (_options.maxSegment > 0 && !_queue.isEmpty()) {
+            due = qMax(due, _lastDueMicros + qint64(_options.segmentGapMs) * 1000);
+        }
+        _lastDueMicros = due;
+        _queue.append({due, arrivedMicros, piece});
+    }
+    armTimer();
+}
+
+void ProxyPipe::deliver()
+{
+    const qint64 t = now();
+    while (!_queue.isEmpty() && _queue.first().dueMicros <= t) {
+        const Segment segment = _queue.takeFirst();
+        _destination->write(segment.data);
+        _writes++;
+        _maxDelayMicros = qMax(_maxDelayMicros, t - segment.arrivedMicros);
+
+        // 拆分分段时每次只写一段，让接收方有机会分开读到
+        if (_options.maxSegment > 0) {
+            _destination->flush();
+            break;
+        }
+    }
+    armTimer();
+    closeIfDrained();
+}
+
+void ProxyPipe::armTimer()
+{
+    if (_queue.isEmpty()) {
+        _deliverTimer.stop();
+        return;
+    }
+    const qint64 wait = _queue.first().dueMicros - now();
+    _deliverTimer.start(wait > 0 ? int((wait + 999) / 1000) : 0);
+}
+
+void ProxyPipe::closeIfDrained()
+{
+    if (!_finishing || _drained || !_queue.isEmpty() || !_pending.isEmpty()) {
+        return;
+    }
+    _drained = true;
+    if (_destination->state() != QAbstractSocket::UnconnectedState) {
+        _destination->disconnectFromHost();   // 先写完缓冲区再断开
+    }
+    qDebug().noquote() << QString("%1：%2 字节，读 %3 次，写 %4 次，最大排队延迟 %5 ms")
+                              .arg(_name).arg(_bytes).arg(_reads).arg(_writes)
+                              .arg(_maxDelayMicros / 1000.0, 0, 'f', 1);
+    emit drained();
+}
@@ -0,0 +1,114 @@
+#ifndef IMPAIRMENTPROXY_H
+#define IMPAIRMENTPROXY_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QList>
+#include <QStringList>
+
+// 网络损伤代理
+// 位于客户端和服务器之间，双向转发数据，按选项加入延迟、抖动、带宽限制，
+// 把一次写入拆成多个分段，或把短时间内的多次写入合并成一次，模拟拥塞的无线网络。
+// 转发保持字节顺序（与 TCP 一致），不丢弃数据。
+class ImpairmentProxy : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int latencyMs = 0;              // 单向延迟
+        int jitterMs = 0;               // 每个分段的延迟在 ±jitterMs 内随机浮动
+        int bandwidthKbps = 0;          // 每个方向的带宽上限（千比特/秒），0 表示不限
+        int maxSegment = 0;             // > 0 时把数据拆成不超过该字节数的分段分别送达
+        int segmentGapMs = 1;           // 拆分后相邻分段至少间隔的时间，保证接收方分多次读到
+        int coalesceMs = 0;             // > 0 时把该时间窗口内到达的数据合并成一次写入
+        quint32 seed = 1;               // 抖动的随机种子，相同种子得到相同的延迟序列
+    };
+
+    // 常见网络环境的预设：lan/wifi/congested-wifi/3g
+    static QStringList profileNames();
+    static bool profile(const QString &name, Options *options);
+
+    ImpairmentProxy(const Options &options, const QString &upstreamHost, quint16 upstreamPort,
+                    QObject *parent = nullptr);
+
+    bool listen(const QHostAddress &address, quint16 port);
+    quint16 serverPort() const { return _server->serverPort(); }
+    QString errorString() const { return _server->errorString(); }
+
+private slots:
+    void onNewConnection();
+
+private:
+    Options _options;
+    QString _upstreamHost;
+    quint16 _upstreamPort;
+    QTcpServer *_server;
+    QRandomGenerator _random;
+    QElapsedTimer _clock;
+    int _connections;
+};
+
+// 一个方向的转发：source 读到的数据经过损伤后写入 destination
+class ProxyPipe : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProxyPipe(const QString &name, QTcpSocket *source, QTcpSocket *destination,
+              const ImpairmentProxy::Options &options, QRandomGenerator *random,
+              const QElapsedTimer *clock, QObject *parent);
+
+signals:
+    void drained();
+
+public slots:
+    // 来源断开：送完已收到的数据后关闭目标
+    void finish();
+
+private slots:
+    void onReadyRead();
+    void onCoalesceTimeout();
+    void deliver();
+
+private:
+    struct Segment {
+        qint64 dueMicros;
+        qint64 arrivedMicros;
+        QByteArray data;
+    };
+
+    QString _name;
+    QTcpSocket *_source;
+    QTcpSocket *_destination;
+    ImpairmentProxy::Options _options;
+    QRandomGenerator *_random;
+    const QElapsedTimer *_clock;
+
+    QByteArray _pending;                // 合并窗口内累积的数据
+    qint64 _pendingSince;
+    QTimer _coalesceTimer;
+    QList<Segment> _queue;
+    QTimer _deliverTimer;
+    qint64 _linkFreeMicros;             // 按带宽发送完已排队数据的时间
+    qint64 _lastDueMicros;
+    bool _finishing;
+    bool _drained;
+
+    // 统计
+    qint64 _bytes;
+    int _reads;
+    int _writes;
+    qint64 _maxDelayMicros;
+
+    qint64 now() const { return _clock->nsecsElapsed() / 1000; }
+    void schedule(const QByteArray &data, qint64 arrivedMicros);
+    void armTimer();
+    void closeIfDrained();
+};
+
+#endif // IMPAIRMENTPROXY_H
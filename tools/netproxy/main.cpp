@@ -0,0 +1,85 @@
+#include "impairmentproxy.h"
+#include "config.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("smartlearn-netproxy");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SmartLearn 网络损伤代理");
+    parser.addHelpOption();
+
+    QCommandLineOption listenOption("listen", "监听地址，默认只接受本机连接；0.0.0.0 监听所有网卡", "address", "127.0.0.1");
+    QCommandLineOption portOption("port", "监听端口（客户端连接的端口）", "port", QString::number(PORT));
+    QCommandLineOption upstreamOption("upstream", "转发到的服务器", "host:port", QString("%1:%2").arg(HOSTNAME).arg(PORT + 1));
+    QCommandLineOption profileOption("profile", "网络环境预设：" + ImpairmentProxy::profileNames().join("/") + "，单独给出的选项覆盖预设值", "name");
+    QCommandLineOption latencyOption("latency-ms", "单向延迟", "ms", "0");
+    QCommandLineOption jitterOption("jitter-ms", "延迟的随机浮动范围（±）", "ms", "0");
+    QCommandLineOption bandwidthOption("bandwidth-kbps", "每个方向的带宽上限，0 表示不限", "kbps", "0");
+    QCommandLineOption segmentOption("max-segment", "把数据拆成不超过该字节数的分段，0 表示不拆", "bytes", "0");
+    QCommandLineOption segmentGapOption("segment-gap-ms", "拆分后相邻分段的最小间隔", "ms", "1");
+    QCommandLineOption coalesceOption("coalesce-ms", "合并该时间窗口内到达的数据后一次写出，0 表示不合并", "ms", "0");
+    QCommandLineOption seedOption("seed", "抖动的随机种子", "seed", "1");
+    parser.addOption(listenOption);
+    parser.addOption(portOption);
+    parser.addOption(upstreamOption);
+    parser.addOption(profileOption);
+    parser.addOption(latencyOption);
+    parser.addOption(jitterOption);
+    parser.addOption(bandwidthOption);
+    parser.addOption(segmentOption);
+    parser.addOption(segmentGapOption);
+    parser.addOption(coalesceOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    ImpairmentProxy::Options options;
+    if (parser.isSet(profileOption) && !ImpairmentProxy::profile(parser.value(profileOption), &options)) {
+        qCritical() << "未知的预设:" << parser.value(profileOption);
+        return 2;
+    }
+    auto override = [&parser](const QCommandLineOption &option, int *value) {
+        if (parser.isSet(option)) *value = qMax(0, parser.value(option).toInt());
+    };
+    override(latencyOption, &options.latencyMs);
+    override(jitterOption, &options.jitterMs);
+    override(bandwidthOption, &options.bandwidthKbps);
+    override(segmentOption, &options.maxSegment);
+    override(segmentGapOption, &options.segmentGapMs);
+    override(coalesceOption, &options.coalesceMs);
+    options.seed = parser.value(seedOption).toUInt();
+
+    const QString upstream = parser.value(upstreamOption);
+    const int colon = upstream.lastIndexOf(':');
+    const quint16 upstreamPort = quint16(upstream.mid(colon + 1).toUInt());
+    if (colon <= 0 || upstreamPort == 0) {
+        qCritical() << "无效的上游地址:" << upstream;
+        return 2;
+    }
+
+    const QHostAddress address(parser.value(listenOption));
+    if (address.isNull()) {
+        qCritical() << "无效的监听地址:" << parser.value(listenOption);
+        return 2;
+    }
+
+    ImpairmentProxy proxy(options, upstream.left(colon), upstreamPort);
+    const quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!proxy.listen(address, port)) {
+        qCritical() << "监听失败:" << proxy.errorString();
+        return 1;
+    }
+    qDebug().noquote() << QString("损伤代理已启动：%1 -> %2；延迟 %3±%4 ms，带宽 %5，分段 %6，合并窗口 %7 ms")
+                              .arg(proxy.serverPort()).arg(upstream)
+                              .arg(options.latencyMs).arg(options.jitterMs)
+                              .arg(options.bandwidthKbps > 0 ? QString("%1 kbps").arg(options.bandwidthKbps) : QString("不限"))
+                              .arg(options.maxSegment > 0 ? QString("%1 字节").arg(options.maxSegment) : QString("不拆"))
+                              .arg(options.coalesceMs);
+
+    return app.exec();
+}
@@ -0,0 +1,20 @@
+# 网络损伤代理：在客户端与服务器之间加入延迟、抖动、带宽限制、分段拆分与合并
+# 客户端固定连接 127.0.0.1:8080，因此让服务器（或替身服务器）改用其他端口：
+#   ./smartlearn-standin --port 8081
+#   ./smartlearn-netproxy --upstream 127.0.0.1:8081 --profile congested-wifi
+QT       = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = smartlearn-netproxy
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    impairmentproxy.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../config.h \
+    impairmentproxy.h
@@ -0,0 +1,397 @@
+#include "capture.h"
+#include "jsonframereader.h"
+#include "config.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// 一次交互：客户端发出的一组消息，以及到下一次发送之前收到的全部数据
+struct Exchange {
+    qint64 requestMicros = 0;
+    QList<QByteArray> requests;         // 按 JSON 对象切分后的消息
+    QVector<Capture::Frame> responses;
+    qint64 responseBytes = 0;
+};
+
+QVector<Exchange> buildExchanges(const QVector<Capture::Frame> &frames)
+{
+    QVector<Exchange> exchanges;
+    JsonFrameReader reader;
+    for (const Capture::Frame &frame : frames) {
+        if (frame.direction == Capture::Sent) {
+            if (exchanges.isEmpty() || !exchanges.last().responses.isEmpty()) {
+                exchanges.append(Exchange());
+                exchanges.last().requestMicros = frame.micros;
+            }
+            reader.append(frame.data);
+            QByteArray message;
+            while (reader.next(&message)) {
+                exchanges.last().requests.append(message);
+            }
+        } else {
+            // 第一次发送之前收到的数据（服务器主动推送）单独作为一次没有请求的交互
+            if (exchanges.isEmpty()) {
+                exchanges.append(Exchange());
+                exchanges.last().requestMicros = frame.micros;
+            }
+            exchanges.last().responses.append(frame);
+            exchanges.last().responseBytes += frame.data.size();
+        }
+    }
+    return exchanges;
+}
+
+QString messageType(const QByteArray &message)
+{
+    const QString type = QJsonDocument::fromJson(message).object().value("type").toString();
+    return type.isEmpty() ? QString("?") : type;
+}
+
+QString exchangeType(const Exchange &exchange)
+{
+    return exchange.requests.isEmpty() ? QString("(push)") : messageType(exchange.requests.first());
+}
+
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const int rank = qBound(1, int(qCeil(p / 100.0 * values.size())), values.size());
+    return values[rank - 1];
+}
+
+// 按加速倍数把录制中的时间间隔换算为回放时的等待；speed 为 0 时不等待
+void sleepUntil(const QElapsedTimer &clock, qint64 targetMicros)
+{
+    const qint64 remaining = targetMicros - clock.nsecsElapsed() / 1000;
+    if (remaining > 0) {
+        QThread::usleep(quint64(remaining));
+    }
+}
+
+qint64 scaled(qint64 micros, double speed)
+{
+    return speed > 0 ? qint64(double(micros) / speed) : 0;
+}
+
+int dump(const QVector<Capture::Frame> &frames, qint64 startMsecs)
+{
+    std::printf("录制开始于 %s，共 %d 帧\n",
+                qPrintable(QDateTime::fromMSecsSinceEpoch(startMsecs).toString(Qt::ISODateWithMs)), frames.size());
+    for (const Capture::Frame &frame : frames) {
+        QByteArray preview = frame.data.left(80);
+        preview.replace('\n', ' ');
+        std::printf("%12.3f ms  %s %7d  %s\n", frame.micros / 1000.0,
+                    frame.direction == Capture::Sent ? "->" : "<-", frame.data.size(), preview.constData());
+    }
+    return 0;
+}
+
+struct Result {
+    QString type;
+    double recordedMs = 0.0;            // 录制时请求到最后一个响应字节的时间
+    double replayedMs = 0.0;
+    double firstByteMs = 0.0;
+    qint64 recordedBytes = 0;
+    qint64 bytes = 0;
+    bool timedOut = false;
+};
+
+// 扮演客户端：按录制的间隔发出请求，收齐录制中同样多的字节（或空闲超时）后视为响应结束
+int replayClient(const QVector<Exchange> &exchanges, const QString &host, quint16 port, double speed,
+                 int timeoutMs, int idleMs, QVector<Result> *results)
+{
+    QTcpSocket socket;
+    socket.connectToHost(host, port);
+    if (!socket.waitForConnected(3000)) {
+        qCritical() << "连接失败:" << socket.errorString();
+        return 2;
+    }
+
+    // 客户端的思考时间从上一次响应结束算起，服务器变快或变慢不影响之后请求的间隔
+    QElapsedTimer clock;
+    clock.start();
+    qint64 recordedEnd = exchanges.isEmpty() ? 0 : exchanges.first().requestMicros;
+    qint64 replayedEnd = 0;
+    for (const Exchange &exchange : exchanges) {
+        if (exchange.requests.isEmpty()) {
+            continue;
+        }
+
+        // 上一次响应多出来的数据不计入这一次
+        socket.waitForReadyRead(0);
+        socket.readAll();
+
+        sleepUntil(clock, replayedEnd + scaled(exchange.requestMicros - recordedEnd, speed));
+        const qint64 sentAt = clock.nsecsElapsed();
+        for (const QByteArray &request : exchange.requests) {
+            socket.write(request);
+        }
+        socket.flush();
+
+        Result result;
+        result.type = exchangeType(exchange);
+        result.recordedBytes = exchange.responseBytes;
+        if (!exchange.responses.isEmpty()) {
+            result.recordedMs = (exchange.responses.last().micros - exchange.requestMicros) / 1000.0;
+        }
+
+        qint64 lastByteAt = sentAt;
+        while (result.bytes < exchange.responseBytes) {
+            const int wait = result.bytes == 0 ? timeoutMs : idleMs;
+            if (!socket.waitForReadyRead(wait)) {
+                result.timedOut = result.bytes == 0;
+                break;
+            }
+            const QByteArray data = socket.readAll();
+            lastByteAt = clock.nsecsElapsed();
+            if (result.bytes == 0) {
+                result.firstByteMs = (lastByteAt - sentAt) / 1e6;
+            }
+            result.bytes += data.size();
+        }
+        result.replayedMs = (lastByteAt - sentAt) / 1e6;
+        results->append(result);
+
+        recordedEnd = exchange.responses.isEmpty() ? exchange.requestMicros : exchange.responses.last().micros;
+        replayedEnd = lastByteAt / 1000;
+        if (socket.state() != QAbstractSocket::ConnectedState) {
+            qCritical() << "服务器断开了连接";
+            return 2;
+        }
+    }
+    return 0;
+}
+
+// 读取客户端消息，直到收齐 count 条；客户端断线重连时接受新连接
+bool readRequests(QTcpServer &server, QTcpSocket *&socket, JsonFrameReader &reader, int count,
+                  int timeoutMs, QList<QByteArray> *messages)
+{
+    QByteArray message;
+    while (messages->size() < count) {
+        if (reader.next(&message)) {
+            messages->append(message);
+            continue;
+        }
+        if (socket && socket->state() == QAbstractSocket::ConnectedState) {
+            if (socket->bytesAvailable() > 0 || socket->waitForReadyRead(timeoutMs)) {
+                reader.append(socket->readAll());
+                continue;
+            }
+            if (socket->state() == QAbstractSocket::ConnectedState) {
+                return false;           // 超时
+            }
+        }
+        // 连接已断开，等待客户端重连
+        if (!server.hasPendingConnections() && !server.waitForNewConnection(timeoutMs)) {
+            return false;
+        }
+        delete socket;
+        socket = server.nextPendingConnection();
+        reader.clear();
+    }
+    return true;
+}
+
+// 扮演服务器：收到录制中的请求后，按录制的相对时间回送响应
+int replayServer(const QVector<Exchange> &exchanges, const QHostAddress &address, quint16 port, double speed,
+                 int timeoutMs, int *mismatches)
+{
+    QTcpServer server;
+    if (!server.listen(address, port)) {
+        qCritical() << "监听失败:" << server.errorString();
+        return 2;
+    }
+    std::printf("回放服务器已启动，端口 %d，等待客户端连接\n", server.serverPort());
+    if (!server.waitForNewConnection(-1)) {
+        return 2;
+    }
+    QTcpSocket *socket = server.nextPendingConnection();
+    JsonFrameReader reader;
+
+    QElapsedTimer clock;
+    clock.start();
+    int served = 0;
+    for (const Exchange &exchange : exchanges) {
+        QList<QByteArray> messages;
+        if (!readRequests(server, socket, reader, exchange.requests.size(), timeoutMs, &messages)) {
+            std::printf("等待第 %d 次请求（%s）超时，停止回放\n", served + 1, qPrintable(exchangeType(exchange)));
+            break;
+        }
+        for (int i = 0; i < messages.size(); ++i) {
+            if (messageType(messages[i]) != messageType(exchange.requests[i])) {
+                (*mismatches)++;
+                std::printf("第 %d 次请求的类型不一致：收到 %s，录制为 %s\n", served + 1,
+                            qPrintable(messageType(messages[i])), qPrintable(messageType(exchange.requests[i])));
+            }
+        }
+
+        const qint64 arrived = clock.nsecsElapsed() / 1000;
+        for (const Capture::Frame &frame : exchange.responses) {
+            sleepUntil(clock, arrived + scaled(frame.micros - exchange.requestMicros, speed));
+            socket->write(frame.data);
+            socket->flush();
+        }
+        socket->waitForBytesWritten(timeoutMs);
+        served++;
+    }
+
+    std::printf("已回放 %d/%d 次交互\n", served, exchanges.size());
+    if (socket) {
+        socket->disconnectFromHost();
+        if (socket->state() != QAbstractSocket::UnconnectedState) {
+            socket->waitForDisconnected(1000);
+        }
+        delete socket;
+    }
+    return served == exchanges.size() ? 0 : 1;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("smartlearn-replay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("回放 SmartLearn 客户端的收发录制（设置环境变量 " CAPTURE_FILE_ENV " 录制）");
+    parser.addHelpOption();
+    parser.addPositionalArgument("mode", "client：扮演客户端向服务器重放请求；server：扮演服务器向客户端回送响应；dump：列出录制内容");
+    parser.addPositionalArgument("capture", "录制文件");
+
+    QCommandLineOption hostOption("host", "client 模式连接的服务器", "host", HOSTNAME);
+    QCommandLineOption portOption("port", "client 模式连接的端口或 server 模式监听的端口", "port", QString::number(PORT));
+    QCommandLineOption listenOption("listen", "server 模式的监听地址，默认只接受本机连接；0.0.0.0 监听所有网卡", "address", "127.0.0.1");
+    QCommandLineOption speedOption("speed", "回放速度倍数，0 表示不等待录制中的间隔", "factor", "1");
+    QCommandLineOption timeoutOption("timeout-ms", "等待请求或第一个响应字节的超时", "ms", "5000");
+    QCommandLineOption idleOption("idle-ms", "响应字节少于录制时，空闲多久视为响应结束", "ms", "500");
+    QCommandLineOption jsonOption("json", "client 模式：把每次交互的结果写入 JSON 文件", "path");
+    QCommandLineOption maxRatioOption("max-ratio", "client 模式：回放的 p95 响应耗时超过录制时的该倍数时返回 1", "ratio");
+    parser.addOption(hostOption);
+    parser.addOption(portOption);
+    parser.addOption(listenOption);
+    parser.addOption(speedOption);
+    parser.addOption(timeoutOption);
+    parser.addOption(idleOption);
+    parser.addOption(jsonOption);
+    parser.addOption(maxRatioOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2 || !QStringList({"client", "server", "dump"}).contains(args[0])) {
+        parser.showHelp(2);
+    }
+
+    QVector<Capture::Frame> frames;
+    qint64 startMsecs = 0;
+    QString error;
+    if (!Capture::load(args[1], &frames, &startMsecs, &error)) {
+        qCritical() << error;
+        return 2;
+    }
+    if (args[0] == "dump") {
+        return dump(frames, startMsecs);
+    }
+
+    const QVector<Exchange> exchanges = buildExchanges(frames);
+    const quint16 port = quint16(parser.value(portOption).toUInt());
+    const double speed = qMax(0.0, parser.value(speedOption).toDouble());
+    const int timeoutMs = qMax(1, parser.value(timeoutOption).toInt());
+
+    if (args[0] == "server") {
+        const QHostAddress address(parser.value(listenOption));
+        if (address.isNull()) {
+            qCritical() << "无效的监听地址:" << parser.value(listenOption);
+            return 2;
+        }
+        int mismatches = 0;
+        const int result = replayServer(exchanges, address, port, speed, timeoutMs, &mismatches);
+        return result != 0 ? result : (mismatches ? 1 : 0);
+    }
+
+    QVector<Result> results;
+    const int status = replayClient(exchanges, parser.value(hostOption), port, speed, timeoutMs,
+                                    qMax(1, parser.value(idleOption).toInt()), &results);
+    if (status != 0) {
+        return status;
+    }
+
+    // 输出：每次交互一行（耗时单位 ms），最后是汇总
+    QVector<double> recorded;
+    QVector<double> replayed;
+    int timeouts = 0;
+    QJsonArray rows;
+    std::printf("%4s %-22s %11s %11s %11s %10s %10s\n", "#", "type", "recorded", "replayed", "first_byte", "rec_bytes", "bytes");
+    for (int i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        std::printf("%4d %-22s %11.3f %11.3f %11.3f %10lld %10lld%s\n", i + 1, qPrintable(r.type), r.recordedMs,
+                    r.replayedMs, r.firstByteMs, r.recordedBytes, r.bytes, r.timedOut ? "  超时" : "");
+        if (r.timedOut) {
+            timeouts++;
+        } else {
+            recorded.append(r.recordedMs);
+            replayed.append(r.replayedMs);
+        }
+        QJsonObject row;
+        row["type"] = r.type;
+        row["recorded_ms"] = r.recordedMs;
+        row["replayed_ms"] = r.replayedMs;
+        row["first_byte_ms"] = r.firstByteMs;
+        row["recorded_bytes"] = r.recordedBytes;
+        row["bytes"] = r.bytes;
+        row["timed_out"] = r.timedOut;
+        rows.append(row);
+    }
+    const double recordedP95 = percentile(recorded, 95);
+    const double replayedP95 = percentile(replayed, 95);
+    std::printf("交互 %d 次，超时 %d 次；响应耗时 p50 录制 %.3f ms / 回放 %.3f ms，p95 录制 %.3f ms / 回放 %.3f ms\n",
+                results.size(), timeouts, percentile(recorded, 50), percentile(replayed, 50), recordedP95, replayedP95);
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject report;
+        report["capture"] = args[1];
+        report["speed"] = speed;
+        report["exchanges"] = rows;
+        report["timeouts"] = timeouts;
+        report["recorded_p95_ms"] = recordedP95;
+        report["replayed_p95_ms"] = replayedP95;
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "无法写入" << file.fileName() << file.errorString();
+            return 2;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    // 回归检查：有超时，或 p95 超出录制时的倍数，返回 1
+    if (timeouts > 0) {
+        return 1;
+    }
+    if (parser.isSet(maxRatioOption)) {
+        const double ratio = parser.value(maxRatioOption).toDouble();
+        if (replayedP95 > recordedP95 * ratio) {
+            std::printf("回放 p95 %.3f ms 超过录制 p95 %.3f ms 的 %.2f 倍\n", replayedP95, recordedP95, ratio);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,22 @@
+# 录制回放：把客户端录制的收发数据（SMARTLEARN_CAPTURE）按原速或加速回放
+#   client 模式扮演客户端，向服务器（或替身服务器）重发请求，比较每次请求的响应耗时与录制时的差异
+#   server 模式扮演服务器，等客户端发出录制中的请求后按录制的间隔回送响应
+#   dump   模式列出录制内容
+QT       = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = smartlearn-replay
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../capture.cpp \
+    ../../jsonframereader.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../capture.h \
+    ../../config.h \
+    ../../jsonframereader.h
@@ -0,0 +1,52 @@
+#include "standinserver.h"
+#include "config.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("smartlearn-standin");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SmartLearn 本地替身服务器");
+    parser.addHelpOption();
+
+    QCommandLineOption listenOption("listen", "监听地址，默认只接受本机连接；0.0.0.0 监听所有网卡", "address", "127.0.0.1");
+    QCommandLineOption portOption("port", "监听端口", "port", QString::number(PORT));
+    QCommandLineOption tokenDelayOption("token-delay-ms", "回答片段之间的间隔（毫秒），0 表示尽快发送", "ms", "20");
+    QCommandLineOption answerTokensOption("answer-tokens", "每个回答的片段数", "count", "300");
+    QCommandLineOption firstTokenOption("first-token-ms", "首个片段之前的延迟（毫秒）", "ms", "300");
+    QCommandLineOption pathNodesOption("path-nodes", "返回指定规模的合成学习路径", "count", "0");
+    parser.addOption(listenOption);
+    parser.addOption(portOption);
+    parser.addOption(tokenDelayOption);
+    parser.addOption(answerTokensOption);
+    parser.addOption(firstTokenOption);
+    parser.addOption(pathNodesOption);
+    parser.process(app);
+
+    StandinServer::Options options;
+    options.tokenDelayMs = qMax(0, parser.value(tokenDelayOption).toInt());
+    options.answerTokens = qMax(1, parser.value(answerTokensOption).toInt());
+    options.firstTokenDelayMs = qMax(0, parser.value(firstTokenOption).toInt());
+    options.pathNodes = qMax(0, parser.value(pathNodesOption).toInt());
+
+    const QHostAddress address(parser.value(listenOption));
+    if (address.isNull()) {
+        qCritical() << "无效的监听地址:" << parser.value(listenOption);
+        return 2;
+    }
+
+    StandinServer server(options);
+    quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!server.listen(address, port)) {
+        qCritical() << "监听失败:" << server.errorString();
+        return 1;
+    }
+    qDebug() << "替身服务器已启动，地址" << address.toString() << "端口" << server.serverPort();
+
+    return app.exec();
+}
@@ -0,0 +1,22 @@
+# 本地替身服务器：实现客户端使用的全部消息类型，用于开发、流式对话演示和性能测试
+QT       = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = smartlearn-standin
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../jsonframereader.cpp \
+    ../../knowledgecanon.cpp \
+    main.cpp \
+    standinserver.cpp
+
+HEADERS += \
+    ../../config.h \
+    ../../jsonframereader.h \
+    ../../knowledgecanon.h \
+    ../../synonymtable.h \
+    standinserver.h
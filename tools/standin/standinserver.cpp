@@ -0,0 +1,431 @@
+#include "standinserver.h"
+#include "config.h"
+#include "knowledgecanon.h"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <QDebug>
+
+namespace {
+
+// 没有知识库时推荐的默认学习路线
+const char *const DefaultRoute[] = {
+    "C语言", "数据结构", "算法", "操作系统", "计算机网络", "数据库", "设计模式"
+};
+
+}
+
+StandinServer::StandinServer(const Options &options, QObject *parent)
+    : QObject(parent)
+    , _options(options)
+    , _server(new QTcpServer(this))
+    , _batchResults(nullptr)
+{
+    connect(_server, &QTcpServer::newConnection, this, &StandinServer::onNewConnection);
+
+    _streamTimer.setInterval(qBound(1, _options.tokenDelayMs, 10));
+    connect(&_streamTimer, &QTimer::timeout, this, &StandinServer::onStreamTick);
+    _clock.start();
+}
+
+bool StandinServer::listen(const QHostAddress &address, quint16 port)
+{
+    return _server->listen(address, port);
+}
+
+void StandinServer::onNewConnection()
+{
+    while (QTcpSocket *socket = _server->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        _readers.insert(socket, JsonFrameReader());
+        connect(socket, &QTcpSocket::readyRead, this, &StandinServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &StandinServer::onDisconnected);
+        qDebug() << "客户端已连接:" << socket->peerAddress().toString() << socket->peerPort();
+    }
+}
+
+void StandinServer::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    _readers.remove(socket);
+    for (int i = _streams.size() - 1; i >= 0; --i) {
+        if (_streams[i].socket == socket) _streams.removeAt(i);
+    }
+    socket->deleteLater();
+}
+
+void StandinServer::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    JsonFrameReader &reader = _readers[socket];
+    reader.append(socket->readAll());
+
+    QByteArray frame;
+    while (reader.next(&frame)) {
+        handleFrame(socket, frame);
+    }
+}
+
+void StandinServer::handleFrame(QTcpSocket *socket, const QByteArray &frame)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(frame);
+    if (!doc.isObject()) {
+        qDebug() << "忽略无法解析的消息，长度" << frame.size();
+        return;
+    }
+
+    dispatch(socket, doc.object());
+}
+
+void StandinServer::dispatch(QTcpSocket *socket, const QJsonObject &json)
+{
+    const QString type = json["type"].toString();
+    if (type == LoginType) {
+        handleLogin(socket, json);
+    } else if (type == RegisterType) {
+        handleRegister(socket, json);
+    } else if (type == SaveKnowledgeType) {
+        handleSaveKnowledge(socket, json);
+    } else if (type == GetKnowledgeType) {
+        handleGetKnowledge(socket, json);
+    } else if (type == GetPathType) {
+        handleGetPath(socket, json);
+    } else if (type == ChatType) {
+        handleChat(socket, json);
+    } else if (type == SaveReviewsType) {
+        handleSaveReviews(socket, json);
+    } else if (type == GetReviewsType) {
+        handleGetReviews(socket, json);
+    } else if (type == BatchType) {
+        handleBatch(socket, json);
+    } else {
+        qDebug() << "未知消息类型:" << type;
+    }
+}
+
+void StandinServer::send(QTcpSocket *socket, const QJsonObject &json)
+{
+    if (_batchResults) {
+        _batchResults->append(json);
+        return;
+    }
+    socket->write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+}
+
+void StandinServer::sendText(QTcpSocket *socket, const char *text)
+{
+    if (_batchResults) {
+        _batchResults->append(QString::fromUtf8(text));
+        return;
+    }
+    socket->write(text);
+}
+
+void StandinServer::handleBatch(QTcpSocket *socket, const QJsonObject &json)
+{
+    // 按顺序执行，某条失败后跳过后面的（登录失败时不能再返回该用户的知识库）
+    QJsonArray results;
+    _batchResults = &results;
+    const QJsonArray ops = json["ops"].toArray();
+    for (const QJsonValue &value : ops) {
+        const QJsonObject op = value.toObject();
+        const QString type = op["type"].toString();
+        // 流式回答不是一次回复，批量中不支持
+        if (type == ChatType || type == BatchType) {
+            QJsonObject error;
+            error["status"] = "error";
+            error["message"] = QString("批量请求不支持 %1").arg(type);
+            results.append(error);
+            break;
+        }
+
+        const int before = results.size();
+        dispatch(socket, op);
+        if (results.size() == before) {
+            break;                      // 未知消息，没有回复
+        }
+        const QJsonValue reply = results.last();
+        if (reply.isString() ? reply.toString() != "yes" : reply.toObject()["status"].toString() != "success") {
+            break;
+        }
+    }
+    _batchResults = nullptr;
+
+    QJsonObject reply;
+    reply["type"] = "BatchResponse";
+    reply["results"] = results;
+    send(socket, reply);
+}
+
+void StandinServer::handleLogin(QTcpSocket *socket, const QJsonObject &json)
+{
+    const QString user = json["user"].toString();
+    const QString password = json["password"].toString();
+    if (user.isEmpty()) {
+        sendText(socket, "no");
+        return;
+    }
+
+    auto it = _users.find(user);
+    if (it == _users.end()) {
+        User created;
+        created.password = password;
+        _users.insert(user, created);
+        sendText(socket, "yes");
+    } else {
+        sendText(socket, it->password == password ? "yes" : "no");
+    }
+}
+
+void StandinServer::handleRegister(QTcpSocket *socket, const QJsonObject &json)
+{
+    const QString username = json["username"].toString();
+    QJsonObject reply;
+    reply["type"] = "RegisterResponse";
+    if (_users.contains(username)) {
+        reply["status"] = "error";
+        reply["code"] = USERNAME_EXISTS;
+        reply["message"] = "用户名已存在";
+    } else {
+        User user;
+        user.password = json["password"].toString();
+        _users.insert(username, user);
+        reply["status"] = "success";
+        reply["code"] = REGISTER_SUCCESS;
+        reply["message"] = "注册成功";
+    }
+    send(socket, reply);
+}
+
+void StandinServer::handleSaveKnowledge(QTcpSocket *socket, const QJsonObject &json)
+{
+    User &user = _users[json["username"].toString()];
+    user.learningGoal = json["learning_goal"].toString();
+    user.knowledgePoints.clear();
+    const QJsonArray points = json["knowledge_points"].toArray();
+    for (const QJsonValue &value : points) {
+        user.knowledgePoints.append(value.toString());
+    }
+    // 旧客户端不发送 knowledge_ids，由名称推出
+    user.knowledgeIds.clear();
+    const QJsonArray ids = json["knowledge_ids"].toArray();
+    for (int i = 0; i < user.knowledgePoints.size(); ++i) {
+        const QString id = ids.at(i).toString();
+        user.knowledgeIds.append(id.isEmpty() ? KnowledgeCanon::canonicalId(user.knowledgePoints[i]) : id);
+    }
+
+    QJsonObject reply;
+    reply["type"] = "KnowledgeResponse";
+    reply["status"] = "success";
+    reply["message"] = QString("已保存 %1 个知识点").arg(user.knowledgePoints.size());
+    send(socket, reply);
+}
+
+void StandinServer::handleGetKnowledge(QTcpSocket *socket, const QJsonObject &json)
+{
+    const User user = _users.value(json["username"].toString());
+
+    QJsonObject reply;
+    reply["type"] = "KnowledgeResponse";
+    reply["status"] = "success";
+    reply["learning_goal"] = user.learningGoal;
+    reply["knowledge_points"] = QJsonArray::fromStringList(user.knowledgePoints);
+    reply["knowledge_ids"] = QJsonArray::fromStringList(user.knowledgeIds);
+    send(socket, reply);
+}
+
+void StandinServer::handleSaveReviews(QTcpSocket *socket, const QJsonObject &json)
+{
+    User &user = _users[json["username"].toString()];
+    const QJsonArray cards = json["cards"].toArray();
+    int accepted = 0;
+    for (const QJsonValue &value : cards) {
+        const QJsonArray row = value.toArray();
+        const QString id = row.at(0).toString();
+        if (id.isEmpty()) continue;
+        // 以上次复习时间较新的记录为准
+        auto it = user.reviews.find(id);
+        if (it == user.reviews.end()) {
+            user.reviews.insert(id, row);
+            user.reviewOrder.append(id);
+        } else if (it->at(2).toDouble() <= row.at(2).toDouble()) {
+            *it = row;
+        }
+        accepted++;
+    }
+    for (const QJsonValue &value : json["removed"].toArray()) {
+        const QString id = value.toString();
+        if (user.reviews.remove(id) > 0) {
+            user.reviewOrder.removeOne(id);
+        }
+    }
+
+    QJsonObject reply;
+    reply["type"] = "ReviewResponse";
+    reply["status"] = "success";
+    reply["accepted"] = accepted;
+    send(socket, reply);
+}
+
+void StandinServer::handleGetReviews(QTcpSocket *socket, const QJsonObject &json)
+{
+    const User user = _users.value(json["username"].toString());
+    const int offset = qMax(0, json["offset"].toInt());
+    const int limit = qMax(1, json["limit"].toInt(500));
+
+    QJsonArray cards;
+    for (int i = offset; i < user.reviewOrder.size() && cards.size() < limit; ++i) {
+        cards.append(user.reviews.value(user.reviewOrder[i]));
+    }
+
+    QJsonObject reply;
+    reply["type"] = "ReviewResponse";
+    reply["status"] = "success";
+    reply["cards"] = cards;
+    reply["total"] = user.reviewOrder.size();
+    send(socket, reply);
+}
+
+void StandinServer::handleGetPath(QTcpSocket *socket, const QJsonObject &json)
+{
+    QJsonArray nodes;
+    QJsonArray edges;
+    auto addNode = [&nodes](const QString &name, bool mastered) {
+        QJsonObject node;
+        node["id"] = KnowledgeCanon::canonicalId(name);
+        node["name"] = name;
+        node["mastered"] = mastered;
+        nodes.append(node);
+        return nodes.size() - 1;
+    };
+    auto addEdge = [&edges](int from, int to) {
+        edges.append(QJsonArray{from, to});
+    };
+
+    if (_options.pathNodes > 0) {
+        // 合成的分层路径：每层约 2*sqrt(n) 个节点，每个节点有 1~3 个前置
+        const int n = _options.pathNodes;
+        const int width = qMax(1, int(2 * qSqrt(n)));
+        QRandomGenerator rng(n);
+        for (int i = 0; i < n; ++i) {
+            int layer = i / width;
+            addNode(QString("知识点 %1").arg(i + 1), layer < 2);
+            if (layer == 0) continue;
+            int prevBegin = (layer - 1) * width;
+            int prereqs = 1 + int(rng.bounded(3));
+            for (int p = 0; p < prereqs; ++p) {
+                addEdge(prevBegin + int(rng.bounded(width)), i);
+            }
+        }
+    } else {
+        // 已掌握的知识点指向默认路线中第一个未掌握的知识点
+        const User user = _users.value(json["username"].toString());
+        QList<int> mastered;
+        for (const QString &point : user.knowledgePoints) {
+            mastered.append(addNode(point, true));
+        }
+        int previous = -1;
+        for (const char *topic : DefaultRoute) {
+            QString name = QString::fromUtf8(topic);
+            if (user.knowledgeIds.contains(KnowledgeCanon::canonicalId(name))) continue;
+            int node = addNode(name, false);
+            if (previous < 0) {
+                for (int m : mastered) addEdge(m, node);
+            } else {
+                addEdge(previous, node);
+            }
+            previous = node;
+        }
+    }
+
+    QJsonObject reply;
+    reply["type"] = "PathResponse";
+    reply["status"] = "success";
+    reply["nodes"] = nodes;
+    reply["edges"] = edges;
+    send(socket, reply);
+}
+
+QStringList StandinServer::makeAnswer(const QString &question, const QStringList &knowledgePoints) const
+{
+    // 替身服务器不调用真实模型，按模板生成足够长的回答，用于测试流式渲染
+    QString known = knowledgePoints.isEmpty() ? QString("暂无") : knowledgePoints.join("、");
+    const QStringList sentences = {
+        QString("关于「%1」，").arg(question),
+        QString("结合你已掌握的知识（%1），").arg(known),
+        "建议先巩固基础概念，",
+        "再通过小项目把知识串联起来。",
+        "\n",
+        "1. 每天安排固定的学习时间；",
+        "2. 学完一个知识点后做几道练习题；",
+        "3. 定期回顾错题和笔记。",
+        "\n",
+    };
+
+    QStringList tokens;
+    int sentence = 0;
+    while (tokens.size() < _options.answerTokens) {
+        const QString &text = sentences[sentence++ % sentences.size()];
+        // 每 2 个字符作为一个片段，模拟模型的 token 粒度
+        for (int i = 0; i < text.size() && tokens.size() < _options.answerTokens; i += 2) {
+            tokens.append(text.mid(i, 2));
+        }
+    }
+    return tokens;
+}
+
+void StandinServer::handleChat(QTcpSocket *socket, const QJsonObject &json)
+{
+    QStringList knowledge;
+    const QJsonArray points = json["knowledge_points"].toArray();
+    for (const QJsonValue &value : points) {
+        knowledge.append(value.toString());
+    }
+
+    Stream stream;
+    stream.socket = socket;
+    stream.id = json["id"].toInt();
+    stream.tokens = makeAnswer(json["question"].toString(), knowledge);
+    stream.next = 0;
+    stream.dueMs = _clock.elapsed() + _options.firstTokenDelayMs;
+    _streams.append(stream);
+
+    if (!_streamTimer.isActive()) {
+        _streamTimer.start();
+    }
+}
+
+void StandinServer::onStreamTick()
+{
+    const qint64 now = _clock.elapsed();
+    const int burst = 256;              // tokenDelayMs 为 0 时每次最多发送的片段数
+
+    for (int i = _streams.size() - 1; i >= 0; --i) {
+        Stream &stream = _streams[i];
+        QByteArray out;
+        int sent = 0;
+        while (stream.next < stream.tokens.size() && stream.dueMs <= now && sent < burst) {
+            QJsonObject chunk;
+            chunk["type"] = "ChatChunk";
+            chunk["id"] = stream.id;
+            chunk["delta"] = stream.tokens[stream.next];
+            chunk["done"] = stream.next + 1 == stream.tokens.size();
+            out += QJsonDocument(chunk).toJson(QJsonDocument::Compact);
+            stream.next++;
+            stream.dueMs += _options.tokenDelayMs;
+            sent++;
+        }
+        if (!out.isEmpty()) {
+            stream.socket->write(out);
+        }
+        if (stream.next >= stream.tokens.size()) {
+            _streams.removeAt(i);
+        }
+    }
+
+    if (_streams.isEmpty()) {
+        _streamTimer.stop();
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef STANDINSERVER_H
+#define STANDINSERVER_H
+
+#include "jsonframereader.h"
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonArray>
+
+// 本地替身服务器
+// 数据只保存在内存中；未注册的用户登录时自动创建账号，方便直接测试
+class StandinServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int tokenDelayMs = 20;          // 每个回答片段之间的间隔，0 表示尽快发送
+        int answerTokens = 300;         // 每个回答的片段数
+        int firstTokenDelayMs = 300;    // 模拟模型的首字延迟
+        int pathNodes = 0;              // > 0 时返回该规模的合成学习路径（压力测试用）
+    };
+
+    explicit StandinServer(const Options &options, QObject *parent = nullptr);
+
+    bool listen(const QHostAddress &address, quint16 port);
+    quint16 serverPort() const { return _server->serverPort(); }
+    QString errorString() const { return _server->errorString(); }
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void onStreamTick();
+
+private:
+    struct User {
+        QString password;
+        QString learningGoal;
+        QStringList knowledgePoints;
+        QStringList knowledgeIds;       // 规范 id，与 knowledgePoints 一一对应
+        QHash<QString, QJsonArray> reviews;   // 知识点 id -> 复习记录行
+        QStringList reviewOrder;        // 复习记录的插入顺序，用于分页
+    };
+
+    // 一个正在流式返回的回答
+    struct Stream {
+        QTcpSocket *socket;
+        int id;
+        QStringList tokens;
+        int next;
+        qint64 dueMs;                   // 下一个片段的发送时间
+    };
+
+    Options _options;
+    QTcpServer *_server;
+    QHash<QTcpSocket *, JsonFrameReader> _readers;
+    QHash<QString, User> _users;
+    QList<Stream> _streams;
+    QTimer _streamTimer;
+    QElapsedTimer _clock;
+    QJsonArray *_batchResults;          // 执行批量请求时收集各条回复，不直接写入 socket
+
+    void handleFrame(QTcpSocket *socket, const QByteArray &frame);
+    void dispatch(QTcpSocket *socket, const QJsonObject &json);
+    void handleBatch(QTcpSocket *socket, const QJsonObject &json);
+    void handleLogin(QTcpSocket *socket, const QJsonObject &json);
+    void handleRegister(QTcpSocket *socket, const QJsonObject &json);
+    void handleSaveKnowledge(QTcpSocket *socket, const QJsonObject &json);
+    void handleGetKnowledge(QTcpSocket *socket, const QJsonObject &json);
+    void handleGetPath(QTcpSocket *socket, const QJsonObject &json);
+    void handleChat(QTcpSocket *socket, const QJsonObject &json);
+    void handleSaveReviews(QTcpSocket *socket, const QJsonObject &json);
+    void handleGetReviews(QTcpSocket *socket, const QJsonObject &json);
+
+    void send(QTcpSocket *socket, const QJsonObject &json);
+    void sendText(QTcpSocket *socket, const char *text);
+    QStringList makeAnswer(const QString &question, const QStringList &knowledgePoints) const;
+};
+
+#endif // STANDINSERVER_H
@@ -0,0 +1,191 @@
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char *name;
+    std::int64_t start;
+    std::int64_t end;
+};
+
+// 每个线程一个缓冲区，只有所属线程写入
+// head 是写入的总条数，写完一条后以 release 发布；导出时据此判断哪些记录在读取期间被覆盖
+struct Buffer {
+    int tid;
+    QString threadName;
+    std::atomic<std::uint64_t> head{0};
+    Event events[Tracer::BufferEvents];
+};
+
+// 缓冲区在线程退出后仍保留（线程池的线程随时可能退出），导出时需要它们的记录
+struct Registry {
+    QMutex mutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+thread_local Buffer *currentBuffer = nullptr;
+
+Buffer *threadBuffer()
+{
+    if (currentBuffer) {
+        return currentBuffer;
+    }
+
+    std::unique_ptr<Buffer> buffer(new Buffer);
+    QThread *thread = QThread::currentThread();
+    buffer->threadName = thread ? thread->objectName() : QString();
+    if (buffer->threadName.isEmpty()) {
+        const bool isMain = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+        buffer->threadName = isMain ? QString("main") : QString();
+    }
+
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    buffer->tid = int(r.buffers.size()) + 1;
+    if (buffer->threadName.isEmpty()) {
+        buffer->threadName = QString("thread %1").arg(buffer->tid);
+    }
+    currentBuffer = buffer.get();
+    r.buffers.push_back(std::move(buffer));
+    return currentBuffer;
+}
+
+}
+
+std::atomic<bool> Tracer::detail::enabled{false};
+thread_local Tracer::ActiveStack *Tracer::detail::activeStack = nullptr;
+
+QStringList Tracer::ActiveStack::names() const
+{
+    const int depth = qMin(_depth.load(std::memory_order_acquire), int(Depth));
+    QStringList result;
+    for (int i = 0; i < depth; ++i) {
+        result << QString::fromUtf8(_names[i].load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+Tracer::ActiveStack *Tracer::watchCurrentThread()
+{
+    // 与缓冲区一样在线程退出后仍保留，读取方可能还持有指针
+    static QMutex mutex;
+    static std::vector<std::unique_ptr<ActiveStack>> stacks;
+
+    if (!detail::activeStack) {
+        QMutexLocker locker(&mutex);
+        stacks.emplace_back(new ActiveStack);
+        detail::activeStack = stacks.back().get();
+    }
+    return detail::activeStack;
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::int64_t Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(const char *name, std::int64_t start, std::int64_t end)
+{
+    Buffer *buffer = threadBuffer();
+    const std::uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head % BufferEvents] = {name, start, end};
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool Tracer::writeChromeTrace(const QString &path, QString *error)
+{
+    struct Collected {
+        int tid;
+        Event event;
+    };
+    std::vector<Collected> collected;
+    QJsonArray events;
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    {
+        Registry &r = registry();
+        QMutexLocker locker(&r.mutex);
+        for (const auto &buffer : r.buffers) {
+            const std::uint64_t end = buffer->head.load(std::memory_order_acquire);
+            const std::uint64_t begin = end > std::uint64_t(BufferEvents) ? end - BufferEvents : 0;
+            const std::size_t first = collected.size();
+            for (std::uint64_t i = begin; i < end; ++i) {
+                collected.push_back({buffer->tid, buffer->events[i % BufferEvents]});
+            }
+            // 读取期间所属线程可能继续写入：第 i 条会被第 i + BufferEvents 条覆盖，after 那一条可能正在写
+            const std::uint64_t after = buffer->head.load(std::memory_order_acquire);
+            const std::uint64_t safeFrom = after + 1 > std::uint64_t(BufferEvents) ? after + 1 - BufferEvents : 0;
+            if (safeFrom > begin) {
+                const std::uint64_t overwritten = std::min(safeFrom - begin, end - begin);
+                collected.erase(collected.begin() + std::ptrdiff_t(first),
+                                collected.begin() + std::ptrdiff_t(first + overwritten));
+            }
+
+            QJsonObject meta;
+            meta["name"] = "thread_name";
+            meta["ph"] = "M";
+            meta["pid"] = pid;
+            meta["tid"] = buffer->tid;
+            meta["args"] = QJsonObject{{"name", buffer->threadName}};
+            events.append(meta);
+        }
+    }
+
+    std::int64_t origin = 0;
+    if (!collected.empty()) {
+        origin = std::min_element(collected.begin(), collected.end(), [](const Collected &a, const Collected &b) {
+            return a.event.start < b.event.start;
+        })->event.start;
+    }
+
+    for (const Collected &c : collected) {
+        const char *dot = std::strchr(c.event.name, '.');
+        QJsonObject event;
+        event["name"] = QString::fromUtf8(c.event.name);
+        event["cat"] = dot ? QString::fromUtf8(c.event.name, int(dot - c.event.name)) : QString("scope");
+        event["ph"] = "X";
+        event["ts"] = double(c.event.start - origin) / 1000.0;     // 微秒
+        event["dur"] = double(c.event.end - c.event.start) / 1000.0;
+        event["pid"] = pid;
+        event["tid"] = c.tid;
+        events.append(event);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("无法写入追踪文件 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstdint>
+
+// 热点路径追踪
+// TRACE_SCOPE("名称") 记录所在作用域的起止时间，写入当前线程的环形缓冲区（写满后覆盖最旧的记录），
+// 可导出为 Chrome trace-event JSON，在 chrome://tracing 或 ui.perfetto.dev 中查看。
+// 名称必须是字符串字面量（只保存指针）；"net.wait" 这样带点的名称以点前部分作为分类。
+// 未启用时每个作用域只多一次原子读（被 watchCurrentThread 的线程另外更新作用域栈），可以留在发布版本中；
+// 定义 SMARTLEARN_NO_TRACE 时宏展开为空。
+namespace Tracer {
+
+const int BufferEvents = 16384;         // 每个线程保留的最近记录数
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}
+
+inline bool isEnabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enabled);
+
+std::int64_t now();                     // 单调时钟，纳秒
+void record(const char *name, std::int64_t start, std::int64_t end);
+
+// 导出所有线程的记录；记录仍保留
+bool writeChromeTrace(const QString &path, QString *error = nullptr);
+
+// 线程当前所在的作用域（由外到内），供其他线程读取，例如卡顿检测线程查看界面线程正卡在哪里
+// 只由所属线程修改；读取方可能读到刚退出的名称，名称都是字面量，指针始终有效
+class ActiveStack
+{
+public:
+    static const int Depth = 32;        // 更深的嵌套只计深度，不记名称
+
+    void push(const char *name)
+    {
+        const int depth = _depth.load(std::memory_order_relaxed);
+        if (depth < Depth) {
+            _names[depth].store(name, std::memory_order_relaxed);
+        }
+        _depth.store(depth + 1, std::memory_order_release);
+    }
+
+    void pop()
+    {
+        _depth.store(_depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    }
+
+    QStringList names() const;
+
+private:
+    std::atomic<int> _depth{0};
+    std::atomic<const char *> _names[Depth] = {};
+};
+
+namespace detail {
+extern thread_local ActiveStack *activeStack;
+}
+
+// 让当前线程维护 ActiveStack（不受 setEnabled 影响），返回的对象在程序结束前一直有效
+ActiveStack *watchCurrentThread();
+
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : _name(isEnabled() ? name : nullptr)
+        , _start(_name ? now() : 0)
+        , _active(detail::activeStack)
+    {
+        if (_active) {
+            _active->push(name);
+        }
+    }
+
+    ~Scope()
+    {
+        if (_active) {
+            _active->pop();
+        }
+        if (_name) {
+            record(_name, _start, now());
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(Scope)
+
+    const char *_name;
+    std::int64_t _start;
+    ActiveStack *_active;
+};
+
+}
+
+#ifdef SMARTLEARN_NO_TRACE
+#define TRACE_SCOPE(name)
+#else
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Tracer::Scope TRACE_CONCAT(_traceScope, __LINE__)(name)
+#endif
+
+#endif // TRACER_H